@@ -32,6 +32,7 @@
 #include "sushi/terminal_utilities.h"
 #include "sushi/standalone_factory.h"
 #include "sushi/offline_factory.h"
+#include "sushi/offline_batch.h"
 
 using namespace sushi;
 
@@ -80,6 +81,13 @@ void error_exit(const std::string& message, sushi::Status status)
  */
 std::unique_ptr<Sushi> start_sushi(SushiOptions options);
 
+/**
+ * Renders all files listed in the batch file given in options, and prints a report.
+ * @param options a SushiOptions structure
+ * @return 0 if all files were rendered successfully, 1 otherwise.
+ */
+int render_batch(const SushiOptions& options);
+
 void pipe_signal_handler([[maybe_unused]] int sig)
 {
     ELKLOG_LOG_INFO("Pipe signal received and ignored: {}", sig);
@@ -154,6 +162,11 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (!options.batch_filename.empty() && !options.enable_parameter_dump)
+    {
+        return render_batch(options);
+    }
+
     auto sushi = start_sushi(options);
 
     if (sushi == nullptr)
@@ -244,4 +257,22 @@ std::unique_ptr<Sushi> start_sushi(SushiOptions options)
     }
 
     return nullptr;
+}
+
+int render_batch(const SushiOptions& options)
+{
+    auto jobs = read_offline_batch_file(options.batch_filename);
+    if (!jobs.has_value())
+    {
+        std::cerr << "Failed to read batch file " << options.batch_filename << std::endl;
+        return 1;
+    }
+
+    print_sushi_headline();
+
+    auto report = render_offline_batch(options, jobs.value(), options.batch_jobs);
+    std::cout << report.summary();
+    ELKLOG_LOG_INFO("Batch render finished, {} of {} files failed", report.failed_jobs(), report.results.size());
+
+    return report.failed_jobs() == 0 ? 0 : 1;
 }
\ No newline at end of file
@@ -77,6 +77,10 @@ struct CpuTimings
     float avg;
     float min;
     float max;
+    float p50{0};
+    float p99{0};
+    float p999{0};
+    int   overruns{0};
 };
 
 enum class PluginType
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Rendering of many files with the same configuration in parallel offline instances.
+ * @copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_OFFLINE_BATCH_H
+#define SUSHI_OFFLINE_BATCH_H
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "sushi.h"
+
+namespace sushi {
+
+struct OfflineBatchJob
+{
+    std::string input_filename;
+    std::string output_filename;
+};
+
+struct OfflineBatchJobResult
+{
+    OfflineBatchJob job;
+    Status status{Status::UNINITIALIZED};
+    std::chrono::duration<double> duration{0};
+};
+
+struct OfflineBatchReport
+{
+    std::vector<OfflineBatchJobResult> results;
+    std::chrono::duration<double> duration{0};
+    int parallel_jobs{0};
+
+    /**
+     * @return The number of jobs that did not render successfully.
+     */
+    [[nodiscard]] int failed_jobs() const;
+
+    /**
+     * @return A human readable summary with one line per job and the total timing.
+     */
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * @brief Read a batch file listing one job per line as an input filename optionally followed
+ *        by an output filename, separated by whitespace. Filenames containing spaces can be
+ *        put within double quotes. If the output filename is omitted, it is (input)_proc.wav.
+ *        Empty lines and lines starting with '#' are ignored, empty filenames are an error.
+ * @param filename The path to the batch file.
+ * @return A vector of jobs if successful, nullopt if the file could not be read or is malformed.
+ */
+std::optional<std::vector<OfflineBatchJob>> read_offline_batch_file(const std::string& filename);
+
+/**
+ * @brief Render all jobs with the offline frontend. Every job gets an independent Sushi
+ *        instance created from options, with only the input and output files changed. Up to
+ *        parallel_jobs instances are run at the same time, each on its own thread. Every instance
+ *        loads its plugins and configuration on its own, only plugin libraries already
+ *        loaded in the process are shared between instances. LV2 plugins are loaded into a
+ *        new world for every job. Plugin types that can't be instantiated concurrently are
+ *        instantiated one at a time across all jobs. Network control, timings and telemetry
+ *        are disabled and each instance processes on a single core.
+ * @param options The options used for every instance.
+ * @param jobs The files to render.
+ * @param parallel_jobs The max number of jobs to render concurrently, if 0 or less, the number
+ *        of cpu cores is used.
+ * @return A report with the status and timing of every job.
+ */
+OfflineBatchReport render_offline_batch(const SushiOptions& options,
+                                        const std::vector<OfflineBatchJob>& jobs,
+                                        int parallel_jobs);
+
+} // end namespace sushi
+
+#endif // SUSHI_OFFLINE_BATCH_H
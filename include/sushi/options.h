@@ -136,6 +136,8 @@ enum OptionIndex
     OPT_IDX_USE_OFFLINE,
     OPT_IDX_INPUT_FILE,
     OPT_IDX_OUTPUT_FILE,
+    OPT_IDX_BATCH_FILE,
+    OPT_IDX_BATCH_JOBS,
     OPT_IDX_USE_DUMMY,
     OPT_IDX_USE_PORTAUDIO,
     OPT_IDX_USE_APPLE_COREAUDIO,
@@ -153,7 +155,10 @@ enum OptionIndex
     OPT_IDX_USE_XENOMAI_RASPA,
     OPT_IDX_XENOMAI_DEBUG_MODE_SW,
     OPT_IDX_MULTICORE_PROCESSING,
+    OPT_IDX_MULTICORE_SCHEDULING,
+    OPT_IDX_ASYNC_WORK_THREADS,
     OPT_IDX_TIMINGS_STATISTICS,
+    OPT_IDX_TELEMETRY_FILE,
     OPT_IDX_OSC_RECEIVE_PORT,
     OPT_IDX_OSC_SEND_PORT,
     OPT_IDX_OSC_SEND_IP,
@@ -161,6 +166,7 @@ enum OptionIndex
     OPT_IDX_NO_OSC,
     OPT_IDX_NO_GRPC,
     OPT_IDX_BASE_PLUGIN_PATH,
+    OPT_IDX_PLUGIN_INDEX,
     OPT_IDX_SENTRY_CRASH_HANDLER,
     OPT_IDX_SENTRY_DSN
 };
@@ -265,6 +271,22 @@ const optionparser::Descriptor usage[] =
         SushiArg::NonEmpty,
         "\t\t-O <filename>, --output=<filename> \tSpecify output file [default= (input_file).proc.wav]."
     },
+    {
+        OPT_IDX_BATCH_FILE,
+        OPT_TYPE_UNUSED,
+        "",
+        "batch",
+        SushiArg::NonEmpty,
+        "\t\t--batch=<filename> \tRender all files listed in a batch file with the offline frontend. One file per line, optionally followed by an output file."
+    },
+    {
+        OPT_IDX_BATCH_JOBS,
+        OPT_TYPE_UNUSED,
+        "",
+        "batch-jobs",
+        SushiArg::Numeric,
+        "\t\t--batch-jobs=<n> \tNumber of files rendered in parallel with --batch [default n=number of cpu cores]."
+    },
     {
         OPT_IDX_USE_DUMMY,
         OPT_TYPE_DISABLED,
@@ -401,6 +423,22 @@ const optionparser::Descriptor usage[] =
         SushiArg::Numeric,
         "\t\t-m <n>, --multicore-processing=<n> \tProcess audio multithreaded with n cores [default n=1 (off)]."
     },
+    {
+        OPT_IDX_MULTICORE_SCHEDULING,
+        OPT_TYPE_UNUSED,
+        "",
+        "multicore-scheduling",
+        SushiArg::NonEmpty,
+        "\t\t--multicore-scheduling=<mode> \tHow tracks are distributed between cores with multicore processing, ('round-robin', 'balanced', 'work-stealing') [default=round-robin]."
+    },
+    {
+        OPT_IDX_ASYNC_WORK_THREADS,
+        OPT_TYPE_UNUSED,
+        "",
+        "async-work-threads",
+        SushiArg::Numeric,
+        "\t\t--async-work-threads=<n> \tExecute asynchronous work from plugins, like disk streaming, on a pool of n threads [default n=0 (use the event worker thread)]."
+    },
     {
         OPT_IDX_TIMINGS_STATISTICS,
         OPT_TYPE_DISABLED,
@@ -409,6 +447,14 @@ const optionparser::Descriptor usage[] =
         SushiArg::Optional,
         "\t\t--timing-statistics \tEnable performance timings on all audio processors."
     },
+    {
+        OPT_IDX_TELEMETRY_FILE,
+        OPT_TYPE_UNUSED,
+        "",
+        "telemetry-file",
+        SushiArg::NonEmpty,
+        "\t\t--telemetry-file=<path> \tPublish meter levels, transport position and track timings to a memory mapped file every audio period, preferably in /dev/shm."
+    },
     {
         OPT_IDX_OSC_RECEIVE_PORT,
         OPT_TYPE_UNUSED,
@@ -468,6 +514,14 @@ const optionparser::Descriptor usage[] =
         SushiArg::NonEmpty,
         "\t\t--base-plugin-path=<path> \tSpecify a directory to be the base of plugin paths used in JSON / gRPC."
     },
+    {
+        OPT_IDX_PLUGIN_INDEX,
+        OPT_TYPE_UNUSED,
+        "",
+        "plugin-index",
+        SushiArg::NonEmpty,
+        "\t\t--plugin-index=<path> \tKeep an index of installed plugins in this file, to only load the plugins that are used at startup (LV2 only)."
+    },
     {
         OPT_IDX_SENTRY_CRASH_HANDLER,
         OPT_TYPE_UNUSED,
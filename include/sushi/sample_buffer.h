@@ -24,14 +24,20 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <new>
 
 #include "constants.h"
+#include "sample_buffer_kernels.h"
 
 namespace sushi {
 
 constexpr int LEFT_CHANNEL_INDEX = 0;
 constexpr int RIGHT_CHANNEL_INDEX = 1;
 
+/* Alignment in bytes of the sample data allocated by SampleBuffer, enough for a full
+ * cache line and for aligned loads with any of the vector instruction sets used */
+constexpr size_t SAMPLE_BUFFER_ALIGNMENT = 64;
+
 template<int size>
 class SampleBuffer;
 
@@ -52,7 +58,7 @@ public:
      */
     explicit SampleBuffer(int channel_count) : _channel_count(channel_count),
                                                _own_buffer(true),
-                                               _buffer(new float[static_cast<uint64_t>(size * channel_count)])
+                                               _buffer(_allocate(channel_count))
     {
         clear();
     }
@@ -73,7 +79,7 @@ public:
     {
         if (o._own_buffer)
         {
-            _buffer = new float[size * o._channel_count];
+            _buffer = _allocate(o._channel_count);
             std::copy(o._buffer, o._buffer + (size * o._channel_count), _buffer);
         }
         else
@@ -99,7 +105,7 @@ public:
     {
         if (_own_buffer)
         {
-            delete[] _buffer;
+            _deallocate(_buffer);
         }
     }
 
@@ -114,8 +120,8 @@ public:
             {
                 if (_channel_count != o._channel_count)
                 {
-                    delete[] _buffer;
-                    _buffer = (o._channel_count > 0)? (new float[size * o._channel_count]) : nullptr;
+                    _deallocate(_buffer);
+                    _buffer = (o._channel_count > 0)? _allocate(o._channel_count) : nullptr;
                     _channel_count = o._channel_count;
                 }
             }
@@ -148,7 +154,7 @@ public:
         {
             if (_own_buffer)
             {
-                delete[] _buffer;
+                _deallocate(_buffer);
             }
             _channel_count = o._channel_count;
             _own_buffer = o._own_buffer;
@@ -251,13 +257,7 @@ public:
         {
             case 2:  // Most common case, others are mostly included for future compatibility
             {
-                float* l_in = _buffer;
-                float* r_in = _buffer + size;
-                for (int n = 0; n < size; ++n)
-                {
-                    *l_in++ = *interleaved_buf++;
-                    *r_in++ = *interleaved_buf++;
-                }
+                kernels::deinterleave_stereo(_buffer, _buffer + size, interleaved_buf, size);
                 break;
             }
             case 1:
@@ -271,7 +271,7 @@ public:
                 {
                     for (int c = 0; c < _channel_count; ++c)
                     {
-                        _buffer[n + c * _channel_count] = *interleaved_buf++;
+                        _buffer[n + c * size] = *interleaved_buf++;
                     }
                 }
             }
@@ -287,13 +287,7 @@ public:
         {
             case 2:  // Most common case, others are mostly included for future compatibility
             {
-                float* l_out = _buffer;
-                float* r_out = _buffer + size;
-                for (int n = 0; n < size; ++n)
-                {
-                    *interleaved_buf++ = *l_out++;
-                    *interleaved_buf++ = *r_out++;
-                }
+                kernels::interleave_stereo(interleaved_buf, _buffer, _buffer + size, size);
                 break;
             }
             case 1:
@@ -319,10 +313,7 @@ public:
      */
     void apply_gain(float gain)
     {
-        for (int i = 0; i < size * _channel_count; ++i)
-        {
-            _buffer[i] *= gain;
-        }
+        kernels::apply_gain(_buffer, gain, size * _channel_count);
     }
 
     /**
@@ -330,11 +321,7 @@ public:
     */
     void apply_gain(float gain, int channel)
     {
-        float* data = _buffer + size * channel;
-        for (int i = 0; i < size; ++i)
-        {
-            data[i] *= gain;
-        }
+        kernels::apply_gain(_buffer + size * channel, gain, size);
     }
 
     /**
@@ -383,18 +370,11 @@ public:
         {
             for (int channel = 0; channel < _channel_count; ++channel)
             {
-                float* dest = _buffer + size * channel;
-                for (int i = 0; i < size; ++i)
-                {
-                    dest[i] += source._buffer[i];
-                }
+                kernels::add(_buffer + size * channel, source._buffer, size);
             }
         } else if (source.channel_count() == _channel_count)
         {
-            for (int i = 0; i < size * _channel_count; ++i)
-            {
-                _buffer[i] += source._buffer[i];
-            }
+            kernels::add(_buffer, source._buffer, size * _channel_count);
         }
     }
 
@@ -404,12 +384,7 @@ public:
      */
     void add(int dest_channel, int source_channel, const SampleBuffer& source)
     {
-        float* source_data = source._buffer + size * source_channel;
-        float* dest_data = _buffer + size * dest_channel;
-        for (int i = 0; i < size; ++i)
-        {
-            dest_data[i] += source_data[i];
-        }
+        kernels::add(_buffer + size * dest_channel, source._buffer + size * source_channel, size);
     }
 
     /**
@@ -426,18 +401,11 @@ public:
         {
             for (int channel = 0; channel < _channel_count; ++channel)
             {
-                float* dest = _buffer + size * channel;
-                for (int i = 0; i < size; ++i)
-                {
-                    dest[i] += source._buffer[i] * gain;
-                }
+                kernels::add_with_gain(_buffer + size * channel, source._buffer, gain, size);
             }
         } else if (source.channel_count() == _channel_count)
         {
-            for (int i = 0; i < size * _channel_count; ++i)
-            {
-                _buffer[i] += source._buffer[i] * gain;
-            }
+            kernels::add_with_gain(_buffer, source._buffer, gain, size * _channel_count);
         }
     }
 
@@ -446,12 +414,7 @@ public:
      */
     void add_with_gain(int dest_channel, int source_channel, const SampleBuffer& source, float gain)
     {
-        float* source_data = source._buffer + size * source_channel;
-        float* dest_data = _buffer + size * dest_channel;
-        for (int i = 0; i < size; ++i)
-        {
-            dest_data[i] += source_data[i] * gain;
-        }
+        kernels::add_with_gain(_buffer + size * dest_channel, source._buffer + size * source_channel, gain, size);
     }
 
     /**
@@ -472,22 +435,13 @@ public:
         {
             for (int channel = 0; channel < _channel_count; ++channel)
             {
-                float* dest = _buffer + size * channel;
-                for (int i = 0; i < size; ++i)
-                {
-                    dest[i] += source._buffer[i] * (start + i * inc);
-                }
+                kernels::add_with_ramp(_buffer + size * channel, source._buffer, start, inc, size);
             }
         } else if (source.channel_count() == _channel_count)
         {
             for (int channel = 0; channel < _channel_count; ++channel)
             {
-                float* source_data = _buffer + size * channel;
-                float* dest_data = _buffer + size * channel;
-                for (int i = 0; i < size; ++i)
-                {
-                    dest_data[i] += source_data[i] * (start + i * inc);
-                }
+                kernels::add_with_ramp(_buffer + size * channel, source._buffer + size * channel, start, inc, size);
             }
         }
     }
@@ -499,12 +453,7 @@ public:
     void add_with_ramp(int dest_channel, int source_channel, const SampleBuffer& source, float start, float end)
     {
         float inc = (end - start) / (size - 1);
-        float* source_data = source._buffer + size * source_channel;
-        float* dest_data = _buffer + size * dest_channel;
-        for (int i = 0; i < size; ++i)
-        {
-            dest_data[i] += source_data[i] * (start + i * inc);
-        }
+        kernels::add_with_ramp(_buffer + size * dest_channel, source._buffer + size * source_channel, start, inc, size);
     }
 
     /**
@@ -517,11 +466,7 @@ public:
         float inc = (end - start) / (size - 1);
         for (int channel = 0; channel < _channel_count; ++channel)
         {
-            float* data = _buffer + size * channel;
-            for (int i = 0; i < size; ++i)
-            {
-                data[i] *= start + static_cast<float>(i) * inc;
-            }
+            kernels::apply_ramp(_buffer + size * channel, start, inc, size);
         }
     }
 
@@ -549,15 +494,7 @@ public:
     int count_clipped_samples(int channel) const
     {
         assert(channel < _channel_count);
-        int clip_count = 0;
-        const float* data = _buffer + size * channel;
-        for (int i = 0 ; i < size; ++i)
-        {
-            /* std::abs() is more efficient than testing for upper and lower bound separately
-               And GCC can compile this to vectorised, branchless code */
-            clip_count += std::abs(data[i]) >= 1.0f;
-        }
-        return clip_count;
+        return kernels::count_clipped_samples(_buffer + size * channel, size);
     }
 
     /**
@@ -568,13 +505,7 @@ public:
     float calc_peak_value(int channel) const
     {
         assert(channel < _channel_count);
-        float max = 0.0f;
-        const float* data = _buffer + size * channel;
-        for (int i = 0 ; i < size; ++i)
-        {
-            max = std::max(max, std::abs(data[i]));
-        }
-        return max;
+        return kernels::peak_value(_buffer + size * channel, size);
     }
 
     /**
@@ -585,17 +516,21 @@ public:
     float calc_rms_value(int channel) const
     {
         assert(channel < _channel_count);
-        float sum = 0.0f;
-        const float* data = _buffer + size * channel;
-        for (int i = 0 ; i < size; ++i)
-        {
-            float s = data[i];
-            sum += s * s;
-        }
-        return std::sqrt(sum / AUDIO_CHUNK_SIZE);
+        float sum = kernels::sum_of_squares(_buffer + size * channel, size);
+        return std::sqrt(sum / size);
     }
 
 private:
+    static float* _allocate(int channel_count)
+    {
+        return new (std::align_val_t(SAMPLE_BUFFER_ALIGNMENT)) float[static_cast<uint64_t>(size * channel_count)];
+    }
+
+    static void _deallocate(float* buffer)
+    {
+        ::operator delete[](buffer, std::align_val_t(SAMPLE_BUFFER_ALIGNMENT));
+    }
+
     int _channel_count;
     bool _own_buffer;
     float* _buffer;
@@ -0,0 +1,405 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Vectorised inner loops used by SampleBuffer.
+ *
+ *        The instruction set is selected at compile time from the target flags: AVX if
+ *        enabled, otherwise SSE2 on x86 and NEON on ARM, with a plain scalar fallback for
+ *        any other target or if SUSHI_DISABLE_SIMD_KERNELS is defined. All kernels take
+ *        unaligned pointers and an arbitrary sample count, the remainder not filling a
+ *        full vector is processed with scalar code.
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_SAMPLE_BUFFER_KERNELS_H
+#define SUSHI_SAMPLE_BUFFER_KERNELS_H
+
+#include <algorithm>
+#include <cmath>
+
+#if !defined(SUSHI_DISABLE_SIMD_KERNELS)
+    #if defined(__AVX__)
+        #include <immintrin.h>
+        #define SUSHI_SIMD_KERNELS_AVX
+        #define SUSHI_SIMD_KERNELS_SSE
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <emmintrin.h>
+        #define SUSHI_SIMD_KERNELS_SSE
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #include <arm_neon.h>
+        #define SUSHI_SIMD_KERNELS_NEON
+    #endif
+#endif
+
+namespace sushi::kernels {
+
+namespace detail {
+
+#if defined(SUSHI_SIMD_KERNELS_SSE)
+struct SseOps
+{
+    using Vector = __m128;
+    static constexpr int WIDTH = 4;
+
+    static Vector load(const float* data) {return _mm_loadu_ps(data);}
+    static void store(float* data, Vector v) {_mm_storeu_ps(data, v);}
+    static Vector set(float value) {return _mm_set1_ps(value);}
+    static Vector index() {return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);}
+    static Vector add(Vector a, Vector b) {return _mm_add_ps(a, b);}
+    static Vector mul(Vector a, Vector b) {return _mm_mul_ps(a, b);}
+    static Vector max(Vector a, Vector b) {return _mm_max_ps(a, b);}
+    static Vector abs(Vector a) {return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);}
+    // 1.0f in every lane where a >= b, 0.0f otherwise
+    static Vector greater_equal_count(Vector a, Vector b) {return _mm_and_ps(_mm_cmpge_ps(a, b), _mm_set1_ps(1.0f));}
+};
+#endif
+
+#if defined(SUSHI_SIMD_KERNELS_AVX)
+struct AvxOps
+{
+    using Vector = __m256;
+    static constexpr int WIDTH = 8;
+
+    static Vector load(const float* data) {return _mm256_loadu_ps(data);}
+    static void store(float* data, Vector v) {_mm256_storeu_ps(data, v);}
+    static Vector set(float value) {return _mm256_set1_ps(value);}
+    static Vector index() {return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);}
+    static Vector add(Vector a, Vector b) {return _mm256_add_ps(a, b);}
+    static Vector mul(Vector a, Vector b) {return _mm256_mul_ps(a, b);}
+    static Vector max(Vector a, Vector b) {return _mm256_max_ps(a, b);}
+    static Vector abs(Vector a) {return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);}
+    static Vector greater_equal_count(Vector a, Vector b) {return _mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ), _mm256_set1_ps(1.0f));}
+};
+using VectorOps = AvxOps;
+#elif defined(SUSHI_SIMD_KERNELS_SSE)
+using VectorOps = SseOps;
+#endif
+
+#if defined(SUSHI_SIMD_KERNELS_NEON)
+struct NeonOps
+{
+    using Vector = float32x4_t;
+    static constexpr int WIDTH = 4;
+
+    static Vector load(const float* data) {return vld1q_f32(data);}
+    static void store(float* data, Vector v) {vst1q_f32(data, v);}
+    static Vector set(float value) {return vdupq_n_f32(value);}
+    static Vector index()
+    {
+        constexpr float INDEX[WIDTH] = {0.0f, 1.0f, 2.0f, 3.0f};
+        return vld1q_f32(INDEX);
+    }
+    static Vector add(Vector a, Vector b) {return vaddq_f32(a, b);}
+    static Vector mul(Vector a, Vector b) {return vmulq_f32(a, b);}
+    static Vector max(Vector a, Vector b) {return vmaxq_f32(a, b);}
+    static Vector abs(Vector a) {return vabsq_f32(a);}
+    static Vector greater_equal_count(Vector a, Vector b)
+    {
+        return vreinterpretq_f32_u32(vandq_u32(vcgeq_f32(a, b), vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+    }
+};
+using VectorOps = NeonOps;
+#endif
+
+#if defined(SUSHI_SIMD_KERNELS_SSE) || defined(SUSHI_SIMD_KERNELS_NEON)
+#define SUSHI_SIMD_KERNELS_VECTORISED
+
+template <class Ops>
+inline float horizontal_sum(typename Ops::Vector v)
+{
+    float lanes[Ops::WIDTH];
+    Ops::store(lanes, v);
+    float sum = 0.0f;
+    for (auto lane : lanes)
+    {
+        sum += lane;
+    }
+    return sum;
+}
+
+template <class Ops>
+inline float horizontal_max(typename Ops::Vector v)
+{
+    float lanes[Ops::WIDTH];
+    Ops::store(lanes, v);
+    float max = lanes[0];
+    for (auto lane : lanes)
+    {
+        max = std::max(max, lane);
+    }
+    return max;
+}
+
+/* The gain ramps are calculated as start + i * inc for every sample, rather than
+ * accumulated, so that the results match the scalar versions. */
+template <class Ops>
+inline int ramp_vectorised(float* data, float start, float inc, int samples)
+{
+    auto v_start = Ops::set(start);
+    auto v_inc = Ops::set(inc);
+    auto v_step = Ops::set(static_cast<float>(Ops::WIDTH));
+    auto v_index = Ops::index();
+    int i = 0;
+    for (; i + Ops::WIDTH <= samples; i += Ops::WIDTH)
+    {
+        auto gain = Ops::add(v_start, Ops::mul(v_index, v_inc));
+        Ops::store(data + i, Ops::mul(Ops::load(data + i), gain));
+        v_index = Ops::add(v_index, v_step);
+    }
+    return i;
+}
+
+template <class Ops>
+inline int add_with_ramp_vectorised(float* dest, const float* source, float start, float inc, int samples)
+{
+    auto v_start = Ops::set(start);
+    auto v_inc = Ops::set(inc);
+    auto v_step = Ops::set(static_cast<float>(Ops::WIDTH));
+    auto v_index = Ops::index();
+    int i = 0;
+    for (; i + Ops::WIDTH <= samples; i += Ops::WIDTH)
+    {
+        auto gain = Ops::add(v_start, Ops::mul(v_index, v_inc));
+        Ops::store(dest + i, Ops::add(Ops::load(dest + i), Ops::mul(Ops::load(source + i), gain)));
+        v_index = Ops::add(v_index, v_step);
+    }
+    return i;
+}
+#endif
+
+} // end namespace detail
+
+/**
+ * @brief Multiply samples by a fixed gain, in place.
+ */
+inline void apply_gain(float* data, float gain, int samples)
+{
+    int i = 0;
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+    using Ops = detail::VectorOps;
+    auto v_gain = Ops::set(gain);
+    for (; i + Ops::WIDTH <= samples; i += Ops::WIDTH)
+    {
+        Ops::store(data + i, Ops::mul(Ops::load(data + i), v_gain));
+    }
+#endif
+    for (; i < samples; ++i)
+    {
+        data[i] *= gain;
+    }
+}
+
+/**
+ * @brief Sum the samples of source into dest.
+ */
+inline void add(float* dest, const float* source, int samples)
+{
+    int i = 0;
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+    using Ops = detail::VectorOps;
+    for (; i + Ops::WIDTH <= samples; i += Ops::WIDTH)
+    {
+        Ops::store(dest + i, Ops::add(Ops::load(dest + i), Ops::load(source + i)));
+    }
+#endif
+    for (; i < samples; ++i)
+    {
+        dest[i] += source[i];
+    }
+}
+
+/**
+ * @brief Sum the samples of source into dest after applying a fixed gain.
+ */
+inline void add_with_gain(float* dest, const float* source, float gain, int samples)
+{
+    int i = 0;
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+    using Ops = detail::VectorOps;
+    auto v_gain = Ops::set(gain);
+    for (; i + Ops::WIDTH <= samples; i += Ops::WIDTH)
+    {
+        Ops::store(dest + i, Ops::add(Ops::load(dest + i), Ops::mul(Ops::load(source + i), v_gain)));
+    }
+#endif
+    for (; i < samples; ++i)
+    {
+        dest[i] += source[i] * gain;
+    }
+}
+
+/**
+ * @brief Sum the samples of source into dest after applying a linear gain ramp,
+ *        sample i is scaled by start + i * inc.
+ */
+inline void add_with_ramp(float* dest, const float* source, float start, float inc, int samples)
+{
+    int i = 0;
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+    i = detail::add_with_ramp_vectorised<detail::VectorOps>(dest, source, start, inc, samples);
+#endif
+    for (; i < samples; ++i)
+    {
+        dest[i] += source[i] * (start + static_cast<float>(i) * inc);
+    }
+}
+
+/**
+ * @brief Apply a linear gain ramp in place, sample i is scaled by start + i * inc.
+ */
+inline void apply_ramp(float* data, float start, float inc, int samples)
+{
+    int i = 0;
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+    i = detail::ramp_vectorised<detail::VectorOps>(data, start, inc, samples);
+#endif
+    for (; i < samples; ++i)
+    {
+        data[i] *= start + static_cast<float>(i) * inc;
+    }
+}
+
+/**
+ * @brief Count the number of samples whose absolute value is >= 1.0
+ */
+inline int count_clipped_samples(const float* data, int samples)
+{
+    int i = 0;
+    int clip_count = 0;
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+    using Ops = detail::VectorOps;
+    auto v_limit = Ops::set(1.0f);
+    auto v_count = Ops::set(0.0f);
+    for (; i + Ops::WIDTH <= samples; i += Ops::WIDTH)
+    {
+        v_count = Ops::add(v_count, Ops::greater_equal_count(Ops::abs(Ops::load(data + i)), v_limit));
+    }
+    clip_count = static_cast<int>(detail::horizontal_sum<Ops>(v_count));
+#endif
+    for (; i < samples; ++i)
+    {
+        clip_count += std::abs(data[i]) >= 1.0f;
+    }
+    return clip_count;
+}
+
+/**
+ * @brief Return the largest absolute sample value, or 0 if samples is 0
+ */
+inline float peak_value(const float* data, int samples)
+{
+    int i = 0;
+    float max = 0.0f;
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+    using Ops = detail::VectorOps;
+    auto v_max = Ops::set(0.0f);
+    for (; i + Ops::WIDTH <= samples; i += Ops::WIDTH)
+    {
+        v_max = Ops::max(v_max, Ops::abs(Ops::load(data + i)));
+    }
+    max = detail::horizontal_max<Ops>(v_max);
+#endif
+    for (; i < samples; ++i)
+    {
+        max = std::max(max, std::abs(data[i]));
+    }
+    return max;
+}
+
+/**
+ * @brief Return the sum of all squared sample values
+ */
+inline float sum_of_squares(const float* data, int samples)
+{
+    int i = 0;
+    float sum = 0.0f;
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+    using Ops = detail::VectorOps;
+    auto v_sum = Ops::set(0.0f);
+    for (; i + Ops::WIDTH <= samples; i += Ops::WIDTH)
+    {
+        auto v = Ops::load(data + i);
+        v_sum = Ops::add(v_sum, Ops::mul(v, v));
+    }
+    sum = detail::horizontal_sum<Ops>(v_sum);
+#endif
+    for (; i < samples; ++i)
+    {
+        sum += data[i] * data[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Interleave 2 channels of samples into interleaved, which must hold 2 * samples values
+ */
+inline void interleave_stereo(float* interleaved, const float* left, const float* right, int samples)
+{
+    int i = 0;
+#if defined(SUSHI_SIMD_KERNELS_SSE)
+    for (; i + 4 <= samples; i += 4)
+    {
+        auto l = _mm_loadu_ps(left + i);
+        auto r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(interleaved + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(interleaved + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+#elif defined(SUSHI_SIMD_KERNELS_NEON)
+    for (; i + 4 <= samples; i += 4)
+    {
+        float32x4x2_t lr = {{vld1q_f32(left + i), vld1q_f32(right + i)}};
+        vst2q_f32(interleaved + 2 * i, lr);
+    }
+#endif
+    for (; i < samples; ++i)
+    {
+        interleaved[2 * i] = left[i];
+        interleaved[2 * i + 1] = right[i];
+    }
+}
+
+/**
+ * @brief Split 2 channel interleaved samples into left and right, the inverse of interleave_stereo()
+ */
+inline void deinterleave_stereo(float* left, float* right, const float* interleaved, int samples)
+{
+    int i = 0;
+#if defined(SUSHI_SIMD_KERNELS_SSE)
+    for (; i + 4 <= samples; i += 4)
+    {
+        auto a = _mm_loadu_ps(interleaved + 2 * i);
+        auto b = _mm_loadu_ps(interleaved + 2 * i + 4);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#elif defined(SUSHI_SIMD_KERNELS_NEON)
+    for (; i + 4 <= samples; i += 4)
+    {
+        auto lr = vld2q_f32(interleaved + 2 * i);
+        vst1q_f32(left + i, lr.val[0]);
+        vst1q_f32(right + i, lr.val[1]);
+    }
+#endif
+    for (; i < samples; ++i)
+    {
+        left[i] = interleaved[2 * i];
+        right[i] = interleaved[2 * i + 1];
+    }
+}
+
+} // end namespace sushi::kernels
+
+#endif // SUSHI_SAMPLE_BUFFER_KERNELS_H
@@ -61,6 +61,16 @@ enum class FrontendType
     NONE
 };
 
+/**
+ * How audio tracks are distributed between cpu cores when processing multi-threaded.
+ */
+enum class MulticoreScheduling
+{
+    ROUND_ROBIN,
+    LOAD_BALANCED,
+    WORK_STEALING
+};
+
 enum class ConfigurationSource : int
 {
     NONE = 0,
@@ -122,6 +132,13 @@ struct SushiOptions
      */
     std::string base_plugin_path = std::filesystem::current_path().string();
 
+    /**
+     * If set, an index of installed plugins is kept in this file and used to only load
+     * the plugins that are needed at startup, instead of scanning all of them.
+     * Currently only used for LV2 plugins.
+     */
+    std::string plugin_index_file;
+
     /**
      * Set this to choose how Sushi will be configured:
      * By a json-config file path (ConfigurationSource::FILE),
@@ -257,6 +274,14 @@ struct SushiOptions
     std::string input_filename;
     std::string output_filename;
 
+    /**
+     * If set, the files listed in this batch file are rendered with the offline frontend,
+     * see read_offline_batch_file(), using batch_jobs parallel Sushi instances. If batch_jobs
+     * is 0 or less, one instance per cpu core is used.
+     */
+    std::string batch_filename;
+    int batch_jobs = 0;
+
     /**
      * Break to debugger if a mode switch is detected (Xenomai only).
      */
@@ -267,11 +292,32 @@ struct SushiOptions
      */
     int  rt_cpu_cores = 1;
 
+    /**
+     * How tracks are distributed between cores when rt_cpu_cores > 1. With LOAD_BALANCED, tracks
+     * are periodically redistributed based on their measured cpu load. WORK_STEALING additionally
+     * lets idle cores pick up unprocessed tracks from other cores during a period.
+     */
+    MulticoreScheduling multicore_scheduling = MulticoreScheduling::ROUND_ROBIN;
+
+    /**
+     * If > 0, asynchronous work requested by plugins is executed on a dedicated pool with
+     * this many threads, with work from different plugins running in parallel. Otherwise
+     * it is executed on the single event worker thread.
+     */
+    int async_work_threads = 0;
+
     /**
      * Enable performance timings on all audio processors.
      */
     bool enable_timings = false;
 
+    /**
+     * If set, meter levels, clip counts, transport position and track timings are written
+     * to this file every audio period, for other processes to map and read directly.
+     * See sushi/telemetry.h for the layout.
+     */
+    std::string telemetry_file;
+
     /**
      * Enable flushing the log periodically and specify the interval.
      */
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Layout of the memory mapped telemetry file, for use by external readers
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_TELEMETRY_H
+#define SUSHI_TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace sushi {
+
+constexpr uint32_t TELEMETRY_MAGIC = 0x53555348; // "SUSH"
+constexpr uint32_t TELEMETRY_VERSION = 1;
+constexpr int TELEMETRY_MAX_CHANNELS = 64;
+constexpr int TELEMETRY_MAX_NODES = 128;
+
+struct TelemetryChannel
+{
+    float    peak;       // Highest absolute sample value during the last period
+    uint32_t clip_count; // Number of periods with clipped samples since start
+};
+
+struct TelemetryNode
+{
+    uint32_t id;   // Id of the track
+    float    load; // Recent peak render time as a fraction of the period
+};
+
+/**
+ * @brief The contents of the telemetry file, rewritten by the engine at the end of every
+ *        audio period. The data is protected by a sequence lock, use read_telemetry() to
+ *        get a consistent copy of it.
+ */
+struct TelemetryData
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sequence; // Odd while the engine is writing
+    uint32_t input_channels;
+    uint32_t output_channels;
+    uint32_t node_count;
+    uint64_t period;       // Periods processed since start
+    int64_t  timestamp;    // Process time of the period in microseconds
+    int64_t  sample_count; // Process time of the period in samples
+    double   beats;
+    double   bar_beats;
+    float    tempo;
+    uint32_t playing_mode; // A sushi::PlayingMode value
+    float    engine_load;  // Engine process time as a fraction of the period
+    uint32_t reserved;
+    TelemetryChannel inputs[TELEMETRY_MAX_CHANNELS];
+    TelemetryChannel outputs[TELEMETRY_MAX_CHANNELS];
+    TelemetryNode    nodes[TELEMETRY_MAX_NODES];
+};
+
+/**
+ * @brief Copy the data published by the engine, without blocking it
+ * @param shared The mapped telemetry data
+ * @param copy Filled with a consistent copy of shared if successful
+ * @param max_retries How many times to retry if the engine wrote during the copy
+ * @return true if a consistent copy was made, false otherwise
+ */
+inline bool read_telemetry(const TelemetryData& shared, TelemetryData& copy, int max_retries = 100)
+{
+    std::atomic_ref<uint32_t> sequence(const_cast<uint32_t&>(shared.sequence));
+    for (int i = 0; i <= max_retries; ++i)
+    {
+        auto before = sequence.load(std::memory_order_acquire);
+        if (before & 1u)
+        {
+            continue;
+        }
+        std::memcpy(&copy, &shared, sizeof(TelemetryData));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before)
+        {
+            return copy.magic == TELEMETRY_MAGIC && copy.version == TELEMETRY_VERSION;
+        }
+    }
+    return false;
+}
+
+} // end namespace sushi
+
+#endif // SUSHI_TELEMETRY_H
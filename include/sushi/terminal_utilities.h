@@ -21,6 +21,7 @@
 #ifndef SUSHI_TERMINAL_UTILITIES_H
 #define SUSHI_TERMINAL_UTILITIES_H
 
+#include <stdexcept>
 #include <vector>
 
 #include "sushi.h"
@@ -130,6 +131,15 @@ static ParseStatus parse_options(int argc, char* argv[], sushi::SushiOptions& op
                     options.output_filename.assign(opt.arg);
                     break;
 
+                case OPT_IDX_BATCH_FILE:
+                    options.frontend_type = FrontendType::OFFLINE;
+                    options.batch_filename.assign(opt.arg);
+                    break;
+
+                case OPT_IDX_BATCH_JOBS:
+                    options.batch_jobs = std::stoi(opt.arg);
+                    break;
+
                 case OPT_IDX_USE_DUMMY:
                     options.frontend_type = FrontendType::DUMMY;
                     break;
@@ -198,10 +208,37 @@ static ParseStatus parse_options(int argc, char* argv[], sushi::SushiOptions& op
                     options.rt_cpu_cores = std::stoi(opt.arg);
                     break;
 
+                case OPT_IDX_MULTICORE_SCHEDULING:
+                    if (std::string(opt.arg) == "round-robin")
+                    {
+                        options.multicore_scheduling = MulticoreScheduling::ROUND_ROBIN;
+                    }
+                    else if (std::string(opt.arg) == "balanced")
+                    {
+                        options.multicore_scheduling = MulticoreScheduling::LOAD_BALANCED;
+                    }
+                    else if (std::string(opt.arg) == "work-stealing")
+                    {
+                        options.multicore_scheduling = MulticoreScheduling::WORK_STEALING;
+                    }
+                    else
+                    {
+                        throw std::invalid_argument("Unknown multicore scheduling mode");
+                    }
+                    break;
+
+                case OPT_IDX_ASYNC_WORK_THREADS:
+                    options.async_work_threads = std::stoi(opt.arg);
+                    break;
+
                 case OPT_IDX_TIMINGS_STATISTICS:
                     options.enable_timings = true;
                     break;
 
+                case OPT_IDX_TELEMETRY_FILE:
+                    options.telemetry_file = std::string(opt.arg);
+                    break;
+
                 case OPT_IDX_OSC_RECEIVE_PORT:
                     options.osc_server_port = std::stoi(opt.arg);
                     break;
@@ -230,6 +267,10 @@ static ParseStatus parse_options(int argc, char* argv[], sushi::SushiOptions& op
                     options.base_plugin_path = std::string(opt.arg);
                     break;
 
+                case OPT_IDX_PLUGIN_INDEX:
+                    options.plugin_index_file = std::string(opt.arg);
+                    break;
+
                 case OPT_IDX_SENTRY_CRASH_HANDLER:
                     options.sentry_crash_handler_path = opt.arg;
                     break;
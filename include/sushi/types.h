@@ -27,6 +27,8 @@
 
 namespace sushi {
 
+namespace internal::engine {class DeferredReclaimer;}
+
 /**
  * @brief General struct for passing opaque binary data in events or parameters/properties
  */
@@ -69,6 +71,11 @@ class RtDeletable
 {
 public:
     virtual ~RtDeletable();
+
+private:
+    friend internal::engine::DeferredReclaimer;
+    // Links objects waiting for deletion without needing to allocate memory
+    RtDeletable* _next_retired{nullptr};
 };
 
 /**
@@ -18,8 +18,12 @@
  * @Copyright 2017-2023 Elk Audio AB, Stockholm
  */
 
+#include <algorithm>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <mutex>
 #include <random>
 
 #include "elklog/static_logger.h"
@@ -40,6 +44,41 @@ constexpr float INPUT_NOISE_LEVEL = powf(10, (-24.0f/20.0f));
 
 constexpr int   NOISE_SEED = 5; // Using a constant seed makes potential errors reproducible
 
+constexpr int   BLOCK_SIZE = OFFLINE_FRONTEND_BLOCK_CHUNKS * AUDIO_CHUNK_SIZE;
+
+/* A block of interleaved audio handed between the reader, processing and writer threads.
+ * A block with 0 frames marks the end of the file. */
+struct FileBlock
+{
+    std::vector<float> data;
+    int frames{0};
+};
+
+class BlockQueue
+{
+public:
+    void push(FileBlock* block)
+    {
+        std::scoped_lock lock(_mutex);
+        _blocks.push_back(block);
+        _notifier.notify_one();
+    }
+
+    FileBlock* pop()
+    {
+        std::unique_lock lock(_mutex);
+        _notifier.wait(lock, [&] {return !_blocks.empty();});
+        auto block = _blocks.front();
+        _blocks.pop_front();
+        return block;
+    }
+
+private:
+    std::deque<FileBlock*>  _blocks;
+    std::mutex              _mutex;
+    std::condition_variable _notifier;
+};
+
 template<class random_device, class random_dist>
 void fill_buffer_with_noise(ChunkSampleBuffer& buffer, random_device& dev, random_dist& dist)
 {
@@ -86,7 +125,7 @@ AudioFrontendStatus OfflineFrontend::init(BaseAudioFrontendConfiguration* config
             ELKLOG_LOG_ERROR("Unable to open input file {}", off_config->input_filename);
             return AudioFrontendStatus::INVALID_INPUT_FILE;
         }
-        _mono = _soundfile_info.channels == 1;
+        _file_channels = _soundfile_info.channels;
         auto sample_rate_file = _soundfile_info.samplerate;
 
         ELKLOG_LOG_WARNING_IF(sample_rate_file != _engine->sample_rate(),
@@ -105,7 +144,12 @@ AudioFrontendStatus OfflineFrontend::init(BaseAudioFrontendConfiguration* config
             ELKLOG_LOG_ERROR("Unable to open output file {}", off_config->output_filename);
             return AudioFrontendStatus::INVALID_OUTPUT_FILE;
         }
-        _engine->set_audio_channels(OFFLINE_FRONTEND_CHANNELS, OFFLINE_FRONTEND_CHANNELS);
+        int engine_channels = std::max(_file_channels, OFFLINE_FRONTEND_MIN_CHANNELS);
+        if (engine_channels > _buffer.channel_count())
+        {
+            _buffer = ChunkSampleBuffer(engine_channels);
+        }
+        _engine->set_audio_channels(engine_channels, engine_channels);
     }
     else
     {
@@ -228,59 +272,102 @@ void OfflineFrontend::_process_dummy()
 
 void OfflineFrontend::_run_blocking()
 {
+    /* File reading and writing is done in separate threads, in large blocks, so that the
+     * processing thread only ever waits for file io when the disk can't keep up. */
+    std::vector<FileBlock> blocks(OFFLINE_FRONTEND_BLOCK_COUNT);
+    BlockQueue free_blocks;
+    BlockQueue read_blocks;
+    BlockQueue processed_blocks;
+    for (auto& block : blocks)
+    {
+        block.data.resize(static_cast<size_t>(BLOCK_SIZE * _file_channels));
+        free_blocks.push(&block);
+    }
+
+    auto wall_clock_start = std::chrono::steady_clock::now();
+
+    std::thread reader([&]()
+    {
+        while (true)
+        {
+            auto block = free_blocks.pop();
+            block->frames = static_cast<int>(sf_readf_float(_input_file, block->data.data(), BLOCK_SIZE));
+            // Zero the remainder so that the last, partial, chunk isn't processed with stale data
+            std::fill(block->data.begin() + block->frames * _file_channels, block->data.end(), 0.0f);
+            read_blocks.push(block);
+            if (block->frames == 0)
+            {
+                break;
+            }
+        }
+    });
+
+    std::thread writer([&]()
+    {
+        while (true)
+        {
+            auto block = processed_blocks.pop();
+            if (block->frames == 0)
+            {
+                break;
+            }
+            // Should we check the number of samples effectively written?
+            // Not done in libsndfile's example
+            sf_writef_float(_output_file, block->data.data(), static_cast<sf_count_t>(block->frames));
+            free_blocks.push(block);
+        }
+    });
+
     set_flush_denormals_to_zero();
     int samplecount = 0;
     double usec_time = 0.0f;
     Time start_time = std::chrono::microseconds(0);
 
-    float file_buffer[OFFLINE_FRONTEND_CHANNELS * AUDIO_CHUNK_SIZE];
-
-    ELK_PUSH_WARNING
-    ELK_DISABLE_ASSIGNMENT_WITHIN_CONDITIONAL
-
-    while (int readcount = static_cast<int>(sf_readf_float(_input_file,
-                                                         file_buffer,
-                                                         static_cast<sf_count_t>(AUDIO_CHUNK_SIZE))))
+    while (true)
     {
-        auto process_time = start_time + std::chrono::microseconds(static_cast<uint64_t>(usec_time));
+        auto block = read_blocks.pop();
+        for (int offset = 0; offset < block->frames; offset += AUDIO_CHUNK_SIZE)
+        {
+            int framecount = std::min(AUDIO_CHUNK_SIZE, block->frames - offset);
+            float* file_buffer = block->data.data() + offset * _file_channels;
+            auto process_time = start_time + std::chrono::microseconds(static_cast<uint64_t>(usec_time));
 
-        samplecount += readcount;
-        usec_time += readcount * 1'000'000.f / _engine->sample_rate();
+            samplecount += framecount;
+            usec_time += framecount * 1'000'000.f / _engine->sample_rate();
 
-        Time chunk_end_time = start_time + std::chrono::microseconds(static_cast<uint64_t>(usec_time));
-        _process_events(chunk_end_time);
+            Time chunk_end_time = start_time + std::chrono::microseconds(static_cast<uint64_t>(usec_time));
+            _process_events(chunk_end_time);
 
-        _buffer.clear();
-
-        if (_mono)
-        {
-            std::copy(file_buffer, file_buffer + AUDIO_CHUNK_SIZE, _buffer.channel(0));
-        }
-        else
-        {
-            auto buffer = ChunkSampleBuffer::create_non_owning_buffer(_buffer, 0, 2);
+            _buffer.clear();
+            auto buffer = ChunkSampleBuffer::create_non_owning_buffer(_buffer, 0, _file_channels);
             buffer.from_interleaved(file_buffer);
-        }
-        /* Gate and CV are ignored when using file frontend */
-        _engine->process_chunk(&_buffer, &_buffer, &_control_buffer, &_control_buffer, process_time, samplecount);
 
-        if (_mono)
-        {
-            std::copy(_buffer.channel(0), _buffer.channel(0) + AUDIO_CHUNK_SIZE, file_buffer );
+            /* Gate and CV are ignored when using file frontend */
+            _engine->process_chunk(&_buffer, &_buffer, &_control_buffer, &_control_buffer, process_time, samplecount);
+
+            buffer.to_interleaved(file_buffer);
         }
-        else
+        processed_blocks.push(block);
+        if (block->frames == 0)
         {
-            auto buffer = ChunkSampleBuffer::create_non_owning_buffer(_buffer, 0, 2);
-            buffer.to_interleaved(file_buffer);
+            break;
         }
-
-        // Write to file
-        // Should we check the number of samples effectively written?
-        // Not done in libsndfile's example
-        sf_writef_float(_output_file, file_buffer, static_cast<sf_count_t>(readcount));
     }
 
-    ELK_POP_WARNING
+    reader.join();
+    writer.join();
+
+    _render_stats.frames = samplecount;
+    _render_stats.audio_duration = std::chrono::duration<double>(samplecount / static_cast<double>(_engine->sample_rate()));
+    _render_stats.render_duration = std::chrono::steady_clock::now() - wall_clock_start;
+    _render_stats.realtime_factor = _render_stats.render_duration.count() > 0 ?
+            _render_stats.audio_duration / _render_stats.render_duration : 0.0;
+
+    ELKLOG_LOG_INFO("Rendered {} frames, {:.2f} s of audio in {:.2f} s, {:.1f}x realtime",
+                    _render_stats.frames,
+                    _render_stats.audio_duration.count(),
+                    _render_stats.render_duration.count(),
+                    _render_stats.realtime_factor);
 }
 
 } // end namespace sushi::internal::audio_frontend
@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 #include <atomic>
+#include <chrono>
 #include <thread>
 
 #include <sndfile.h>
@@ -33,9 +34,26 @@
 
 namespace sushi::internal::audio_frontend {
 
-constexpr int OFFLINE_FRONTEND_CHANNELS = 2;
+/* Files with fewer channels than this are still processed with a stereo engine */
+constexpr int OFFLINE_FRONTEND_MIN_CHANNELS = 2;
 constexpr int DUMMY_FRONTEND_CHANNELS = 10;
 
+/* Number of audio chunks read from and written to file in one go */
+constexpr int OFFLINE_FRONTEND_BLOCK_CHUNKS = 64;
+/* Number of blocks circulating between the reader, processing and writer threads */
+constexpr int OFFLINE_FRONTEND_BLOCK_COUNT = 4;
+
+/**
+ * @brief Throughput of a completed file render
+ */
+struct OfflineRenderStats
+{
+    int64_t frames{0};
+    std::chrono::duration<double> audio_duration{0};
+    std::chrono::duration<double> render_duration{0};
+    double realtime_factor{0};
+};
+
 struct OfflineFrontendConfiguration : public BaseAudioFrontendConfiguration
 {
     OfflineFrontendConfiguration(std::string input_filename,
@@ -88,6 +106,16 @@ public:
 
     void pause(bool paused) override;
 
+    /**
+     * @brief Get the throughput of the last render, i.e. the last call to run() when
+     *        not in dummy mode.
+     * @return An OfflineRenderStats struct
+     */
+    OfflineRenderStats render_stats() const
+    {
+        return _render_stats;
+    }
+
 private:
     friend OfflineFrontendAccessor;
 
@@ -98,7 +126,7 @@ private:
     SNDFILE*            _input_file;
     SNDFILE*            _output_file;
     SF_INFO             _soundfile_info;
-    bool                _mono;
+    int                 _file_channels{0};
     bool                _dummy_mode;
     std::atomic_bool    _running;
     std::thread         _worker;
@@ -107,6 +135,8 @@ private:
     engine::ControlBuffer _control_buffer;
 
     std::vector<std::unique_ptr<Event>> _event_queue;
+
+    OfflineRenderStats _render_stats;
 };
 
 } // end namespace sushi::internal::audio_frontend
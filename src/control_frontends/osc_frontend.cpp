@@ -202,7 +202,15 @@ int OSCFrontend::process(Event* event)
 
     if (event->is_parameter_change_notification())
     {
-        _handle_param_change_notification(static_cast<ParameterChangeNotificationEvent*>(event));
+        auto typed_event = static_cast<ParameterChangeNotificationEvent*>(event);
+        _send_param_change(typed_event->processor_id(), typed_event->parameter_id(), typed_event->normalized_value());
+    }
+    else if (event->is_parameter_change_batch_notification())
+    {
+        for (const auto& change : static_cast<ParameterChangeBatchNotificationEvent*>(event)->changes())
+        {
+            _send_param_change(change.processor_id, change.parameter_id, change.normalized_value);
+        }
     }
     else if (event->is_property_change_notification())
     {
@@ -547,19 +555,19 @@ void OSCFrontend::_handle_engine_notification(const EngineNotificationEvent* eve
     }
 }
 
-void OSCFrontend::_handle_param_change_notification(const ParameterChangeNotificationEvent* event)
+void OSCFrontend::_send_param_change(ObjectId processor_id, ObjectId parameter_id, float value)
 {
-    const auto& node = _outgoing_connections.find(event->processor_id());
+    const auto& node = _outgoing_connections.find(processor_id);
     if (node != _outgoing_connections.end())
     {
-        const auto& param_node = node->second.find(event->parameter_id());
+        const auto& param_node = node->second.find(parameter_id);
         if (param_node != node->second.end())
         {
-            _osc->send(param_node->second.c_str(), event->normalized_value());
+            _osc->send(param_node->second.c_str(), value);
             ELKLOG_LOG_DEBUG("Sending parameter change from processor: {}, parameter: {}, value: {}",
-                             event->processor_id(),
-                             event->parameter_id(),
-                             event->normalized_value());
+                             processor_id,
+                             parameter_id,
+                             value);
         }
     }
 }
@@ -225,7 +225,7 @@ private:
                                                                         ObjectId processor_id,
                                                                         const std::string& osc_path_prefix);
 
-    void _handle_param_change_notification(const ParameterChangeNotificationEvent* event);
+    void _send_param_change(ObjectId processor_id, ObjectId parameter_id, float value);
 
     void _handle_property_change_notification(const PropertyChangeNotificationEvent* event);
 
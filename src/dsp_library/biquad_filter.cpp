@@ -24,14 +24,41 @@
 #define _USE_MATH_DEFINES
 #endif
 
+#include <cassert>
 #include <cmath>
 #include <algorithm>
 #include <numbers>
 
+#include "sushi/sample_buffer_kernels.h"
+
 namespace sushi::dsp::biquad {
 
 const int TIME_CONSTANTS_IN_SMOOTHING_FILTER = 3;
 
+/* MultichannelBiquadFilter processes this many samples at a time, which bounds the size
+ * of the temporary buffers on the stack */
+constexpr int PROCESSING_BLOCK_SIZE = 16;
+
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+using Ops = kernels::detail::VectorOps;
+#else
+struct ScalarOps
+{
+    using Vector = float;
+    static constexpr int WIDTH = 1;
+
+    static Vector load(const float* data) {return *data;}
+    static void store(float* data, Vector v) {*data = v;}
+    static Vector set(float value) {return value;}
+    static Vector add(Vector a, Vector b) {return a + b;}
+    static Vector mul(Vector a, Vector b) {return a * b;}
+};
+using Ops = ScalarOps;
+#endif
+
+static_assert(SMOOTHED_COEFFICIENTS % Ops::WIDTH == 0);
+static_assert(MAX_BIQUAD_CHANNELS % Ops::WIDTH == 0);
+
 inline float process_one_pole(const OnePoleCoefficients coefficients, const float input, float &z)
 {
     z = coefficients.b0 * input + coefficients.a0 * z;
@@ -126,4 +153,88 @@ void BiquadFilter::process(const float *input, float *output, int samples)
     }
 }
 
+void MultichannelBiquadFilter::reset()
+{
+    /* Same as BiquadFilter, the coefficients are smoothed from 0 after a reset */
+    _z1.fill(0.0f);
+    _z2.fill(0.0f);
+    _smoothing_registers.fill(0.0f);
+}
+
+void MultichannelBiquadFilter::set_smoothing(int buffer_size)
+{
+    _smoothing_coefficients.b0 = std::exp(-2.0f * std::numbers::pi_v<float> * (1.0f / static_cast<float>(buffer_size)) * TIME_CONSTANTS_IN_SMOOTHING_FILTER);
+    _smoothing_coefficients.a0 = 1 - _smoothing_coefficients.b0;
+}
+
+void MultichannelBiquadFilter::set_coefficients(const Coefficients &coefficients)
+{
+    _coefficient_targets = {coefficients.b0, coefficients.b1, coefficients.b2, coefficients.a1, coefficients.a2};
+}
+
+void MultichannelBiquadFilter::process(const float* const* input, float* const* output, int channels, int samples)
+{
+    assert(channels <= MAX_BIQUAD_CHANNELS);
+    constexpr int LANES = Ops::WIDTH;
+
+    for (int start = 0; start < samples; start += PROCESSING_BLOCK_SIZE)
+    {
+        int block_size = std::min(PROCESSING_BLOCK_SIZE, samples - start);
+
+        // Process the coefficients through a one pole smoothing filter, once for all channels
+        float coefficients[PROCESSING_BLOCK_SIZE][SMOOTHED_COEFFICIENTS];
+        auto smoothing_b0 = Ops::set(_smoothing_coefficients.b0);
+        auto smoothing_a0 = Ops::set(_smoothing_coefficients.a0);
+        for (int n = 0; n < block_size; n++)
+        {
+            for (int i = 0; i < SMOOTHED_COEFFICIENTS; i += LANES)
+            {
+                auto z = Ops::add(Ops::mul(smoothing_b0, Ops::load(_coefficient_targets.data() + i)),
+                                  Ops::mul(smoothing_a0, Ops::load(_smoothing_registers.data() + i)));
+                Ops::store(_smoothing_registers.data() + i, z);
+                Ops::store(coefficients[n] + i, z);
+            }
+        }
+
+        for (int first_channel = 0; first_channel < channels; first_channel += LANES)
+        {
+            int lanes = std::min(LANES, channels - first_channel);
+
+            // Interleave the channels so that every sample fills one register
+            float interleaved[PROCESSING_BLOCK_SIZE * LANES] = {};
+            for (int lane = 0; lane < lanes; lane++)
+            {
+                const float* in = input[first_channel + lane] + start;
+                for (int n = 0; n < block_size; n++)
+                {
+                    interleaved[n * LANES + lane] = in[n];
+                }
+            }
+
+            auto z1 = Ops::load(_z1.data() + first_channel);
+            auto z2 = Ops::load(_z2.data() + first_channel);
+            for (int n = 0; n < block_size; n++)
+            {
+                const float* c = coefficients[n];
+                auto x = Ops::load(interleaved + n * LANES);
+                auto y = Ops::add(Ops::mul(Ops::set(c[0]), x), z1);
+                z1 = Ops::add(Ops::add(Ops::mul(Ops::set(c[1]), x), Ops::mul(Ops::set(-c[3]), y)), z2);
+                z2 = Ops::add(Ops::mul(Ops::set(c[2]), x), Ops::mul(Ops::set(-c[4]), y));
+                Ops::store(interleaved + n * LANES, y);
+            }
+            Ops::store(_z1.data() + first_channel, z1);
+            Ops::store(_z2.data() + first_channel, z2);
+
+            for (int lane = 0; lane < lanes; lane++)
+            {
+                float* out = output[first_channel + lane] + start;
+                for (int n = 0; n < block_size; n++)
+                {
+                    out[n] = interleaved[n * LANES + lane];
+                }
+            }
+        }
+    }
+}
+
 } // end namespace sushi::dsp::biquad
\ No newline at end of file
@@ -23,10 +23,20 @@
 #ifndef EQUALIZER_BIQUADFILTER_H
 #define EQUALIZER_BIQUADFILTER_H
 
+#include <array>
+
+#include "sushi/constants.h"
+
 namespace sushi::dsp::biquad {
 
 const int NUMBER_OF_BIQUAD_COEF = 5;
 
+/* The max number of channels processed by a MultichannelBiquadFilter */
+constexpr int MAX_BIQUAD_CHANNELS = MAX_TRACK_CHANNELS;
+
+/* The coefficients are smoothed together in SIMD registers, padded to fill whole registers */
+constexpr int SMOOTHED_COEFFICIENTS = 8;
+
 struct Coefficients
 {
     float b0;
@@ -90,6 +100,46 @@ private:
     float _smoothing_registers[NUMBER_OF_BIQUAD_COEF]{0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
 };
 
+/*
+ * Filter class for processing several channels with the same coefficients. Instead
+ * of running one filter after another, every channel is processed in a lane of a SIMD
+ * register. The coefficient smoothing is shared by all channels and vectorised over
+ * the coefficients. Gives the same output as one BiquadFilter per channel.
+ */
+class MultichannelBiquadFilter
+{
+public:
+    MultichannelBiquadFilter() = default;
+
+    ~MultichannelBiquadFilter() = default;
+
+    /*
+     * Resets the processing state of all channels
+     */
+    void reset();
+
+    /*
+     * Sets the parameters for smoothing filter changes
+     */
+    void set_smoothing(int buffer_size);
+
+    void set_coefficients(const Coefficients &coefficients);
+
+    /*
+     * Process channels, with separate input and output buffers for every channel.
+     * channels must not be larger than MAX_BIQUAD_CHANNELS.
+     */
+    void process(const float* const* input, float* const* output, int channels, int samples);
+
+private:
+    // Coefficients in the order b0, b1, b2, a1, a2, followed by padding
+    alignas(32) std::array<float, SMOOTHED_COEFFICIENTS> _coefficient_targets{};
+    alignas(32) std::array<float, SMOOTHED_COEFFICIENTS> _smoothing_registers{};
+    OnePoleCoefficients _smoothing_coefficients{0.0f, 0.0f};
+    alignas(32) std::array<float, MAX_BIQUAD_CHANNELS> _z1{};
+    alignas(32) std::array<float, MAX_BIQUAD_CHANNELS> _z2{};
+};
+
 } // end namespace sushi::dsp::biquad
 
 #endif //EQUALIZER_BIQUADFILTER_H
@@ -21,9 +21,12 @@
 #ifndef SUSHI_MASTER_LIMITER_H
 #define SUSHI_MASTER_LIMITER_H
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 
+#include "sushi/sample_buffer_kernels.h"
+
 namespace sushi::dsp {
 
 /**
@@ -44,6 +47,7 @@ constexpr float THRESHOLD_GAIN = 1.0;
 constexpr float RELEASE_TIME_MS = 100.0;
 constexpr float ATTACK_TIME_MS = 0.0;
 constexpr int UPSAMPLING_FACTOR = 4;
+constexpr int FILTER_TAPS = 4;
 /**
  * Since exponentials never reach their target this constant is used
  * to set a higher target than the intended one. This is then reversed
@@ -56,6 +60,9 @@ constexpr float ATTACK_RATIO = 1.6f;
 /**
  * @brief 4x polyphase interpolator.
  *
+ *        The input is copied after the last FILTER_TAPS - 1 samples of the previous chunk
+ *        so that every filter tap reads from a contiguous buffer. This lets the true peak
+ *        calculation process several consecutive samples at once in SIMD registers.
  */
 template<int CHUNK_SIZE>
 class UpSampler
@@ -69,38 +76,97 @@ public:
      */
     void reset()
     {
-        _delay_line.fill(0.0f);
+        _buffer.fill(0.0f);
     }
 
     /**
-     * @brief Interpolate one sample to 4x the original sample_rate
+     * @brief Interpolate a chunk of samples to 4x the original sample_rate
      * using a polyphase implementation
      *
-     * @param sample The sample to interpolate
-     * @return std::array<float, 4> Resulting samples
+     * @param input CHUNK_SIZE samples to interpolate
+     * @param output UPSAMPLING_FACTOR * CHUNK_SIZE interpolated samples
      */
     inline void process(const float* input, float* output)
     {
+        _write_input(input);
         for (int sample_idx = 0; sample_idx < CHUNK_SIZE; sample_idx++)
         {
-            _delay_line[_write_idx] = input[sample_idx]; // Write sample into internal delayline
-            for (size_t i = 0; i < UPSAMPLING_FACTOR; i++)
+            for (int i = 0; i < UPSAMPLING_FACTOR; i++)
             {
-                float upsampled_value = 0.0;
-                // Convolve the filter with the sample data
-                for (size_t j = 0; j < _delay_line.size(); j++)
+                output[UPSAMPLING_FACTOR * sample_idx + i] = _interpolate(sample_idx, i);
+            }
+        }
+        _save_history();
+    }
+
+    /**
+     * @brief Calculate the true peak of every sample in a chunk, i.e. the largest absolute
+     * value of the sample and the values interpolated between it and the previous sample.
+     *
+     * @param input CHUNK_SIZE samples to interpolate
+     * @param peaks CHUNK_SIZE true peak values
+     */
+    inline void process_true_peak(const float* input, float* peaks)
+    {
+        _write_input(input);
+#ifdef SUSHI_SIMD_KERNELS_VECTORISED
+        using Ops = kernels::detail::VectorOps;
+        const float* samples = _buffer.data() + FILTER_TAPS - 1;
+        constexpr int VECTORISED_SAMPLES = CHUNK_SIZE / Ops::WIDTH * Ops::WIDTH;
+        for (int sample_idx = 0; sample_idx < VECTORISED_SAMPLES; sample_idx += Ops::WIDTH)
+        {
+            auto peak = Ops::abs(Ops::load(samples + sample_idx));
+            for (int i = 0; i < UPSAMPLING_FACTOR; i++)
+            {
+                // Same order of operations as _interpolate() so that the results are identical
+                auto upsampled_value = Ops::set(0.0f);
+                for (int j = 0; j < FILTER_TAPS; j++)
                 {
-                    int read_idx = (_write_idx - j) & 0b11;
-                    upsampled_value += filter_coeffs[i][j] * _delay_line[read_idx];
+                    upsampled_value = Ops::add(upsampled_value, Ops::mul(Ops::set(filter_coeffs[i][j]),
+                                                                         Ops::load(samples + sample_idx - j)));
                 }
-                output[UPSAMPLING_FACTOR * sample_idx + i] = upsampled_value;
+                peak = Ops::max(peak, Ops::abs(upsampled_value));
+            }
+            Ops::store(peaks + sample_idx, peak);
+        }
+#else
+        constexpr int VECTORISED_SAMPLES = 0;
+#endif
+        for (int sample_idx = VECTORISED_SAMPLES; sample_idx < CHUNK_SIZE; sample_idx++)
+        {
+            float peak = std::abs(input[sample_idx]);
+            for (int i = 0; i < UPSAMPLING_FACTOR; i++)
+            {
+                peak = std::max(peak, std::abs(_interpolate(sample_idx, i)));
             }
-            _write_idx = (_write_idx + 1) & 0b11; // Fast index wrapping for 2^n size circular buffers
+            peaks[sample_idx] = peak;
         }
+        _save_history();
     }
+
 private:
-    std::array<float, 4> _delay_line;
-    int _write_idx{0};
+    inline void _write_input(const float* input)
+    {
+        std::copy(input, input + CHUNK_SIZE, _buffer.begin() + FILTER_TAPS - 1);
+    }
+
+    inline void _save_history()
+    {
+        std::copy(_buffer.end() - (FILTER_TAPS - 1), _buffer.end(), _buffer.begin());
+    }
+
+    inline float _interpolate(int sample_idx, int phase) const
+    {
+        float upsampled_value = 0.0f;
+        // Convolve the filter with the sample data, the chunk starts at FILTER_TAPS - 1 in _buffer
+        for (int j = 0; j < FILTER_TAPS; j++)
+        {
+            upsampled_value += filter_coeffs[phase][j] * _buffer[sample_idx + FILTER_TAPS - 1 - j];
+        }
+        return upsampled_value;
+    }
+
+    std::array<float, CHUNK_SIZE + FILTER_TAPS - 1> _buffer{};
 };
 
 /**
@@ -141,16 +207,12 @@ public:
      */
     void process(const float* input, float* output)
     {
-        std::array<float, UPSAMPLING_FACTOR * CHUNK_SIZE> up_sampled_values;
-        _up_sampler.process(input, up_sampled_values.data());
+        std::array<float, CHUNK_SIZE> true_peaks;
+        _up_sampler.process_true_peak(input, true_peaks.data());
         for (int sample_idx = 0; sample_idx < CHUNK_SIZE; sample_idx++)
         {
-            // Calculate the highest peak from true peak calculations and the current sample value
-            float true_peak = std::abs(input[sample_idx]);
-            for (int upsampled_idx = 0; upsampled_idx < UPSAMPLING_FACTOR; upsampled_idx++)
-            {
-                true_peak = std::max(true_peak, std::abs(up_sampled_values[UPSAMPLING_FACTOR * sample_idx + upsampled_idx]));
-            }
+            // The highest peak from true peak calculations and the current sample value
+            float true_peak = true_peaks[sample_idx];
 
             // Calculate gain reduction
             if (true_peak > THRESHOLD_GAIN)
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Thread pool for asynchronous work requested by processors
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#include <algorithm>
+
+#include "elklog/static_logger.h"
+
+#include "async_work_executor.h"
+#include "engine/base_engine.h"
+#include "engine/base_event_dispatcher.h"
+#include "library/event.h"
+
+namespace sushi::internal::engine {
+
+ELKLOG_GET_LOGGER_WITH_MODULE_NAME("async work");
+
+constexpr auto POLL_PERIODICITY = std::chrono::milliseconds(1);
+
+AsyncWorkExecutor::AsyncWorkExecutor(BaseEngine* engine, int threads) : _engine(engine),
+                                                                         _thread_count(std::max(threads, 1))
+{
+    try
+    {
+        _rt_notifier = twine::RtConditionVariable::create_rt_condition_variable();
+    }
+    catch ([[maybe_unused]] const std::exception& e)
+    {
+        ELKLOG_LOG_ERROR("Failed to instantiate RtConditionVariable ({}), falling back to polling", e.what());
+    }
+}
+
+AsyncWorkExecutor::~AsyncWorkExecutor()
+{
+    if (_running)
+    {
+        stop();
+    }
+}
+
+void AsyncWorkExecutor::run()
+{
+    if (!_running)
+    {
+        _running = true;
+        _intake_thread = std::thread(&AsyncWorkExecutor::_intake_loop, this);
+        for (int i = 0; i < _thread_count; ++i)
+        {
+            _worker_threads.emplace_back(&AsyncWorkExecutor::_worker_loop, this);
+        }
+    }
+}
+
+void AsyncWorkExecutor::stop()
+{
+    {
+        std::scoped_lock lock(_lock);
+        _running = false;
+    }
+    _work_available.notify_all();
+    if (_rt_notifier)
+    {
+        _rt_notifier->notify();
+    }
+    if (_intake_thread.joinable())
+    {
+        _intake_thread.join();
+    }
+    for (auto& thread : _worker_threads)
+    {
+        thread.join();
+    }
+    _worker_threads.clear();
+}
+
+bool AsyncWorkExecutor::push_rt(const RtEvent& event)
+{
+    assert(event.type() == RtEventType::ASYNC_WORK);
+    // Pending work must be queued first, or work from the same processor could be reordered
+    if (_rt_pending_count == 0 && _rt_queue.push(event))
+    {
+        _rt_work_queued = true;
+        return true;
+    }
+    if (_rt_pending_count == MAX_PENDING_RT_WORK)
+    {
+        _rt_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    _rt_pending[(_rt_pending_head + _rt_pending_count) % MAX_PENDING_RT_WORK] = event;
+    _rt_pending_count++;
+    return true;
+}
+
+void AsyncWorkExecutor::notify_rt()
+{
+    while (_rt_pending_count > 0 && _rt_queue.push(_rt_pending[_rt_pending_head]))
+    {
+        _rt_pending_head = (_rt_pending_head + 1) % MAX_PENDING_RT_WORK;
+        _rt_pending_count--;
+        _rt_work_queued = true;
+    }
+    if (_rt_work_queued)
+    {
+        _rt_work_queued = false;
+        if (_rt_notifier)
+        {
+            _rt_notifier->notify();
+        }
+    }
+}
+
+void AsyncWorkExecutor::_intake_loop()
+{
+    while (_running)
+    {
+        int count = 0;
+        {
+            std::scoped_lock lock(_lock);
+            RtEvent event;
+            while (_rt_queue.pop(event))
+            {
+                auto typed_event = event.async_work_event();
+                _queue_task({typed_event->callback(),
+                             typed_event->callback_data(),
+                             typed_event->processor_id(),
+                             typed_event->event_id(),
+                             typed_event->priority()});
+                count++;
+            }
+        }
+        if (count > 0)
+        {
+            _work_available.notify_all();
+        }
+        [[maybe_unused]] auto dropped = _rt_dropped.exchange(0);
+        ELKLOG_LOG_WARNING_IF(dropped > 0, "Dropped {} asynchronous work requests from the audio thread, queue full", dropped)
+
+        if (_rt_notifier)
+        {
+            _rt_notifier->wait();
+        }
+        else
+        {
+            std::this_thread::sleep_for(POLL_PERIODICITY);
+        }
+    }
+}
+
+void AsyncWorkExecutor::_worker_loop()
+{
+    std::unique_lock lock(_lock);
+    while (true)
+    {
+        _work_available.wait(lock, [&] {return !_running || _has_ready_work();});
+        if (!_running)
+        {
+            break;
+        }
+
+        auto ready = std::find_if(_ready.begin(), _ready.end(), [](const auto& list) {return !list.empty();});
+        auto processor = ready->front();
+        ready->pop_front();
+        auto& strand = _strands[processor];
+        auto task = strand.tasks.front();
+        strand.tasks.pop_front();
+        strand.running = true;
+
+        lock.unlock();
+        int status = task.callback(task.data, task.event_id);
+        _send_completion(task, status);
+        lock.lock();
+
+        // References to map elements stay valid, and a running strand is never erased by others
+        strand.running = false;
+        if (strand.tasks.empty())
+        {
+            _strands.erase(processor);
+        }
+        else
+        {
+            _ready[static_cast<int>(strand.tasks.front().priority)].push_back(processor);
+            _work_available.notify_one();
+        }
+    }
+}
+
+void AsyncWorkExecutor::_queue_task(const Task& task)
+{
+    auto& strand = _strands[task.processor];
+    strand.tasks.push_back(task);
+    // If there were tasks already, the strand is either running or already in a ready list
+    if (strand.running == false && strand.tasks.size() == 1)
+    {
+        _ready[static_cast<int>(task.priority)].push_back(task.processor);
+    }
+}
+
+bool AsyncWorkExecutor::_has_ready_work() const
+{
+    return std::any_of(_ready.begin(), _ready.end(), [](const auto& list) {return !list.empty();});
+}
+
+void AsyncWorkExecutor::_send_completion(const Task& task, int status)
+{
+    auto event = RtEvent::make_async_work_completion_event(task.processor, task.event_id, status);
+    if (_engine->send_timed_rt_event(event, IMMEDIATE_PROCESS) != EngineReturnStatus::OK)
+    {
+        // The queue to the audio thread is full, take the slower path through the dispatcher
+        _engine->event_dispatcher()->post_event(std::make_unique<AsynchronousProcessorWorkCompletionEvent>(status,
+                                                                                                          task.processor,
+                                                                                                          task.event_id,
+                                                                                                          IMMEDIATE_PROCESS));
+    }
+}
+
+} // end namespace sushi::internal::engine
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Thread pool for asynchronous work requested by processors
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_ASYNC_WORK_EXECUTOR_H
+#define SUSHI_ASYNC_WORK_EXECUTOR_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "twine/twine.h"
+
+#include "sushi/constants.h"
+
+#include "library/rt_event.h"
+#include "library/rt_event_fifo.h"
+
+namespace sushi::internal::engine {
+
+// Max number of work requests kept on the audio thread while the queue to the executor is full
+constexpr int MAX_PENDING_RT_WORK = MAX_EVENTS_IN_QUEUE;
+
+class BaseEngine;
+class AsyncWorkExecutorAccessor;
+
+/**
+ * @brief Executes asynchronous work that processors request from the audio thread with
+ *        Processor::request_non_rt_task(), on a pool of non-realtime threads. Requests
+ *        are handed over from the audio thread through a wait free queue and a wakeup,
+ *        and completions are sent straight back to the engine, so neither passes through
+ *        the event dispatcher. Work from the same processor is done one task at a time,
+ *        in the order it was requested. Work from different processors can be done in
+ *        parallel, and higher priority work is started before lower priority work.
+ */
+class AsyncWorkExecutor
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(AsyncWorkExecutor);
+
+    /**
+     * @param engine The engine to send completion events to
+     * @param threads The number of threads to execute work on
+     */
+    AsyncWorkExecutor(BaseEngine* engine, int threads);
+
+    ~AsyncWorkExecutor();
+
+    void run();
+
+    void stop();
+
+    /**
+     * @brief Queue an ASYNC_WORK RtEvent for execution. Must only be called from the
+     *        audio thread, and the executor is not woken up until notify_rt() is called.
+     *        If the queue to the executor is full, the work is kept in a pending list on
+     *        the audio thread, in order, and retried by notify_rt().
+     * @param event An RtEvent of type ASYNC_WORK
+     * @return true if the work was queued, false if the pending list is full as well and
+     *         the work was dropped
+     */
+    bool push_rt(const RtEvent& event);
+
+    /**
+     * @brief Retry queueing any pending work and wake up the executor if any work was
+     *        queued since the last call. Must only be called from the audio thread,
+     *        typically once per chunk.
+     */
+    void notify_rt();
+
+private:
+    friend AsyncWorkExecutorAccessor;
+
+    struct Task
+    {
+        AsyncWorkCallback callback;
+        void*             data;
+        ObjectId          processor;
+        EventId           event_id;
+        AsyncWorkPriority priority;
+    };
+
+    // Pending work of one processor, only one task per strand is executed at a time
+    struct Strand
+    {
+        std::deque<Task> tasks;
+        bool running{false};
+    };
+
+    void _intake_loop();
+
+    void _worker_loop();
+
+    void _queue_task(const Task& task);
+
+    bool _has_ready_work() const;
+
+    void _send_completion(const Task& task, int status);
+
+    BaseEngine*       _engine;
+    int               _thread_count;
+    std::atomic<bool> _running{false};
+
+    std::thread              _intake_thread;
+    std::vector<std::thread> _worker_threads;
+
+    RtSafeRtEventFifo _rt_queue;
+    // Only accessed from the audio thread
+    bool _rt_work_queued{false};
+    // Work that didn't fit in _rt_queue, as a ring buffer. Only accessed from the audio thread
+    std::array<RtEvent, MAX_PENDING_RT_WORK> _rt_pending;
+    int _rt_pending_head{0};
+    int _rt_pending_count{0};
+    // Work dropped because _rt_pending was full, logged by the intake thread
+    std::atomic<int> _rt_dropped{0};
+    // Notified by the audio thread, if nullptr the intake thread polls instead
+    std::unique_ptr<twine::RtConditionVariable> _rt_notifier;
+
+    // Protects all members below
+    std::mutex              _lock;
+    std::condition_variable _work_available;
+    std::unordered_map<ObjectId, Strand> _strands;
+    // Processors whose next task is ready to run, one list per priority
+    std::array<std::deque<ObjectId>, ASYNC_WORK_PRIORITIES> _ready;
+};
+
+} // end namespace sushi::internal::engine
+
+#endif // SUSHI_ASYNC_WORK_EXECUTOR_H
@@ -18,6 +18,7 @@
  * @Copyright 2017-2023 Elk Audio AB, Stockholm
  */
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <functional>
@@ -57,6 +58,19 @@ EngineReturnStatus to_engine_status(ProcessorReturnCode processor_status)
     }
 }
 
+bool buffers_overlap(const ChunkSampleBuffer& lhs, const ChunkSampleBuffer& rhs)
+{
+    if (lhs.channel_count() == 0 || rhs.channel_count() == 0)
+    {
+        return false;
+    }
+    auto lhs_start = reinterpret_cast<uintptr_t>(lhs.channel(0));
+    auto lhs_end = reinterpret_cast<uintptr_t>(lhs.channel(lhs.channel_count() - 1) + AUDIO_CHUNK_SIZE);
+    auto rhs_start = reinterpret_cast<uintptr_t>(rhs.channel(0));
+    auto rhs_end = reinterpret_cast<uintptr_t>(rhs.channel(rhs.channel_count() - 1) + AUDIO_CHUNK_SIZE);
+    return lhs_start < rhs_end && rhs_start < lhs_end;
+}
+
 void ClipDetector::set_sample_rate(float sample_rate)
 {
     _interval = static_cast<unsigned int>(sample_rate * CLIPPING_DETECTION_INTERVAL.count() / 1000 - AUDIO_CHUNK_SIZE);
@@ -91,12 +105,16 @@ AudioEngine::AudioEngine(float sample_rate,
                          int rt_cpu_cores,
                          std::optional<std::string> device_name,
                          bool debug_mode_sw,
-                         dispatcher::BaseEventDispatcher* event_dispatcher) : BaseEngine::BaseEngine(sample_rate),
-                                                          _audio_graph(rt_cpu_cores, MAX_TRACKS, sample_rate, device_name, debug_mode_sw),
+                         dispatcher::BaseEventDispatcher* event_dispatcher,
+                         SchedulingMode scheduling) : BaseEngine::BaseEngine(sample_rate),
+                                                      _buffer_arena(std::make_shared<BufferArena>()),
+                                                      _audio_graph(rt_cpu_cores, MAX_TRACKS, sample_rate, device_name, debug_mode_sw, scheduling,
+                                                                   &_audio_routing_generation),
                                                           _audio_in_connections(MAX_AUDIO_CONNECTIONS),
                                                           _audio_out_connections(MAX_AUDIO_CONNECTIONS),
                                                           _transport(sample_rate, &_main_out_queue),
-                                                          _clip_detector(sample_rate)
+                                                          _clip_detector(sample_rate),
+                                                          _rt_event_timer(sample_rate)
 {
     if (event_dispatcher == nullptr)
     {
@@ -106,16 +124,26 @@ AudioEngine::AudioEngine(float sample_rate,
     {
         _event_dispatcher.reset(event_dispatcher);
     }
-    _host_control = HostControl(_event_dispatcher.get(), &_transport, &_plugin_library);
+    _host_control = HostControl(_event_dispatcher.get(), &_transport, &_plugin_library, &_reclaimer, &_audio_routing_generation);
+    _reclaimer.run();
 
     this->set_sample_rate(sample_rate);
     _cv_in_connections.reserve(MAX_CV_CONNECTIONS);
     _gate_in_connections.reserve(MAX_GATE_CONNECTIONS);
+    _input_aliases.reserve(MAX_TRACKS);
+    _input_copies.reserve(MAX_AUDIO_CONNECTIONS);
+    _output_copies.reserve(MAX_AUDIO_CONNECTIONS);
+    _output_routed_tracks.reserve(MAX_TRACKS);
 }
 
 AudioEngine::~AudioEngine()
 {
+    if (_async_work_executor)
+    {
+        _async_work_executor->stop();
+    }
     _event_dispatcher->stop();
+    _reclaimer.stop();
     if (_process_timer.enabled())
     {
         _process_timer.enable(false);
@@ -133,10 +161,15 @@ void AudioEngine::set_sample_rate(float sample_rate)
     _transport.set_sample_rate(sample_rate);
     _process_timer.set_timing_period(sample_rate, AUDIO_CHUNK_SIZE);
     _clip_detector.set_sample_rate(sample_rate);
+    _rt_event_timer.set_sample_rate(sample_rate);
     for (auto& limiter : _master_limiters)
     {
         limiter.init(sample_rate);
     }
+    if (_telemetry)
+    {
+        _telemetry->set_sample_rate(sample_rate);
+    }
 }
 
 void AudioEngine::set_audio_channels(int inputs, int outputs)
@@ -144,8 +177,12 @@ void AudioEngine::set_audio_channels(int inputs, int outputs)
     _clip_detector.set_channels(inputs, outputs);
 
     BaseEngine::set_audio_channels(inputs, outputs);
-    _input_swap_buffer = ChunkSampleBuffer(inputs);
-    _output_swap_buffer = ChunkSampleBuffer(outputs);
+    _buffer_arena->release(_input_swap_buffer);
+    _buffer_arena->release(_output_swap_buffer);
+    _input_swap_buffer = _buffer_arena->allocate(inputs);
+    _output_swap_buffer = _buffer_arena->allocate(outputs);
+    _audio_graph.set_output_channels(outputs);
+    _audio_routing_changed = true;
 
     _master_limiters.clear();
     for (int c = 0; c < outputs; c++)
@@ -340,6 +377,31 @@ bool AudioEngine::realtime()
     return _state.load() != RealtimeState::STOPPED;
 }
 
+void AudioEngine::enable_async_work_executor(int threads)
+{
+    assert(_state == RealtimeState::STOPPED);
+    if (_async_work_executor == nullptr)
+    {
+        _async_work_executor = std::make_unique<AsyncWorkExecutor>(this, threads);
+        _async_work_executor->run();
+        ELKLOG_LOG_INFO("Executing asynchronous work on {} threads", threads);
+    }
+}
+
+bool AudioEngine::enable_telemetry(const std::string& path)
+{
+    assert(_state == RealtimeState::STOPPED);
+    auto telemetry = std::make_unique<TelemetryPublisher>();
+    if (telemetry->open(path) == false)
+    {
+        return false;
+    }
+    telemetry->set_sample_rate(_sample_rate);
+    _audio_graph.set_measure_render_times(true);
+    _telemetry = std::move(telemetry);
+    return true;
+}
+
 void AudioEngine::enable_realtime(bool enabled)
 {
     if (enabled)
@@ -365,6 +427,8 @@ EngineReturnStatus AudioEngine::_register_processor(std::shared_ptr<Processor> p
         ELKLOG_LOG_WARNING("Processor with this name already exists");
         return EngineReturnStatus::INVALID_PROCESSOR;
     }
+    // Make room for the processor to be inserted in the realtime part without allocating
+    _realtime_processors.prepare_insert();
     ELKLOG_LOG_DEBUG("Successfully registered processor {}.", name);
     return EngineReturnStatus::OK;
 }
@@ -372,37 +436,20 @@ EngineReturnStatus AudioEngine::_register_processor(std::shared_ptr<Processor> p
 void AudioEngine::_deregister_processor(Processor* processor)
 {
     assert(processor);
-    assert(processor->active_rt_processing() == false);
+    // Inside a graph transaction, the processor is kept alive until it's removed from the realtime part
+    assert(processor->active_rt_processing() == false || _graph_transaction_open());
     _processors.remove_processor(processor->id());
     ELKLOG_LOG_INFO("Successfully de-registered processor {}", processor->name());
 }
 
 bool AudioEngine::_insert_processor_in_realtime_part(Processor* processor)
 {
-    if (processor->id() > _realtime_processors.size())
-    {
-        /* TODO - When non-rt callbacks for events are ready we can have the
-         * rt processor list re-allocated outside the rt domain
-         * In the meantime, put a limit on the number of processors */
-        ELKLOG_LOG_ERROR("Realtime processor list full");
-        assert(false);
-    }
-    if (_realtime_processors[processor->id()] != nullptr)
-    {
-        return false;
-    }
-    _realtime_processors[processor->id()] = processor;
-    return true;
+    return _realtime_processors.insert(processor);
 }
 
 bool AudioEngine::_remove_processor_from_realtime_part(ObjectId processor)
 {
-    if (_realtime_processors[processor] == nullptr)
-    {
-        return false;
-    }
-    _realtime_processors[processor] = nullptr;
-    return true;
+    return _realtime_processors.remove(processor);
 }
 
 void AudioEngine::_remove_connections_from_track(ObjectId track_id)
@@ -434,11 +481,18 @@ void AudioEngine::process_chunk(SampleBuffer<AUDIO_CHUNK_SIZE>* in_buffer,
     twine::ThreadRtFlag rt_flag;
 
     auto engine_timestamp = _process_timer.start_timer();
+    auto telemetry_timestamp = _telemetry ? twine::current_rt_time() : std::chrono::nanoseconds(0);
 
     _transport.set_time(timestamp, sample_count);
 
     _process_internal_rt_events();
     _send_rt_events_to_processors();
+    _send_timed_rt_events_to_processors();
+
+    if (_audio_routing_changed.exchange(false))
+    {
+        _update_audio_routing();
+    }
 
     if (_cv_inputs > 0)
     {
@@ -446,27 +500,49 @@ void AudioEngine::process_chunk(SampleBuffer<AUDIO_CHUNK_SIZE>* in_buffer,
     }
 
     _event_dispatcher->set_time(_transport.current_process_time());
+    _rt_event_timer.set_incoming_time(_transport.current_process_time());
     auto state = _state.load();
 
     if (_input_clip_detection_enabled)
     {
         _clip_detector.detect_clipped_samples(*in_buffer, _main_out_queue, true);
     }
+    if (_telemetry)
+    {
+        _telemetry->measure_input_rt(*in_buffer);
+    }
 
     if (_pre_track)
     {
         _pre_track->process_audio(*in_buffer, _input_swap_buffer);
         _copy_audio_to_tracks(&_input_swap_buffer);
     }
+    else if (buffers_overlap(*in_buffer, *out_buffer))
+    {
+        /* Tracks read aliased inputs while the output is cleared and mixed to during
+         * render(), so if the frontend passes the same memory for both, the input
+         * must be copied first */
+        int channels = std::min(in_buffer->channel_count(), _input_swap_buffer.channel_count());
+        for (int c = 0; c < channels; ++c)
+        {
+            _input_swap_buffer.replace(c, c, *in_buffer);
+        }
+        _copy_audio_to_tracks(&_input_swap_buffer);
+    }
     else
     {
         _copy_audio_to_tracks(in_buffer);
     }
 
-    // Render all tracks. If running in multicore mode, this part is processed in parallel.
-    _audio_graph.render();
+    /* Render all tracks and mix them to the outputs. If running in multicore mode, this part,
+     * including the mixing, is processed in parallel. */
+    _audio_graph.render(_post_track ? &_output_swap_buffer : out_buffer);
 
     _retrieve_events_from_tracks(*out_controls);
+    if (_async_work_executor)
+    {
+        _async_work_executor->notify_rt();
+    }
     _main_out_queue.push(RtEvent::make_synchronisation_event(_transport.current_process_time()));
     _state.store(update_state(state));
 
@@ -482,18 +558,20 @@ void AudioEngine::process_chunk(SampleBuffer<AUDIO_CHUNK_SIZE>* in_buffer,
 
     if (_master_limiter_enabled)
     {
-        auto temp_input_buffer = ChunkSampleBuffer::create_non_owning_buffer(*out_buffer, 0, out_buffer->channel_count());
-        for (int c = 0; c < out_buffer->channel_count(); c++)
-        {
-            _master_limiters[c].process(out_buffer->channel(c), out_buffer->channel(c));
-        }
-        out_buffer->replace(temp_input_buffer);
+        _apply_master_limiter(*out_buffer);
     }
 
     if (_output_clip_detection_enabled)
     {
         _clip_detector.detect_clipped_samples(*out_buffer, _main_out_queue, false);
     }
+    if (_telemetry)
+    {
+        _telemetry->publish_rt(*out_buffer, _transport, _audio_graph,
+                               twine::current_rt_time() - telemetry_timestamp);
+    }
+    _event_dispatcher->notify_rt_events();
+    _reclaimer.advance_epoch();
     _process_timer.stop_timer(engine_timestamp, ENGINE_TIMING_ID);
 }
 
@@ -547,6 +625,12 @@ EngineReturnStatus AudioEngine::send_rt_event_to_processor(const RtEvent& event)
     return status? EngineReturnStatus::OK : EngineReturnStatus::QUEUE_FULL;
 }
 
+EngineReturnStatus AudioEngine::send_timed_rt_event(const RtEvent& event, Time timestamp)
+{
+    auto status = _timed_in_queue.push(event, timestamp);
+    return status? EngineReturnStatus::OK : EngineReturnStatus::QUEUE_FULL;
+}
+
 EngineReturnStatus AudioEngine::_send_control_event(RtEvent& event)
 {
     // This queue will only handle engine control events, not processor events
@@ -559,6 +643,143 @@ EngineReturnStatus AudioEngine::_send_control_event(RtEvent& event)
     return EngineReturnStatus::QUEUE_FULL;
 }
 
+bool AudioEngine::_send_graph_events(std::initializer_list<RtEvent> events, std::function<void()> on_failure)
+{
+    if (_graph_transaction_open())
+    {
+        auto& transaction = *_graph_transaction;
+        transaction.events.insert(transaction.events.end(), events);
+        transaction.changes.push_back({transaction.events.size(), std::move(on_failure)});
+        return true;
+    }
+
+    std::vector<receiver::ResponseTicket> tickets;
+    for (auto event : events)
+    {
+        tickets.push_back(_event_receiver.expect_response(event.returnable_event()->event_id()));
+        _send_control_event(event);
+    }
+    bool handled = true;
+    for (const auto& ticket : tickets)
+    {
+        bool event_handled = _event_receiver.wait_for_response(ticket, RT_EVENT_TIMEOUT);
+        handled = handled && event_handled;
+    }
+    if (!handled && on_failure)
+    {
+        on_failure();
+    }
+    return handled;
+}
+
+void AudioEngine::_after_graph_changes(std::function<void()> action)
+{
+    if (_graph_transaction_open())
+    {
+        _graph_transaction->completion_actions.push_back(std::move(action));
+    }
+    else
+    {
+        action();
+    }
+}
+
+bool AudioEngine::_on_track(const Processor& processor) const
+{
+    if (_graph_transaction_open() == false)
+    {
+        return processor.active_rt_processing();
+    }
+    // The realtime part is not updated until the transaction is committed, check the engine's mirror of the tracks instead
+    for (const auto& track : _processors.all_tracks())
+    {
+        for (const auto& track_processor : _processors.processors_on_track(track->id()))
+        {
+            if (track_processor->id() == processor.id())
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+EngineReturnStatus AudioEngine::begin_graph_transaction()
+{
+    std::thread::id no_thread;
+    if (_graph_transaction_thread.compare_exchange_strong(no_thread, std::this_thread::get_id()) == false)
+    {
+        ELKLOG_LOG_ERROR("Failed to begin graph transaction, a transaction is already open");
+        return EngineReturnStatus::ERROR;
+    }
+    _graph_transaction = std::make_unique<GraphTransaction>();
+    return EngineReturnStatus::OK;
+}
+
+EngineReturnStatus AudioEngine::commit_graph_transaction()
+{
+    if (_graph_transaction_open() == false)
+    {
+        ELKLOG_LOG_ERROR("Failed to commit graph transaction, no transaction open in this thread");
+        return EngineReturnStatus::ERROR;
+    }
+    auto transaction = std::move(_graph_transaction);
+    _graph_transaction_thread = std::thread::id();
+
+    auto& events = transaction->events;
+    bool all_handled = true;
+    if (events.empty() == false)
+    {
+        assert(realtime());
+        auto inserts = std::count_if(events.begin(), events.end(), [](const RtEvent& e)
+        {
+            return e.type() == RtEventType::INSERT_PROCESSOR;
+        });
+        _realtime_processors.prepare_insert(static_cast<int>(inserts));
+
+        auto event = RtEvent::make_graph_transaction_event(transaction.get());
+        auto ticket = _event_receiver.expect_response(event.returnable_event()->event_id());
+        if (_send_control_event(event) != EngineReturnStatus::OK)
+        {
+            ELKLOG_LOG_ERROR("Failed to send graph transaction with {} changes, queue full", transaction->changes.size());
+        }
+        else if (!_event_receiver.wait_for_response(ticket, RT_EVENT_TIMEOUT) &&
+                 transaction->state.exchange(GraphTransaction::State::ABANDONED) != GraphTransaction::State::DONE)
+        {
+            /* The audio thread might still access the events later, it takes over the
+             * transaction, and the processors it keeps alive, and retires it when done */
+            ELKLOG_LOG_ERROR("Graph transaction with {} changes was not applied in time", transaction->changes.size());
+            [[maybe_unused]] auto abandoned = transaction.release();
+            return EngineReturnStatus::ERROR;
+        }
+
+        // Events that were not sent or processed are still unhandled and reported as failed
+        size_t first_event = 0;
+        for (auto& change : transaction->changes)
+        {
+            bool handled = std::all_of(events.begin() + first_event, events.begin() + change.events_end, [](const RtEvent& e)
+            {
+                return e.returnable_event()->status() == ReturnableRtEvent::EventStatus::HANDLED_OK;
+            });
+            if (!handled)
+            {
+                all_handled = false;
+                if (change.on_failure)
+                {
+                    change.on_failure();
+                }
+            }
+            first_event = change.events_end;
+        }
+    }
+
+    for (auto& action : transaction->completion_actions)
+    {
+        action();
+    }
+    return all_handled ? EngineReturnStatus::OK : EngineReturnStatus::ERROR;
+}
+
 std::pair<EngineReturnStatus, ObjectId> AudioEngine::create_multibus_track(const std::string& name, int bus_count)
 {
     if (bus_count > MAX_TRACK_BUSES)
@@ -566,7 +787,7 @@ std::pair<EngineReturnStatus, ObjectId> AudioEngine::create_multibus_track(const
         ELKLOG_LOG_ERROR("Invalid number of buses for new track");
         return {EngineReturnStatus::INVALID_N_CHANNELS, ObjectId(0)};
     }
-    auto track = std::make_shared<Track>(_host_control, bus_count, &_process_timer);
+    auto track = std::make_shared<Track>(_host_control, bus_count, &_process_timer, _buffer_arena);
     auto status = _register_new_track(name, track);
     if (status != EngineReturnStatus::OK)
     {
@@ -585,7 +806,7 @@ std::pair<EngineReturnStatus, ObjectId> AudioEngine::create_track(const std::str
     // Only mono and stereo track have a pan parameter
     bool pan_control = channel_count <= 2;
 
-    auto track = std::make_shared<Track>(_host_control, channel_count, &_process_timer, pan_control);
+    auto track = std::make_shared<Track>(_host_control, channel_count, &_process_timer, pan_control, TrackType::REGULAR, _buffer_arena);
     auto status = _register_new_track(name, track);
     if (status != EngineReturnStatus::OK)
     {
@@ -623,16 +844,11 @@ EngineReturnStatus AudioEngine::delete_track(ObjectId track_id)
 
     if (realtime())
     {
-        auto remove_event = RtEvent::make_remove_track_event(track->id());
-        auto delete_event = RtEvent::make_remove_processor_event(track->id());
-        _send_control_event(remove_event);
-        _send_control_event(delete_event);
-        bool removed = _event_receiver.wait_for_response(remove_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        bool deleted = _event_receiver.wait_for_response(delete_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (!removed || !deleted)
+        _send_graph_events({RtEvent::make_remove_track_event(track->id()),
+                            RtEvent::make_remove_processor_event(track->id())}, [track]()
         {
             ELKLOG_LOG_ERROR("Failed to remove processor {} from processing part", track->name());
-        }
+        });
     }
     else
     {
@@ -640,7 +856,7 @@ EngineReturnStatus AudioEngine::delete_track(ObjectId track_id)
         [[maybe_unused]] bool removed = _remove_processor_from_realtime_part(track->id());
         ELKLOG_LOG_WARNING_IF(removed == false, "Plugin track {} was not in the audio graph", track_id)
     }
-    track->set_enabled(false);
+    _after_graph_changes([track]() {track->set_enabled(false);});
     _processors.remove_track(track->id());
     _deregister_processor(track.get());
 
@@ -671,13 +887,13 @@ std::pair<EngineReturnStatus, ObjectId> AudioEngine::create_processor(const Plug
     if (this->realtime())
     {
         // In realtime mode we need to handle this in the audio thread
-        auto insert_event = RtEvent::make_insert_processor_event(processor.get());
-        _send_control_event(insert_event);
-        bool inserted = _event_receiver.wait_for_response(insert_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (!inserted)
+        bool inserted = _send_graph_events({RtEvent::make_insert_processor_event(processor.get())}, [this, processor]()
         {
-            ELKLOG_LOG_ERROR("Failed to insert processor {} to processing part", processor_name);
+            ELKLOG_LOG_ERROR("Failed to insert processor {} to processing part", processor->name());
             _deregister_processor(processor.get());
+        });
+        if (!inserted)
+        {
             return {EngineReturnStatus::INVALID_PROCESSOR, ObjectId(0)};
         }
     }
@@ -714,7 +930,7 @@ EngineReturnStatus AudioEngine::add_plugin_to_track(ObjectId plugin_id,
         return EngineReturnStatus::INVALID_PLUGIN;
     }
 
-    if (plugin->active_rt_processing())
+    if (_on_track(*plugin))
     {
         ELKLOG_LOG_ERROR("Plugin {} is already active on a track", plugin_id);
         return EngineReturnStatus::ERROR;
@@ -728,18 +944,22 @@ EngineReturnStatus AudioEngine::add_plugin_to_track(ObjectId plugin_id,
     if (this->realtime())
     {
         // In realtime mode we need to handle this in the audio thread
-        RtEvent add_event = RtEvent::make_add_processor_to_track_event(plugin_id, track_id, before_plugin_id);
-        _send_control_event(add_event);
-        bool added = _event_receiver.wait_for_response(add_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (added == false)
+        bool added = _send_graph_events({RtEvent::make_add_processor_to_track_event(plugin_id, track_id, before_plugin_id)},
+                                        [this, plugin, track]()
         {
             ELKLOG_LOG_ERROR("Failed to add processor {} to track {}", plugin->name(), track->name());
+            // Only in the engine's mirror if added in a graph transaction
+            _processors.remove_from_track(plugin->id(), track->id());
+        });
+        if (added == false)
+        {
             return EngineReturnStatus::ERROR;
         }
     }
     else
     {
         // If the engine is not running in realtime mode we can add the processor directly
+        _realtime_processors.prepare_insert();
         _insert_processor_in_realtime_part(plugin.get());
         bool added = track->add(plugin.get(), before_plugin_id);
         if (added == false)
@@ -774,11 +994,12 @@ EngineReturnStatus AudioEngine::remove_plugin_from_track(ObjectId plugin_id, Obj
     if (realtime())
     {
         // Send events to handle this in the rt domain
-        auto remove_event = RtEvent::make_remove_processor_from_track_event(plugin_id, track_id);
-        _send_control_event(remove_event);
-        if (!_event_receiver.wait_for_response(remove_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT))
+        bool removed = _send_graph_events({RtEvent::make_remove_processor_from_track_event(plugin_id, track_id)}, [plugin, track]()
+        {
+            ELKLOG_LOG_ERROR("Failed to remove/delete processor {} in rt from track {}", plugin->id(), track->id());
+        });
+        if (!removed)
         {
-            ELKLOG_LOG_ERROR("Failed to remove/delete processor {} in rt from track {}", plugin_id, track_id);
             return EngineReturnStatus::ERROR;
         }
     }
@@ -791,7 +1012,7 @@ EngineReturnStatus AudioEngine::remove_plugin_from_track(ObjectId plugin_id, Obj
         }
     }
 
-    plugin->set_enabled(false);
+    _after_graph_changes([plugin]() {plugin->set_enabled(false);});
 
     bool removed = _processors.remove_from_track(plugin_id, track_id);
     if (removed)
@@ -813,7 +1034,7 @@ EngineReturnStatus AudioEngine::delete_plugin(ObjectId plugin_id)
     {
         return EngineReturnStatus::INVALID_PLUGIN;
     }
-    if (processor->active_rt_processing())
+    if (_on_track(*processor))
     {
         ELKLOG_LOG_ERROR("Cannot delete processor {}, active on track", processor->name());
         return EngineReturnStatus::ERROR;
@@ -821,10 +1042,12 @@ EngineReturnStatus AudioEngine::delete_plugin(ObjectId plugin_id)
     if (realtime())
     {
         // Send events to handle this in the rt domain
-        auto delete_event = RtEvent::make_remove_processor_event(processor->id());
-        _send_control_event(delete_event);
-        [[maybe_unused]] bool delete_ok = _event_receiver.wait_for_response(delete_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        ELKLOG_LOG_ERROR_IF(delete_ok == false, "Failed to remove/delete processor {} from processing part", plugin_id)
+        _send_graph_events({RtEvent::make_remove_processor_event(processor->id())}, [processor]()
+        {
+            ELKLOG_LOG_ERROR("Failed to remove/delete processor {} from processing part", processor->id());
+        });
+        // Keep the processor alive until it's been removed from the realtime part
+        _after_graph_changes([processor]() {});
     }
     else
     {
@@ -856,15 +1079,13 @@ EngineReturnStatus AudioEngine::_register_new_track(const std::string& name, std
 
     if (realtime())
     {
-        auto insert_event = RtEvent::make_insert_processor_event(track.get());
-        auto add_event = RtEvent::make_add_track_event(track->id());
-        _send_control_event(insert_event);
-        _send_control_event(add_event);
-        bool inserted = _event_receiver.wait_for_response(insert_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        bool added = _event_receiver.wait_for_response(add_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (!inserted || !added)
+        bool added = _send_graph_events({RtEvent::make_insert_processor_event(track.get()),
+                                         RtEvent::make_add_track_event(track->id())}, [track]()
+        {
+            ELKLOG_LOG_ERROR("Failed to insert/add track {} to processing part", track->name());
+        });
+        if (!added)
         {
-            ELKLOG_LOG_ERROR("Failed to insert/add track {} to processing part", name);
             return EngineReturnStatus::INVALID_PROCESSOR;
         }
     }
@@ -901,7 +1122,7 @@ EngineReturnStatus AudioEngine::_register_new_track(const std::string& name, std
 
 std::pair<EngineReturnStatus, ObjectId> AudioEngine::_create_master_track(const std::string& name, TrackType type, int channels)
 {
-    auto track = std::make_shared<Track>(_host_control, channels, &_process_timer, false, type);
+    auto track = std::make_shared<Track>(_host_control, channels, &_process_timer, false, type, _buffer_arena);
     auto status = _register_new_track(name, track);
     if (status != EngineReturnStatus::OK)
     {
@@ -956,15 +1177,12 @@ EngineReturnStatus AudioEngine::_connect_audio_channel(int engine_channel,
 
     if (added && realtime)
     {
-        auto event = direction == Direction::INPUT ? RtEvent::make_add_audio_input_connection_event(con) :
-                                                     RtEvent::make_add_audio_output_connection_event(con);
-        _send_control_event(event);
-        added = _event_receiver.wait_for_response(event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (added == false)
+        _send_graph_events({direction == Direction::INPUT ? RtEvent::make_add_audio_input_connection_event(con) :
+                                                            RtEvent::make_add_audio_output_connection_event(con)}, [&storage, con]()
         {
             storage.remove(con, false);
             ELKLOG_LOG_ERROR("Failed to insert audio connection in realtime thread");
-        }
+        });
     }
     else if (added == false)
     {
@@ -972,6 +1190,7 @@ EngineReturnStatus AudioEngine::_connect_audio_channel(int engine_channel,
         return EngineReturnStatus::ERROR;
     }
 
+    _audio_routing_changed = true;
     ELKLOG_LOG_INFO("Connected engine {} {} to channel {} of track \"{}\"",
                         direction == Direction::INPUT ? "input" : "output", engine_channel, track_channel, track_id);
     return EngineReturnStatus::OK;
@@ -996,11 +1215,11 @@ EngineReturnStatus AudioEngine::_disconnect_audio_channel(int engine_channel,
 
     if (removed && realtime)
     {
-        auto event = direction == Direction::INPUT ? RtEvent::make_remove_audio_input_connection_event(con) :
-                                                     RtEvent::make_remove_audio_output_connection_event(con);
-        _send_control_event(event);
-        removed = _event_receiver.wait_for_response(event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        ELKLOG_LOG_ERROR_IF(removed == false, "Failed to remove audio connection in realtime thread")
+        _send_graph_events({direction == Direction::INPUT ? RtEvent::make_remove_audio_input_connection_event(con) :
+                                                            RtEvent::make_remove_audio_output_connection_event(con)}, []()
+        {
+            ELKLOG_LOG_ERROR("Failed to remove audio connection in realtime thread");
+        });
     }
     else if (removed == false)
     {
@@ -1008,11 +1227,36 @@ EngineReturnStatus AudioEngine::_disconnect_audio_channel(int engine_channel,
         return EngineReturnStatus::ERROR;
     }
 
+    _audio_routing_changed = true;
     ELKLOG_LOG_INFO("Removed {} audio connection from channel {} of track \"{}\" and engine channel {}",
                          direction == Direction::INPUT ? "input" : "output", track_channel, track->name(), engine_channel);
     return EngineReturnStatus::OK;
 }
 
+void AudioEngine::_apply_master_limiter(ChunkSampleBuffer& buffer)
+{
+    _master_limiter_buffer = &buffer;
+    if (_master_limiter_multicore)
+    {
+        _audio_graph.run_on_all_cores(_master_limiter_core_callback, this);
+    }
+    else
+    {
+        _master_limiter_core_callback(this, 0, 1);
+    }
+}
+
+void AudioEngine::_master_limiter_core_callback(void* data, int core, int cores)
+{
+    auto engine = reinterpret_cast<AudioEngine*>(data);
+    auto& buffer = *engine->_master_limiter_buffer;
+    int channels = std::min(buffer.channel_count(), static_cast<int>(engine->_master_limiters.size()));
+    for (int c = channels * core / cores; c < channels * (core + 1) / cores; c++)
+    {
+        engine->_master_limiters[c].process(buffer.channel(c), buffer.channel(c));
+    }
+}
+
 void AudioEngine::_process_internal_rt_events()
 {
     RtEvent event;
@@ -1028,79 +1272,113 @@ void AudioEngine::_process_internal_rt_events()
                 _transport.process_event(event);
                 break;
             }
-            case RtEventType::INSERT_PROCESSOR:
-            {
-                auto typed_event = event.processor_operation_event();
-                bool inserted = _insert_processor_in_realtime_part(typed_event->instance());
-                typed_event->set_handled(inserted);
-                break;
-            }
-            case RtEventType::REMOVE_PROCESSOR:
-            {
-                auto typed_event = event.processor_reorder_event();
-                bool removed = _remove_processor_from_realtime_part(typed_event->processor());
-                typed_event->set_handled(removed);
-                break;
-            }
-            case RtEventType::ADD_PROCESSOR_TO_TRACK:
-            {
-                auto typed_event = event.processor_reorder_event();
-                auto track = static_cast<Track*>(_realtime_processors[typed_event->track()]);
-                auto processor = static_cast<Processor*>(_realtime_processors[typed_event->processor()]);
-                bool added = false;
-                if (track && processor)
-                {
-                    added = track->add(processor, typed_event->before_processor());
-                }
-                typed_event->set_handled(added);
-                break;
-            }
-            case RtEventType::REMOVE_PROCESSOR_FROM_TRACK:
+            case RtEventType::GRAPH_TRANSACTION:
             {
-                auto typed_event = event.processor_reorder_event();
-                auto track = static_cast<Track*>(_realtime_processors[typed_event->track()]);
-                bool removed = false;
-                if (track)
+                // All changes in the transaction are applied before the next chunk is processed
+                auto typed_event = event.graph_transaction_event();
+                for (auto& graph_event : typed_event->transaction()->events)
                 {
-                    removed = track->remove(typed_event->processor());
+                    _process_graph_event(graph_event);
                 }
-                typed_event->set_handled(removed);
+                typed_event->set_handled(true);
+                _release_graph_transaction(typed_event->transaction());
                 break;
             }
-            case RtEventType::ADD_TRACK:
-            {
-                auto typed_event = event.processor_reorder_event();
-                auto track = static_cast<Track*>(_realtime_processors[typed_event->track()]);
-                typed_event->set_handled(track ? _add_track(track) : false);
-                break;
-            }
-            case RtEventType::REMOVE_TRACK:
-            {
-                auto typed_event = event.processor_reorder_event();
-                auto track = static_cast<Track*>(_realtime_processors[typed_event->track()]);
-                typed_event->set_handled(track ? _remove_track(track) : false);
-                break;
-            }
-            case RtEventType::ADD_AUDIO_CONNECTION:
+            default:
+                _process_graph_event(event);
+        }
+        if (is_returnable_event(event))
+        {
+            _event_receiver.notify_response(event); // Wake up the non-rt thread waiting for the event
+        }
+    }
+}
+
+void AudioEngine::_process_graph_event(RtEvent& event)
+{
+    switch (event.type())
+    {
+        case RtEventType::INSERT_PROCESSOR:
+        {
+            auto typed_event = event.processor_operation_event();
+            bool inserted = _insert_processor_in_realtime_part(typed_event->instance());
+            typed_event->set_handled(inserted);
+            break;
+        }
+        case RtEventType::REMOVE_PROCESSOR:
+        {
+            auto typed_event = event.processor_reorder_event();
+            bool removed = _remove_processor_from_realtime_part(typed_event->processor());
+            typed_event->set_handled(removed);
+            break;
+        }
+        case RtEventType::ADD_PROCESSOR_TO_TRACK:
+        {
+            auto typed_event = event.processor_reorder_event();
+            auto track = static_cast<Track*>(_realtime_processors.find(typed_event->track()));
+            auto processor = _realtime_processors.find(typed_event->processor());
+            bool added = false;
+            if (track && processor)
             {
-                auto typed_event = event.audio_connection_event();
-                assert(_realtime_processors[typed_event->connection().track]);
-                auto& storage = typed_event->input_connection() ? _audio_in_connections : _audio_out_connections;
-                typed_event->set_handled(storage.add_rt(typed_event->connection()));
-                break;
+                added = track->add(processor, typed_event->before_processor());
             }
-            case RtEventType::REMOVE_AUDIO_CONNECTION:
+            typed_event->set_handled(added);
+            break;
+        }
+        case RtEventType::REMOVE_PROCESSOR_FROM_TRACK:
+        {
+            auto typed_event = event.processor_reorder_event();
+            auto track = static_cast<Track*>(_realtime_processors.find(typed_event->track()));
+            bool removed = false;
+            if (track)
             {
-                auto typed_event = event.audio_connection_event();
-                auto& storage = typed_event->input_connection() ? _audio_in_connections : _audio_out_connections;
-                typed_event->set_handled(storage.remove_rt(typed_event->connection()));
-                break;
+                removed = track->remove(typed_event->processor());
             }
-
-            default:
-                break;
+            typed_event->set_handled(removed);
+            break;
         }
-        _control_queue_out.push(event); // Send event back to non-rt domain
+        case RtEventType::ADD_TRACK:
+        {
+            auto typed_event = event.processor_reorder_event();
+            auto track = static_cast<Track*>(_realtime_processors.find(typed_event->track()));
+            typed_event->set_handled(track ? _add_track(track) : false);
+            break;
+        }
+        case RtEventType::REMOVE_TRACK:
+        {
+            auto typed_event = event.processor_reorder_event();
+            auto track = static_cast<Track*>(_realtime_processors.find(typed_event->track()));
+            typed_event->set_handled(track ? _remove_track(track) : false);
+            break;
+        }
+        case RtEventType::ADD_AUDIO_CONNECTION:
+        {
+            auto typed_event = event.audio_connection_event();
+            assert(_realtime_processors.find(typed_event->connection().track));
+            auto& storage = typed_event->input_connection() ? _audio_in_connections : _audio_out_connections;
+            typed_event->set_handled(storage.add_rt(typed_event->connection()));
+            _audio_routing_changed = true;
+            break;
+        }
+        case RtEventType::REMOVE_AUDIO_CONNECTION:
+        {
+            auto typed_event = event.audio_connection_event();
+            auto& storage = typed_event->input_connection() ? _audio_in_connections : _audio_out_connections;
+            typed_event->set_handled(storage.remove_rt(typed_event->connection()));
+            _audio_routing_changed = true;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void AudioEngine::_release_graph_transaction(GraphTransaction* transaction)
+{
+    if (transaction->state.exchange(GraphTransaction::State::DONE) == GraphTransaction::State::ABANDONED)
+    {
+        _reclaimer.retire(transaction);
     }
 }
 
@@ -1113,12 +1391,28 @@ void AudioEngine::_send_rt_events_to_processors()
     }
 }
 
+void AudioEngine::_send_timed_rt_events_to_processors()
+{
+    while (_has_pending_timed_event || _timed_in_queue.pop(_pending_timed_event))
+    {
+        auto [send_now, sample_offset] = _rt_event_timer.sample_offset_from_realtime(_pending_timed_event.timestamp);
+        if (send_now == false)
+        {
+            // Keep the order of events by not looking further until this one is due
+            _has_pending_timed_event = true;
+            break;
+        }
+        _pending_timed_event.event.set_sample_offset(sample_offset);
+        _send_rt_event(_pending_timed_event.event);
+        _has_pending_timed_event = false;
+    }
+}
+
 void AudioEngine::_send_rt_event(const RtEvent& event)
 {
-    if (event.processor_id() < _realtime_processors.size() &&
-        _realtime_processors[event.processor_id()] != nullptr)
+    if (auto processor = _realtime_processors.find(event.processor_id()); processor != nullptr)
     {
-        _realtime_processors[event.processor_id()]->process_event(event);
+        processor->process_event(event);
     }
 }
 
@@ -1152,6 +1446,20 @@ void AudioEngine::_retrieve_events_from_output_pipe(RtEventFifo<>& pipe, Control
                 break;
             }
 
+            case RtEventType::ASYNC_WORK:
+            {
+                if (_async_work_executor)
+                {
+                    // Work that can't be queued right away is kept and retried by the executor
+                    _async_work_executor->push_rt(event);
+                }
+                else
+                {
+                    _main_out_queue.push(event);
+                }
+                break;
+            }
+
             default:
                 _main_out_queue.push(event);
         }
@@ -1161,25 +1469,117 @@ void AudioEngine::_retrieve_events_from_output_pipe(RtEventFifo<>& pipe, Control
 
 void AudioEngine::_copy_audio_to_tracks(ChunkSampleBuffer* input)
 {
-    for (const auto& c : _audio_in_connections.connections_rt())
+    for (const auto& alias : _input_aliases)
+    {
+        alias.track->set_input_alias(ChunkSampleBuffer::create_non_owning_buffer(*input, alias.engine_channel, alias.channels));
+    }
+    for (const auto& c : _input_copies)
     {
         auto engine_in = ChunkSampleBuffer::create_non_owning_buffer(*input, c.engine_channel, 1);
-        auto track_in = static_cast<Track*>(_realtime_processors[c.track])->input_channel(c.track_channel);
+        auto track_in = c.track->input_channel(c.track_channel);
         track_in = engine_in;
     }
 }
 
 void AudioEngine::_copy_audio_from_tracks(ChunkSampleBuffer* output)
 {
-    output->clear();
-    for (const auto& c : _audio_out_connections.connections_rt())
+    /* Tracks in the audio graph are mixed to the output when rendered, this only
+     * handles the connections that could not be set as output routes on the tracks */
+    for (const auto& c : _output_copies)
     {
-        auto track_out = static_cast<Track*>(_realtime_processors[c.track])->output_channel(c.track_channel);
+        auto track_out = c.track->output_channel(c.track_channel);
         auto engine_out = ChunkSampleBuffer::create_non_owning_buffer(*output, c.engine_channel, 1);
         engine_out.add(track_out);
     }
 }
 
+void AudioEngine::_update_audio_routing()
+{
+    for (const auto& alias : _input_aliases)
+    {
+        alias.track->clear_input_alias();
+    }
+    for (auto track : _output_routed_tracks)
+    {
+        track->clear_output_routes();
+    }
+    _input_aliases.clear();
+    _input_copies.clear();
+    _output_copies.clear();
+    _output_routed_tracks.clear();
+
+    const auto& inputs = _audio_in_connections.connections_rt();
+    for (auto i = inputs.begin(); i != inputs.end(); ++i)
+    {
+        // All input connections of a track are handled together, at its first connection
+        auto track = static_cast<Track*>(_realtime_processors.find(i->track));
+        if (track == nullptr || std::any_of(inputs.begin(), i, [&](const auto& c) {return c.track == i->track;}))
+        {
+            continue;
+        }
+
+        int channels = track->input_buffer_channels();
+        int first_channel = i->engine_channel - i->track_channel;
+        bool one_to_one = first_channel >= 0 && first_channel + channels <= _audio_inputs;
+        int connected = 0;
+        uint32_t connected_mask = 0;
+        for (auto j = i; j != inputs.end(); ++j)
+        {
+            if (j->track == i->track)
+            {
+                connected++;
+                connected_mask |= 1u << j->track_channel;
+                one_to_one &= j->engine_channel - j->track_channel == first_channel;
+            }
+        }
+
+        if (one_to_one && connected == channels && connected_mask == (1u << channels) - 1)
+        {
+            _input_aliases.push_back({track, first_channel, channels});
+            continue;
+        }
+        for (auto j = i; j != inputs.end(); ++j)
+        {
+            if (j->track == i->track)
+            {
+                _input_copies.push_back({track, j->engine_channel, j->track_channel});
+            }
+        }
+    }
+
+    for (const auto& c : _audio_out_connections.connections_rt())
+    {
+        auto track = static_cast<Track*>(_realtime_processors.find(c.track));
+        if (track == nullptr)
+        {
+            continue;
+        }
+        // Only tracks rendered by the audio graph are mixed by it
+        if (track->type() == TrackType::REGULAR && track->add_output_route(c.track_channel, c.engine_channel))
+        {
+            if (std::find(_output_routed_tracks.begin(), _output_routed_tracks.end(), track) == _output_routed_tracks.end())
+            {
+                _output_routed_tracks.push_back(track);
+            }
+        }
+        else
+        {
+            _output_copies.push_back({track, c.engine_channel, c.track_channel});
+        }
+    }
+}
+
+void AudioEngine::_remove_audio_routing(Track* track)
+{
+    auto refers_to_track = [track](const auto& route) {return route.track == track;};
+    _input_aliases.erase(std::remove_if(_input_aliases.begin(), _input_aliases.end(), refers_to_track), _input_aliases.end());
+    _input_copies.erase(std::remove_if(_input_copies.begin(), _input_copies.end(), refers_to_track), _input_copies.end());
+    _output_copies.erase(std::remove_if(_output_copies.begin(), _output_copies.end(), refers_to_track), _output_copies.end());
+    _output_routed_tracks.erase(std::remove(_output_routed_tracks.begin(), _output_routed_tracks.end(), track),
+                                _output_routed_tracks.end());
+    _audio_routing_changed = true;
+}
+
 void AudioEngine::update_timings()
 {
     if (_process_timer.enabled())
@@ -1199,15 +1599,17 @@ void AudioEngine::update_timings()
                 auto timings = _process_timer.timings_for_node(id);
                 if (timings.has_value())
                 {
-                    ELKLOG_LOG_INFO("Processor: {} ({}), avg: {}%, min: {}%, max: {}%", id, processor->name(),
-                                    timings->avg_case * 100.0f, timings->min_case * 100.0f, timings->max_case * 100.0f);
+                    ELKLOG_LOG_INFO("Processor: {} ({}), avg: {}%, min: {}%, max: {}%, p99: {}%, overruns: {}", id, processor->name(),
+                                    timings->avg_case * 100.0f, timings->min_case * 100.0f, timings->max_case * 100.0f,
+                                    timings->p99_case * 100.0f, timings->overruns);
                 }
             }
 
             if (engine_timings.has_value())
             {
-                ELKLOG_LOG_INFO("Engine total: avg: {}%, min: {}%, max: {}%",
-                                engine_timings->avg_case * 100.0f, engine_timings->min_case * 100.0f, engine_timings->max_case * 100.0f);
+                ELKLOG_LOG_INFO("Engine total: avg: {}%, min: {}%, max: {}%, p99: {}%, overruns: {}",
+                                engine_timings->avg_case * 100.0f, engine_timings->min_case * 100.0f, engine_timings->max_case * 100.0f,
+                                engine_timings->p99_case * 100.0f, engine_timings->overruns);
             }
             _log_timing_print_counter = 0;
         }
@@ -1224,7 +1626,12 @@ void AudioEngine::notify_interrupted_audio(Time interrupt_time)
         ELKLOG_LOG_INFO("Rt thread timed out for too long, clearing queues");
         RtEvent event;
         while (_control_queue_in.pop(event))
-        {}
+        {
+            if (event.type() == RtEventType::GRAPH_TRANSACTION)
+            {
+                _release_graph_transaction(event.graph_transaction_event()->transaction());
+            }
+        }
         while (_main_in_queue.pop(event))
         {}
     }
@@ -1237,7 +1644,9 @@ void print_single_timings_for_node(std::fstream& f, performance::PerformanceTime
     {
         f << std::setw(16) << timings.value().avg_case * 100.0
           << std::setw(16) << timings.value().min_case * 100.0
-          << std::setw(16) << timings.value().max_case * 100.0 << "\n";
+          << std::setw(16) << timings.value().max_case * 100.0
+          << std::setw(16) << timings.value().p99_case * 100.0
+          << std::setw(16) << timings.value().overruns << "\n";
     }
 }
 
@@ -1272,6 +1681,7 @@ bool AudioEngine::_add_track(Track* track)
 
 bool AudioEngine::_remove_track(Track* track)
 {
+    _remove_audio_routing(track);
     bool removed = false;
     switch (track->type())
     {
@@ -1309,7 +1719,7 @@ void AudioEngine::print_timings_to_file(const std::string& filename)
     file.setf(std::ios::left);
     file << "Performance timings for all processors in percentages of audio buffer (100% = "<< 1000000.0 / _sample_rate * AUDIO_CHUNK_SIZE
          << "us)\n\n" << std::setw(24) << "" << std::setw(16) << "average(%)" << std::setw(16) << "minimum(%)"
-         << std::setw(16) << "maximum(%)" << std::endl;
+         << std::setw(16) << "maximum(%)" << std::setw(16) << "p99(%)" << std::setw(16) << "overruns" << std::endl;
 
     for (const auto& track : _processors.all_tracks())
     {
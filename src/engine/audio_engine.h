@@ -21,9 +21,12 @@
 #ifndef SUSHI_ENGINE_H
 #define SUSHI_ENGINE_H
 
+#include <atomic>
+#include <functional>
 #include <vector>
 #include <utility>
 #include <mutex>
+#include <thread>
 
 #include "twine/twine.h"
 
@@ -33,15 +36,21 @@
 
 #include "dsp_library/master_limiter.h"
 
+#include "engine/async_work_executor.h"
 #include "engine/audio_graph.h"
+#include "engine/buffer_arena.h"
 #include "engine/base_engine.h"
 #include "engine/connection_storage.h"
 #include "engine/controller/controller.h"
+#include "engine/deferred_reclaimer.h"
 #include "engine/event_dispatcher.h"
+#include "engine/event_timer.h"
 #include "engine/host_control.h"
 #include "engine/plugin_library.h"
 #include "engine/processor_container.h"
 #include "engine/receiver.h"
+#include "engine/rt_processor_table.h"
+#include "engine/telemetry_publisher.h"
 #include "engine/track.h"
 #include "engine/transport.h"
 
@@ -79,7 +88,31 @@ private:
     std::vector<unsigned int> _output_clip_count;
 };
 
-constexpr int MAX_RT_PROCESSOR_ID = 100000;
+/**
+ * @brief Graph changes collected between AudioEngine::begin_graph_transaction() and
+ *        AudioEngine::commit_graph_transaction(). Owned by the committing thread, unless
+ *        it stops waiting for the audio thread, then the audio thread retires it when done.
+ */
+struct GraphTransaction : public RtDeletable
+{
+    enum class State
+    {
+        PENDING,
+        DONE,
+        ABANDONED
+    };
+
+    struct Change
+    {
+        size_t events_end; // One past the last event of the change
+        std::function<void()> on_failure;
+    };
+
+    std::vector<RtEvent> events;
+    std::vector<Change> changes;
+    std::vector<std::function<void()>> completion_actions;
+    std::atomic<State> state{State::PENDING};
+};
 
 class AudioEngineAccessor;
 
@@ -100,12 +133,14 @@ public:
      *                      multicore mode.
      * @param event_dispatcher A pointer to a BaseEventDispatcher instance, which AudioEngine takes over ownership of.
      *                         If nullptr, a normal EventDispatcher is created and used.
+     * @param scheduling How tracks are distributed between cpu cores when rt_cpu_cores > 1.
      */
     explicit AudioEngine(float sample_rate,
                          int rt_cpu_cores = 1,
                          std::optional<std::string> device_name = std::nullopt,
                          bool debug_mode_sw = false,
-                         dispatcher::BaseEventDispatcher* event_dispatcher = nullptr);
+                         dispatcher::BaseEventDispatcher* event_dispatcher = nullptr,
+                         SchedulingMode scheduling = SchedulingMode::ROUND_ROBIN);
 
      ~AudioEngine() override;
 
@@ -349,6 +384,36 @@ public:
         _plugin_library.set_base_plugin_path(path);
     }
 
+    /**
+     * @brief Use a persistent index of installed plugins to speed up plugin loading.
+     *        Must be called before any plugins are loaded.
+     *
+     * @param path Path of the index file, created if it does not exist
+     */
+    void set_plugin_index_file(const std::string& path)
+    {
+        _plugin_registry.set_plugin_index_file(path);
+    }
+
+    /**
+     * @brief Execute asynchronous work requested by processors on a dedicated pool of
+     *        threads, instead of on the event dispatcher's worker thread. Must be called
+     *        before the engine is started.
+     *
+     * @param threads The number of threads to execute work on
+     */
+    void enable_async_work_executor(int threads);
+
+    /**
+     * @brief Publish meter levels, clip counts, transport position and track timings
+     *        to a memory mapped file at the end of every audio period. Must be called
+     *        before the engine is started.
+     *
+     * @param path Path of the file, created if it does not exist
+     * @return true if the file could be created and mapped, false otherwise
+     */
+    bool enable_telemetry(const std::string& path);
+
     /**
      * @brief Send an RtEvent to a processor directly to the realtime thread. Should normally only be used
      *        from an rt thread or in a context where the engine is not running in realtime mode.
@@ -357,6 +422,18 @@ public:
      */
     EngineReturnStatus send_rt_event_to_processor(const RtEvent& event) override;
 
+    /**
+     * @brief Send an RtEvent to a processor in the realtime thread, without going through the
+     *        event dispatcher. The sample offset of the event is calculated from timestamp
+     *        when it is received, in the same way as for events from the event dispatcher.
+     *        Lock free and safe to call from several threads concurrently.
+     * @param event The event to process
+     * @param timestamp The real time at which the event should take effect
+     * @return EngineReturnStatus::OK if the event was queued, EngineReturnStatus::QUEUE_FULL
+     *         if there was no space left in the queue
+     */
+    EngineReturnStatus send_timed_rt_event(const RtEvent& event, Time timestamp) override;
+
     /**
      * @brief Create an empty track
      * @param name The unique name of the track to be created.
@@ -423,6 +500,29 @@ public:
      */
     EngineReturnStatus delete_plugin(ObjectId plugin_id) override;
 
+    /**
+     * @brief Start collecting graph changes into a transaction. Until the transaction is
+     *        committed, track and processor creation, deletion and reordering and audio
+     *        connection changes made from the calling thread are not sent to the audio thread
+     *        one by one, but are queued and applied together in the same audio period when
+     *        commit_graph_transaction() is called. Changes made while the engine is not
+     *        running in realtime mode are applied directly as usual. The realtime mode of the
+     *        engine must not be changed while a transaction is open.
+     * @return EngineReturnStatus::OK if successful, EngineReturnStatus::ERROR if a transaction
+     *         is already open
+     */
+    EngineReturnStatus begin_graph_transaction() override;
+
+    /**
+     * @brief Apply all graph changes collected since begin_graph_transaction() in the
+     *        audio thread and wait for them to be completed. The calls that made the changes
+     *        could not know if they would succeed, so any changes that failed are logged and
+     *        cleaned up here instead.
+     * @return EngineReturnStatus::OK if all changes were applied successfully, different
+     *         error code otherwise
+     */
+    EngineReturnStatus commit_graph_transaction() override;
+
     /**
      * @brief Enable audio clip detection on engine inputs
      * @param enabled Enable if true, disable if false
@@ -477,6 +577,26 @@ public:
         return _master_limiter_enabled;
     }
 
+    /**
+     * @brief Run the master limiter on all cores used for audio processing, with every
+     *        core processing a group of output channels. Only has an effect when running
+     *        on multiple cores.
+     * @param enabled Enabled if true, disable if false
+     */
+    void enable_multicore_master_limiter(bool enabled) override
+    {
+        _master_limiter_multicore = enabled;
+    }
+
+    /**
+     * @brief Return whether the master limiter is run on all cores used for audio processing
+     * @param true if enabled, false if disabled.
+     */
+    bool multicore_master_limiter() const override
+    {
+        return _master_limiter_multicore;
+    }
+
     dispatcher::BaseEventDispatcher* event_dispatcher() override
     {
         return _event_dispatcher.get();
@@ -570,6 +690,46 @@ private:
 
     EngineReturnStatus _send_control_event(RtEvent& event);
 
+    /**
+     * @brief Called from a non-realtime thread to apply graph changes in the realtime thread.
+     *        If a graph transaction is open the events are added to it, otherwise they are
+     *        sent to the realtime thread and waited for.
+     * @param events The graph change events to process
+     * @param on_failure Called if any of the events fails. If a graph transaction is open,
+     *        this happens when the transaction is committed.
+     * @return true if all events were processed successfully or added to a transaction
+     */
+    bool _send_graph_events(std::initializer_list<RtEvent> events, std::function<void()> on_failure = nullptr);
+
+    /**
+     * @brief Run a function once the graph changes made so far have been applied in the
+     *        realtime thread, i.e. directly if no graph transaction is open, otherwise when
+     *        the transaction has been committed.
+     * @param action The function to run
+     */
+    void _after_graph_changes(std::function<void()> action);
+
+    bool _graph_transaction_open() const
+    {
+        return _graph_transaction_thread.load() == std::this_thread::get_id();
+    }
+
+    void _process_graph_event(RtEvent& event);
+
+    /**
+     * @brief Called from the realtime thread when it is done with a graph transaction,
+     *        applied or not. Retires it if the committing thread has stopped waiting for it.
+     */
+    void _release_graph_transaction(GraphTransaction* transaction);
+
+    /**
+     * @brief Check if a processor is on a track, taking changes in an open graph transaction
+     *        into account.
+     * @param processor The processor to check
+     * @return true if the processor is, or will be when the transaction is committed, on a track
+     */
+    bool _on_track(const Processor& processor) const;
+
     EngineReturnStatus _connect_audio_channel(int engine_channel, int track_channel, ObjectId track_id, Direction direction);
 
     EngineReturnStatus _disconnect_audio_channel(int engine_channel, int track_channel, ObjectId track_id, Direction direction);
@@ -578,6 +738,8 @@ private:
 
     void _send_rt_events_to_processors();
 
+    void _send_timed_rt_events_to_processors();
+
     void _send_rt_event(const RtEvent& event);
 
     inline void _retrieve_events_from_tracks(ControlBuffer& buffer);
@@ -588,6 +750,29 @@ private:
 
     inline void _copy_audio_from_tracks(ChunkSampleBuffer* output);
 
+    /**
+     * @brief Rebuild the rt representation of the audio connections. Tracks whose inputs
+     *        are all connected 1:1 to consecutive engine inputs read them directly instead
+     *        of getting them copied, and output connections of tracks in the audio graph
+     *        are set as output routes on the tracks, so that they are mixed by the graph.
+     *        Called from the rt thread, or when not running.
+     */
+    void _update_audio_routing();
+
+    /**
+     * @brief Remove all references to a track from the rt representation of the audio
+     *        connections, called when the track is removed.
+     */
+    void _remove_audio_routing(Track* track);
+
+    /**
+     * @brief Apply the master limiters to all channels of buffer, split in groups of
+     *        channels processed in parallel on the audio graph's cores if enabled.
+     */
+    void _apply_master_limiter(ChunkSampleBuffer& buffer);
+
+    static void _master_limiter_core_callback(void* data, int core, int cores);
+
     /**
      * @brief Add a track to the audio engine, if engine is running, this must be called from the
      *        rt thread before/after processing. If not running, then this function can safely be
@@ -612,12 +797,21 @@ private:
 
     std::unique_ptr<dispatcher::BaseEventDispatcher> _event_dispatcher;
 
+    // Backing storage for the audio buffers of all tracks and the engine swap buffers
+    std::shared_ptr<BufferArena> _buffer_arena;
+
+    // Deletes objects retired by processors, declared before them so it outlives them
+    DeferredReclaimer _reclaimer;
+
     PluginRegistry _plugin_registry;
     ProcessorContainer _processors;
 
     // Processors in the realtime part indexed by their unique 32 bit id
     // Only to be accessed from the process callback in rt mode.
-    std::vector<Processor*> _realtime_processors {MAX_RT_PROCESSOR_ID, nullptr};
+    RtProcessorTable        _realtime_processors;
+
+    // Incremented by processors through HostControl when sends or track signal chains change
+    std::atomic<int>        _audio_routing_generation{0};
     AudioGraph              _audio_graph;
 
     Track* _pre_track{nullptr};
@@ -627,6 +821,26 @@ private:
 
     ConnectionStorage<AudioConnection> _audio_in_connections;
     ConnectionStorage<AudioConnection> _audio_out_connections;
+
+    /* The rt representation of the audio connections, rebuilt from the connection storages
+     * with _update_audio_routing() when _audio_routing_changed is set */
+    struct InputAlias
+    {
+        Track* track;
+        int    engine_channel;
+        int    channels;
+    };
+    struct TrackChannelRoute
+    {
+        Track* track;
+        int    engine_channel;
+        int    track_channel;
+    };
+    std::vector<InputAlias>        _input_aliases;
+    std::vector<TrackChannelRoute> _input_copies;
+    std::vector<TrackChannelRoute> _output_copies;
+    std::vector<Track*>            _output_routed_tracks;
+    std::atomic_bool               _audio_routing_changed{true};
     std::vector<CvConnection>    _cv_in_connections;
     std::vector<GateConnection>  _gate_in_connections;
 
@@ -637,15 +851,26 @@ private:
 
     RtSafeRtEventFifo _control_queue_in;
     RtSafeRtEventFifo _main_in_queue;
+    TimedRtEventFifo<> _timed_in_queue;
+    // Popped from _timed_in_queue but not due until a later chunk
+    TimedRtEvent _pending_timed_event;
+    bool _has_pending_timed_event{false};
     RtSafeRtEventFifo _main_out_queue;
-    RtSafeRtEventFifo _control_queue_out;
+    // If not null, asynchronous work is sent here instead of to _main_out_queue
+    std::unique_ptr<AsyncWorkExecutor> _async_work_executor;
+    // If not null, engine state is published here at the end of every chunk
+    std::unique_ptr<TelemetryPublisher> _telemetry;
     std::mutex _in_queue_lock;
     RtEventFifo<> _prepost_event_outputs;
-    receiver::AsynchronousEventReceiver _event_receiver{&_control_queue_out};
+    receiver::AsynchronousEventReceiver _event_receiver;
+
+    // Only accessed from the thread that opened the transaction
+    std::unique_ptr<GraphTransaction> _graph_transaction;
+    std::atomic<std::thread::id> _graph_transaction_thread;
     Transport _transport;
     PluginLibrary _plugin_library;
 
-    HostControl _host_control{nullptr, &_transport, &_plugin_library};
+    HostControl _host_control{nullptr, &_transport, &_plugin_library, &_reclaimer};
 
     performance::PerformanceTimer _process_timer;
     int  _log_timing_print_counter{0};
@@ -653,9 +878,12 @@ private:
     bool _input_clip_detection_enabled{false};
     bool _output_clip_detection_enabled{false};
     ClipDetector _clip_detector;
+    event_timer::EventTimer _rt_event_timer;
 
     bool _master_limiter_enabled{false};
+    bool _master_limiter_multicore{false};
     std::vector<sushi::dsp::MasterLimiter<AUDIO_CHUNK_SIZE>> _master_limiters;
+    ChunkSampleBuffer* _master_limiter_buffer{nullptr};
 };
 
 /**
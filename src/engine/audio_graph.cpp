@@ -19,6 +19,8 @@
  * @Copyright 2017-2023 Elk Audio AB, Stockholm
  */
 
+#include <algorithm>
+
 #include "elklog/static_logger.h"
 
 #include "audio_graph.h"
@@ -29,16 +31,27 @@ ELKLOG_GET_LOGGER_WITH_MODULE_NAME("audio graph");
 
 constexpr bool DISABLE_DENORMALS = true;
 
+/* Measured render times are peak-held and decay slowly, so that tracks with
+ * occasional spikes are still scheduled by their worst case rather than by
+ * their average */
+constexpr float RENDER_TIME_DECAY = 0.995f;
+constexpr int   REBALANCE_INTERVAL = 32;
+constexpr int   MAX_TRACK_CONNECTIONS = 512;
+
 /**
  * Real-time worker thread callback method.
  */
 void external_render_callback(void* data)
 {
-    auto tracks = reinterpret_cast<std::vector<sushi::internal::engine::Track*>*>(data);
-
-    for (auto track : *tracks)
+    auto worker = reinterpret_cast<AudioGraph::CoreWorker*>(data);
+    auto graph = worker->graph;
+    if (graph->_core_function)
+    {
+        graph->_core_function(graph->_core_function_data, worker->core, graph->_cores);
+    }
+    else
     {
-        track->render();
+        graph->_render_core(worker->core);
     }
 }
 
@@ -46,13 +59,45 @@ AudioGraph::AudioGraph(int cpu_cores,
                        int max_no_tracks,
                        [[maybe_unused]] float sample_rate,
                        [[maybe_unused]] std::optional<std::string> device_name,
-                       bool debug_mode_switches) : _audio_graph(cpu_cores),
-                                                   _event_outputs(cpu_cores),
-                                                   _cores(cpu_cores),
-                                                   _current_core(0)
+                       bool debug_mode_switches,
+                       SchedulingMode scheduling,
+                       const std::atomic<int>* audio_routing_generation) : _audio_graph(cpu_cores),
+                                                                           _render_times(cpu_cores),
+                                                                           _track_levels(cpu_cores),
+                                                                           _level_offsets(cpu_cores),
+                                                                           _event_outputs(cpu_cores),
+                                                                           _core_workers(cpu_cores),
+                                                                           _in_degrees(max_no_tracks * cpu_cores, 0),
+                                                                           _core_loads(cpu_cores, 0.0f),
+                                                                           _mix_output(nullptr),
+                                                                           _output_channels(0),
+                                                                           _current_level(0),
+                                                                           _scheduling(cpu_cores > 1 ? scheduling : SchedulingMode::ROUND_ROBIN),
+                                                                           _cores(cpu_cores),
+                                                                           _current_core(0),
+                                                                           _periods_since_rebalance(0),
+                                                                           _levels(0),
+                                                                           _audio_routing_generation(audio_routing_generation),
+                                                                           _routing_generation(_current_routing_generation()),
+                                                                           _topology_changed(true)
 {
     assert(cpu_cores > 0);
 
+    for (int core = 0; core < _cores; ++core)
+    {
+        _core_workers[core].graph = this;
+        _core_workers[core].core = core;
+        _core_workers[core].next_track = 0;
+        _core_workers[core].end_track = 0;
+        _render_times[core].reserve(max_no_tracks);
+        _track_levels[core].reserve(max_no_tracks);
+        // There can never be more levels than there are tracks in total
+        _level_offsets[core].reserve(max_no_tracks * cpu_cores + 1);
+    }
+    _track_buffer.reserve(max_no_tracks * cpu_cores);
+    _ready_tracks.reserve(max_no_tracks * cpu_cores);
+    _connections.reserve(MAX_TRACK_CONNECTIONS);
+
     if (_cores > 1)
     {
         twine::apple::AppleMultiThreadData apple_data {};
@@ -70,10 +115,9 @@ AudioGraph::AudioGraph(int cpu_cores,
                                                              DISABLE_DENORMALS,
                                                              debug_mode_switches);
 
-        for (auto& tracks : _audio_graph)
+        for (int core = 0; core < _cores; ++core)
         {
-            auto status = _worker_pool->add_worker(external_render_callback,
-                                                   &tracks);
+            auto status = _worker_pool->add_worker(external_render_callback, &_core_workers[core]);
 
             if (status.first != twine::WorkerPoolStatus::OK)
             {
@@ -82,7 +126,7 @@ AudioGraph::AudioGraph(int cpu_cores,
 #endif
             }
 
-            tracks.reserve(max_no_tracks);
+            _audio_graph[core].reserve(max_no_tracks);
         }
     }
     else
@@ -93,11 +137,8 @@ AudioGraph::AudioGraph(int cpu_cores,
 
 bool AudioGraph::add(Track* track)
 {
-    auto& slot = _audio_graph[_current_core];
-    if (slot.size() < slot.capacity())
+    if (add_to_core(track, _current_core))
     {
-        track->set_event_output(&_event_outputs[_current_core]);
-        slot.push_back(track);
         _current_core = (_current_core + 1) % _cores;
         return true;
     }
@@ -112,6 +153,10 @@ bool AudioGraph::add_to_core(Track* track, int core)
     {
         track->set_event_output(&_event_outputs[core]);
         slot.push_back(track);
+        _render_times[core].push_back(0.0f);
+        _track_levels[core].push_back(0);
+        _periods_since_rebalance = REBALANCE_INTERVAL;
+        _topology_changed = true;
         return true;
     }
     return false;
@@ -119,13 +164,24 @@ bool AudioGraph::add_to_core(Track* track, int core)
 
 bool AudioGraph::remove(Track* track)
 {
-    for (auto& slot : _audio_graph)
+    for (int core = 0; core < _cores; ++core)
     {
+        auto& slot = _audio_graph[core];
         for (auto i = slot.begin(); i != slot.end(); ++i)
         {
             if (*i == track)
             {
+                auto index = std::distance(slot.begin(), i);
+                _render_times[core].erase(_render_times[core].begin() + index);
+                _track_levels[core].erase(_track_levels[core].begin() + index);
                 slot.erase(i);
+                // Processors on the track are no longer rendered in order with their senders
+                for (auto processor : track->processors())
+                {
+                    processor->set_senders_processed_before(false);
+                }
+                _periods_since_rebalance = REBALANCE_INTERVAL;
+                _topology_changed = true;
                 return true;
             }
         }
@@ -133,18 +189,406 @@ bool AudioGraph::remove(Track* track)
     return false;
 }
 
-void AudioGraph::render()
+void AudioGraph::set_output_channels(int channels)
+{
+    _output_channels = channels;
+    _partial_mixes.clear();
+    if (_cores > 1)
+    {
+        for (int core = 0; core < _cores; ++core)
+        {
+            _partial_mixes.emplace_back(channels);
+        }
+    }
+}
+
+void AudioGraph::render(ChunkSampleBuffer* output)
+{
+    int routing_generation = _current_routing_generation();
+    if (_topology_changed || routing_generation != _routing_generation)
+    {
+        _routing_generation = routing_generation;
+        _topology_changed = false;
+        _update_topology();
+    }
+
+    if (_scheduling != SchedulingMode::ROUND_ROBIN && ++_periods_since_rebalance >= REBALANCE_INTERVAL)
+    {
+        _rebalance();
+        _periods_since_rebalance = 0;
+    }
+
+    // With multiple cores, tracks can only be mixed once the partial mixes are allocated
+    bool can_mix = _cores == 1 || _partial_mixes.empty() == false;
+    _mix_output = can_mix ? output : nullptr;
+    if (output && (_cores == 1 || _levels == 0 || can_mix == false))
+    {
+        output->clear();
+    }
+
+    for (int level = 0; level < _levels; ++level)
+    {
+        if (_cores == 1)
+        {
+            const auto& tracks = _audio_graph[0];
+            const auto& offsets = _level_offsets[0];
+            auto& render_times = _render_times[0];
+            for (int t = offsets[level]; t < offsets[level + 1]; ++t)
+            {
+                auto start_time = _measure_render_times ? twine::current_rt_time() : std::chrono::nanoseconds(0);
+                tracks[t]->render();
+                if (output)
+                {
+                    tracks[t]->mix_to_outputs(*output);
+                }
+                if (_measure_render_times)
+                {
+                    auto render_time = static_cast<float>((twine::current_rt_time() - start_time).count());
+                    render_times[t] = std::max(render_time, render_times[t] * RENDER_TIME_DECAY);
+                }
+            }
+        }
+        else
+        {
+            _current_level = level;
+            for (int core = 0; core < _cores; ++core)
+            {
+                auto& worker = _core_workers[core];
+                worker.next_track.store(_level_offsets[core][level], std::memory_order_relaxed);
+                worker.end_track = _level_offsets[core][level + 1];
+            }
+            _worker_pool->wakeup_and_wait();
+        }
+    }
+
+    if (_mix_output && _cores > 1 && _levels > 0)
+    {
+        _reduce_partial_mixes(*output);
+    }
+}
+
+void AudioGraph::run_on_all_cores(CoreFunction function, void* data)
 {
     if (_cores == 1)
     {
-        for (auto& track : _audio_graph[0])
+        function(data, 0, 1);
+        return;
+    }
+    _core_function = function;
+    _core_function_data = data;
+    _worker_pool->wakeup_and_wait();
+    _core_function = nullptr;
+    _core_function_data = nullptr;
+}
+
+void AudioGraph::_render_core(int core)
+{
+    bool measure_time = _scheduling != SchedulingMode::ROUND_ROBIN || _measure_render_times;
+    ChunkSampleBuffer* mix = _mix_output ? &_partial_mixes[core] : nullptr;
+    if (mix && _current_level == 0)
+    {
+        mix->clear();
+    }
+
+    int stolen_from = core;
+    for (int i = 0; i < _cores; ++i)
+    {
+        auto& tracks = _audio_graph[stolen_from];
+        auto& render_times = _render_times[stolen_from];
+        auto& worker = _core_workers[stolen_from];
+
+        /* Tracks are claimed by incrementing the core's counter, so that a track
+         * is rendered exactly once, either by its own core or by another one.
+         * Tracks are mixed to the partial mix of the core that renders them */
+        for (int t = worker.next_track.fetch_add(1, std::memory_order_relaxed); t < worker.end_track;
+                 t = worker.next_track.fetch_add(1, std::memory_order_relaxed))
         {
+            auto track = tracks[t];
+            if (measure_time == false)
+            {
+                track->render();
+                if (mix)
+                {
+                    track->mix_to_outputs(*mix);
+                }
+                continue;
+            }
+            if (stolen_from != core)
+            {
+                // Events must go to the output of the core that renders the track
+                track->set_event_output(&_event_outputs[core]);
+            }
+            auto start_time = twine::current_rt_time();
             track->render();
+            if (mix)
+            {
+                track->mix_to_outputs(*mix);
+            }
+            auto render_time = static_cast<float>((twine::current_rt_time() - start_time).count());
+            render_times[t] = std::max(render_time, render_times[t] * RENDER_TIME_DECAY);
+            if (stolen_from != core)
+            {
+                track->set_event_output(&_event_outputs[stolen_from]);
+            }
         }
+
+        if (_scheduling != SchedulingMode::WORK_STEALING)
+        {
+            break;
+        }
+        stolen_from = (stolen_from + 1) % _cores;
     }
-    else
+}
+
+void AudioGraph::_reduce_partial_mixes(ChunkSampleBuffer& output)
+{
+    int channels = std::min(_output_channels, output.channel_count());
+    auto mix = ChunkSampleBuffer::create_non_owning_buffer(output, 0, channels);
+    mix.replace(ChunkSampleBuffer::create_non_owning_buffer(_partial_mixes[0], 0, channels));
+    for (int core = 1; core < _cores; ++core)
+    {
+        mix.add(ChunkSampleBuffer::create_non_owning_buffer(_partial_mixes[core], 0, channels));
+    }
+    if (channels < output.channel_count())
+    {
+        auto unused = ChunkSampleBuffer::create_non_owning_buffer(output, channels, output.channel_count() - channels);
+        unused.clear();
+    }
+}
+
+void AudioGraph::_rebalance()
+{
+    /* Greedy longest-processing-time-first partitioning, done separately for
+     * every level. Tracks are sorted by level and measured render time and each
+     * one is assigned to the core with the currently lowest total load on its
+     * level. Everything here works on pre-allocated memory */
+    _collect_tracks();
+    for (int core = 0; core < _cores; ++core)
+    {
+        _audio_graph[core].clear();
+        _render_times[core].clear();
+        _track_levels[core].clear();
+    }
+
+    // Insertion sort, as std::stable_sort might allocate and the number of tracks is small
+    for (size_t i = 1; i < _track_buffer.size(); ++i)
+    {
+        auto entry = _track_buffer[i];
+        size_t j = i;
+        for (; j > 0 && (_track_buffer[j - 1].level > entry.level ||
+                         (_track_buffer[j - 1].level == entry.level && _track_buffer[j - 1].render_time < entry.render_time)); --j)
+        {
+            _track_buffer[j] = _track_buffer[j - 1];
+        }
+        _track_buffer[j] = entry;
+    }
+
+    int current_level = -1;
+    for (const auto& entry : _track_buffer)
     {
-        _worker_pool->wakeup_and_wait();
+        if (entry.level != current_level)
+        {
+            std::fill(_core_loads.begin(), _core_loads.end(), 0.0f);
+            current_level = entry.level;
+        }
+        // Pick the least loaded core that has room, prefer fewer tracks if loads are equal
+        int core = -1;
+        for (int c = 0; c < _cores; ++c)
+        {
+            if (_audio_graph[c].size() == _audio_graph[c].capacity())
+            {
+                continue;
+            }
+            if (core < 0 || _core_loads[c] < _core_loads[core] ||
+                (_core_loads[c] == _core_loads[core] && _audio_graph[c].size() < _audio_graph[core].size()))
+            {
+                core = c;
+            }
+        }
+        assert(core >= 0);
+        _core_loads[core] += entry.render_time;
+        _audio_graph[core].push_back(entry.track);
+        _render_times[core].push_back(entry.render_time);
+        _track_levels[core].push_back(entry.level);
+        entry.track->set_event_output(&_event_outputs[core]);
+    }
+    _sort_by_level();
+}
+
+void AudioGraph::_update_topology()
+{
+    _collect_tracks();
+    int track_count = static_cast<int>(_track_buffer.size());
+
+    /* Find all connections between tracks, the number of processors is small
+     * enough that a linear search for the receiving track is fine */
+    bool all_connections_found = true;
+    _connections.clear();
+    for (int from = 0; from < track_count; ++from)
+    {
+        for (auto processor : _track_buffer[from].track->processors())
+        {
+            auto destination = processor->audio_send_destination();
+            if (destination == nullptr)
+            {
+                continue;
+            }
+            int to = -1;
+            for (int t = 0; t < track_count && to < 0; ++t)
+            {
+                const auto& processors = _track_buffer[t].track->processors();
+                if (std::find(processors.begin(), processors.end(), destination) != processors.end())
+                {
+                    to = t;
+                }
+            }
+            if (to < 0)
+            {
+                // The receiver is not rendered by the graph
+                continue;
+            }
+            if (_connections.size() == _connections.capacity())
+            {
+                all_connections_found = false;
+                continue;
+            }
+            _connections.push_back({from, to, destination});
+        }
+    }
+
+    /* Assign levels in topological order (Kahn's algorithm). Connections from
+     * a track to itself are ignored as they can never be ordered */
+    for (int t = 0; t < track_count; ++t)
+    {
+        _track_buffer[t].level = 0;
+        _in_degrees[t] = 0;
+    }
+    for (const auto& connection : _connections)
+    {
+        if (connection.from != connection.to)
+        {
+            _in_degrees[connection.to]++;
+        }
+    }
+    _ready_tracks.clear();
+    for (int t = 0; t < track_count; ++t)
+    {
+        if (_in_degrees[t] == 0)
+        {
+            _ready_tracks.push_back(t);
+        }
+    }
+    int max_level = -1;
+    for (size_t i = 0; i < _ready_tracks.size(); ++i)
+    {
+        int from = _ready_tracks[i];
+        int level = _track_buffer[from].level;
+        max_level = std::max(max_level, level);
+        for (const auto& connection : _connections)
+        {
+            if (connection.from == from && connection.to != from)
+            {
+                auto& receiver = _track_buffer[connection.to];
+                receiver.level = std::max(receiver.level, level + 1);
+                if (--_in_degrees[connection.to] == 0)
+                {
+                    _ready_tracks.push_back(connection.to);
+                }
+            }
+        }
+    }
+    if (static_cast<int>(_ready_tracks.size()) < track_count)
+    {
+        // Tracks in, or downstream of, a feedback loop are all rendered last
+        max_level++;
+        for (int t = 0; t < track_count; ++t)
+        {
+            if (_in_degrees[t] > 0)
+            {
+                _track_buffer[t].level = max_level;
+            }
+        }
+    }
+    _levels = max_level + 1;
+
+    /* A receiver can output audio without delay if all its senders are on lower levels */
+    for (size_t i = 0; i < _connections.size(); ++i)
+    {
+        auto destination = _connections[i].destination;
+        bool first = std::none_of(_connections.begin(), _connections.begin() + i,
+                                  [&](const auto& c) {return c.destination == destination;});
+        if (first == false)
+        {
+            continue;
+        }
+        bool processed_before = all_connections_found;
+        for (size_t j = i; j < _connections.size(); ++j)
+        {
+            const auto& connection = _connections[j];
+            if (connection.destination == destination &&
+                _track_buffer[connection.from].level >= _track_buffer[connection.to].level)
+            {
+                processed_before = false;
+            }
+        }
+        destination->set_senders_processed_before(processed_before);
+    }
+
+    int index = 0;
+    for (int core = 0; core < _cores; ++core)
+    {
+        for (auto& level : _track_levels[core])
+        {
+            level = _track_buffer[index++].level;
+        }
+    }
+    _sort_by_level();
+}
+
+void AudioGraph::_sort_by_level()
+{
+    for (int core = 0; core < _cores; ++core)
+    {
+        auto& tracks = _audio_graph[core];
+        auto& render_times = _render_times[core];
+        auto& levels = _track_levels[core];
+        int size = static_cast<int>(tracks.size());
+
+        // Stable insertion sort, the tracks are mostly sorted already
+        for (int i = 1; i < size; ++i)
+        {
+            for (int j = i; j > 0 && levels[j - 1] > levels[j]; --j)
+            {
+                std::swap(tracks[j], tracks[j - 1]);
+                std::swap(render_times[j], render_times[j - 1]);
+                std::swap(levels[j], levels[j - 1]);
+            }
+        }
+
+        auto& offsets = _level_offsets[core];
+        offsets.clear();
+        int t = 0;
+        for (int level = 0; level < _levels; ++level)
+        {
+            offsets.push_back(t);
+            while (t < size && levels[t] == level)
+            {
+                ++t;
+            }
+        }
+        offsets.push_back(size);
+    }
+}
+
+void AudioGraph::_collect_tracks()
+{
+    _track_buffer.clear();
+    for (int core = 0; core < _cores; ++core)
+    {
+        for (size_t i = 0; i < _audio_graph[core].size(); ++i)
+        {
+            _track_buffer.push_back({_audio_graph[core][i], _render_times[core][i], _track_levels[core][i]});
+        }
     }
 }
 
@@ -22,14 +22,26 @@
  * @copyright 2017-2023 Elk Audio AB, Stockholm
  */
 
+#include <atomic>
 #include <vector>
 
 #include "twine/twine.h"
 
 #include "engine/track.h"
+#include "library/spinlock.h"
 
 namespace sushi::internal::engine {
 
+/**
+ * @brief Strategy for distributing tracks between cpu cores in multicore mode.
+ */
+enum class SchedulingMode
+{
+    ROUND_ROBIN,    // Tracks are statically assigned to cores in the order they are added
+    LOAD_BALANCED,  // Tracks are periodically redistributed between cores based on their measured render time
+    WORK_STEALING   // As LOAD_BALANCED, but idle cores also pick up tracks not yet started by other cores
+};
+
 class AudioGraphAccessor;
 
 class AudioGraph
@@ -45,18 +57,27 @@ public:
      * @param sample_rate The sample_rate - used for calculating audio thread periodicity. Only used on Apple.
      * @param device_name The Audio Device Name - only used on Apple, and will be unused on other platforms.
      * @param debug_mode_switches Enable xenomai-specific thread debugging
+     * @param scheduling The strategy used to distribute tracks between cores. Only
+     *                   relevant if cpu_cores > 1.
+     * @param audio_routing_generation Counter incremented through HostControl by the
+     *                   processors of the graph's tracks when their audio routing changes.
+     *                   If null, the rendering order is only updated when tracks are
+     *                   added or removed.
      */
     AudioGraph(int cpu_cores,
                int max_no_tracks,
                float sample_rate,
                std::optional<std::string> device_name = std::nullopt,
-               bool debug_mode_switches = false);
+               bool debug_mode_switches = false,
+               SchedulingMode scheduling = SchedulingMode::ROUND_ROBIN,
+               const std::atomic<int>* audio_routing_generation = nullptr);
 
     ~AudioGraph() = default;
 
     /**
      * @brief Add a track to the graph. The track will be assigned to a cpu
-     *        core on a round robin basis. Must not be called concurrently
+     *        core on a round robin basis. With a load balancing scheduling mode
+     *        it may later be moved to another core. Must not be called concurrently
      *        with render()
      * @param track the track instance to add
      * @return true if the track was successfully added, false otherwise
@@ -65,7 +86,8 @@ public:
 
     /**
      * @brief Add a track to the graph and assign it to a particular cpu core.
-     *        Must not be called concurrently with render()
+     *        With a load balancing scheduling mode, the core is only the initial
+     *        assignment. Must not be called concurrently with render()
      * @param track the track instance to add
      * @param core The cpu that should be used to process the track.
      * @return true if the track was successfully added, false otherwise
@@ -90,21 +112,203 @@ public:
         return _event_outputs;
     }
 
+    /**
+     * @brief Set the number of channels of the engine output that tracks are mixed to
+     *        in render(). Allocates one partial mix buffer per core when running on
+     *        multiple cores. Not realtime safe and must not be called concurrently
+     *        with render()
+     * @param channels The number of engine output channels
+     */
+    void set_output_channels(int channels);
+
     /**
      * @brief Render all tracks. If cpu_cores = 1 all processing is done in the
      *        calling thread. With higher number of cores, the calling thread
      *        sleeps while processing is running.
+     *        Tracks that receive audio from other tracks through send/return
+     *        connections are rendered after the sending tracks, in consecutive
+     *        levels, so that the audio is received within the same chunk.
+     * @param output If not null, every track is mixed to this buffer, according to
+     *        its output routes, directly after it is rendered. With multiple cores,
+     *        every core mixes to a partial mix of its own, and the partial mixes are
+     *        summed to output when all tracks are rendered. Channels of output above
+     *        the number set with set_output_channels() are cleared.
+     */
+    void render(ChunkSampleBuffer* output = nullptr);
+
+    /**
+     * @brief Function that can be run on all cores with run_on_all_cores()
+     * @param data The data pointer passed to run_on_all_cores()
+     * @param core The index of the core calling the function
+     * @param cores The total number of cores
+     */
+    using CoreFunction = void (*)(void* data, int core, int cores);
+
+    /**
+     * @brief Call a function once on every core, using the same worker threads as
+     *        render(), and wait for all calls to return. With cpu_cores = 1 the
+     *        function is called directly from the calling thread. Must not be called
+     *        concurrently with render()
+     * @param function The function to call
+     * @param data Passed to every call of function
+     */
+    void run_on_all_cores(CoreFunction function, void* data);
+
+    /**
+     * @brief Return the number of levels that tracks are rendered in. Tracks on
+     *        the same level are independent and can be rendered in parallel.
+     *        Updated during render().
+     * @return The number of levels, 0 if the graph is empty
+     */
+    int levels() const
+    {
+        return _levels;
+    }
+
+    /**
+     * @brief Return the scheduling mode used by the graph
+     * @return A SchedulingMode enum
+     */
+    SchedulingMode scheduling_mode() const
+    {
+        return _scheduling;
+    }
+
+    /**
+     * @brief Measure the render time of every track, even if the scheduling mode
+     *        does not need it. Must not be called concurrently with render()
+     * @param enabled If true, render times are always measured
      */
-    void render();
+    void set_measure_render_times(bool enabled)
+    {
+        _measure_render_times = enabled;
+    }
+
+    /**
+     * @brief Call a function with every track in the graph and its recent peak render
+     *        time in nanoseconds. Render times are only measured when needed by the
+     *        scheduling mode or enabled with set_measure_render_times(), otherwise they
+     *        are 0. Must not be called concurrently with render()
+     * @param function A callable taking a const Track* and a float render time
+     */
+    template <typename Function>
+    void for_each_render_time(Function function) const
+    {
+        for (int core = 0; core < _cores; ++core)
+        {
+            const auto& tracks = _audio_graph[core];
+            const auto& render_times = _render_times[core];
+            for (size_t i = 0; i < tracks.size(); ++i)
+            {
+                function(static_cast<const Track*>(tracks[i]), render_times[i]);
+            }
+        }
+    }
 
 private:
     friend AudioGraphAccessor;
 
+    /* Per-core data passed to the worker threads */
+    struct alignas(ASSUMED_CACHE_LINE_SIZE) CoreWorker
+    {
+        AudioGraph*      graph;
+        int              core;
+        std::atomic<int> next_track;
+        int              end_track;
+    };
+
+    struct TrackEntry
+    {
+        Track* track;
+        float  render_time;
+        int    level;
+    };
+
+    /* An audio connection from a processor on one track to a processor on another */
+    struct Connection
+    {
+        int              from;
+        int              to;
+        Processor*       destination;
+    };
+
+    friend void external_render_callback(void* data);
+
+    /**
+     * @brief Render the tracks of the current level assigned to a core. In the
+     *        load balancing modes their render times are measured and in
+     *        WORK_STEALING mode, tracks assigned to other cores are picked up
+     *        when the core's own tracks are done.
+     * @param core The index of the calling core.
+     */
+    void _render_core(int core);
+
+    /**
+     * @brief Sum the partial mixes of all cores to output
+     */
+    void _reduce_partial_mixes(ChunkSampleBuffer& output);
+
+    /**
+     * @brief Redistribute the tracks between the cores so that the sum of the
+     *        measured render times of every level is as even as possible. Does
+     *        not allocate and is safe to call from the rt thread, but not
+     *        concurrently with rendering.
+     */
+    void _rebalance();
+
+    /**
+     * @brief Find all send/return connections between tracks and sort the tracks
+     *        into levels so that every track is on a higher level than the tracks
+     *        sending audio to it. Tracks in a feedback loop are put on a common
+     *        last level and receive audio from each other with one chunk delay.
+     *        Does not allocate and is safe to call from the rt thread, but not
+     *        concurrently with rendering.
+     */
+    void _update_topology();
+
+    int _current_routing_generation() const
+    {
+        return _audio_routing_generation ? _audio_routing_generation->load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+     * @brief Sort the tracks of every core by level, keeping their relative
+     *        order, and calculate where each level starts.
+     */
+    void _sort_by_level();
+
+    /**
+     * @brief Flatten the tracks of all cores into _track_buffer
+     */
+    void _collect_tracks();
+
     std::vector<std::vector<Track*>>   _audio_graph;
+    std::vector<std::vector<float>>    _render_times;
+    std::vector<std::vector<int>>      _track_levels;
+    std::vector<std::vector<int>>      _level_offsets;
     std::unique_ptr<twine::WorkerPool> _worker_pool;
     std::vector<RtEventFifo<>>         _event_outputs;
+    std::vector<CoreWorker>            _core_workers;
+    std::vector<TrackEntry>            _track_buffer;
+    std::vector<Connection>            _connections;
+    std::vector<int>                   _in_degrees;
+    std::vector<int>                   _ready_tracks;
+    std::vector<float>                 _core_loads;
+    std::vector<ChunkSampleBuffer>     _partial_mixes;
+    ChunkSampleBuffer*                 _mix_output;
+    CoreFunction                       _core_function{nullptr};
+    void*                              _core_function_data{nullptr};
+    int _output_channels;
+    int _current_level;
+    SchedulingMode _scheduling;
     int _cores;
     int _current_core;
+    int _periods_since_rebalance;
+    int _levels;
+    const std::atomic<int>* _audio_routing_generation;
+    int _routing_generation;
+    bool _topology_changed;
+    bool _measure_render_times{false};
 };
 
 } // end namespace sushi::internal::engine
@@ -259,6 +259,11 @@ public:
 
     virtual EngineReturnStatus send_rt_event_to_processor(const RtEvent& /*event*/) = 0;
 
+    virtual EngineReturnStatus send_timed_rt_event(const RtEvent& event, Time /*timestamp*/)
+    {
+        return send_rt_event_to_processor(event);
+    }
+
     virtual std::pair<EngineReturnStatus, ObjectId> create_track(const std::string & /*track_id*/,
                                                                  int /*channel_count*/)
     {
@@ -309,6 +314,16 @@ public:
         return EngineReturnStatus::OK;
     }
 
+    virtual EngineReturnStatus begin_graph_transaction()
+    {
+        return EngineReturnStatus::OK;
+    }
+
+    virtual EngineReturnStatus commit_graph_transaction()
+    {
+        return EngineReturnStatus::OK;
+    }
+
     virtual dispatcher::BaseEventDispatcher* event_dispatcher()
     {
         return nullptr;
@@ -341,6 +356,10 @@ public:
 
     virtual bool master_limiter() const {return false;}
 
+    virtual void enable_multicore_master_limiter(bool /*enabled*/) {}
+
+    virtual bool multicore_master_limiter() const {return false;}
+
     virtual void update_timings() {}
 
     virtual void notify_interrupted_audio(Time /*duration*/) {}
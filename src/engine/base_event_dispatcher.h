@@ -78,6 +78,12 @@ public:
     virtual void set_sample_rate(float /*sample_rate*/) = 0;
     virtual void set_time(Time /*timestamp*/)  = 0;
 
+    /**
+     * @brief Called from the audio thread at the end of every audio chunk, after all
+     *        RtEvents from the chunk have been pushed.
+     */
+    virtual void notify_rt_events() {}
+
     virtual int dispatch(std::unique_ptr<Event> /*event*/) = 0;
 };
 
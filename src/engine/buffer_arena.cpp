@@ -0,0 +1,102 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Contiguous, cache aligned storage for the audio buffers of the engine and tracks
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#include <algorithm>
+#include <new>
+
+#include "buffer_arena.h"
+
+namespace sushi::internal::engine {
+
+constexpr size_t FLOATS_PER_ALIGNMENT = SAMPLE_BUFFER_ALIGNMENT / sizeof(float);
+
+BufferArena::BufferArena(int block_channels) : _block_channels(block_channels)
+{}
+
+BufferArena::~BufferArena()
+{
+    for (auto& block : _blocks)
+    {
+        ::operator delete[](block.data, std::align_val_t(SAMPLE_BUFFER_ALIGNMENT));
+    }
+}
+
+ChunkSampleBuffer BufferArena::allocate(int channels)
+{
+    if (channels <= 0)
+    {
+        return {};
+    }
+    std::scoped_lock lock(_lock);
+    float* region = nullptr;
+
+    auto& free_list = _free_regions[channels];
+    if (free_list.empty() == false)
+    {
+        region = free_list.back();
+        free_list.pop_back();
+    }
+    else
+    {
+        size_t region_size = _region_size(channels);
+        if (_blocks.empty() || _blocks.back().size - _blocks.back().used < region_size)
+        {
+            size_t block_size = std::max(region_size, _region_size(_block_channels));
+            auto data = new (std::align_val_t(SAMPLE_BUFFER_ALIGNMENT)) float[block_size];
+            _blocks.push_back({data, block_size, 0});
+        }
+        auto& block = _blocks.back();
+        region = block.data + block.used;
+        block.used += region_size;
+    }
+
+    auto buffer = ChunkSampleBuffer::create_from_raw_pointer(region, 0, channels);
+    buffer.clear();
+    return buffer;
+}
+
+void BufferArena::release(const ChunkSampleBuffer& buffer)
+{
+    if (buffer.channel_count() > 0)
+    {
+        std::scoped_lock lock(_lock);
+        _free_regions[buffer.channel_count()].push_back(const_cast<float*>(buffer.channel(0)));
+    }
+}
+
+size_t BufferArena::reserved_size() const
+{
+    std::scoped_lock lock(_lock);
+    size_t size = 0;
+    for (const auto& block : _blocks)
+    {
+        size += block.size;
+    }
+    return size;
+}
+
+size_t BufferArena::_region_size(int channels)
+{
+    // Round up so that every region starts on an aligned address
+    size_t size = static_cast<size_t>(channels) * AUDIO_CHUNK_SIZE;
+    return (size + FLOATS_PER_ALIGNMENT - 1) / FLOATS_PER_ALIGNMENT * FLOATS_PER_ALIGNMENT;
+}
+
+} // end namespace sushi::internal::engine
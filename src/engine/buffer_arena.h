@@ -0,0 +1,89 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Contiguous, cache aligned storage for the audio buffers of the engine and tracks
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_BUFFER_ARENA_H
+#define SUSHI_BUFFER_ARENA_H
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "sushi/sample_buffer.h"
+
+namespace sushi::internal::engine {
+
+/* Number of channels of AUDIO_CHUNK_SIZE samples reserved per arena block, regions
+ * larger than this get a block of their own */
+constexpr int DEFAULT_ARENA_BLOCK_CHANNELS = 256;
+
+/**
+ * @brief Hands out ChunkSampleBuffers backed by a few large allocations instead of one
+ *        heap allocation per buffer. Every region starts on a SAMPLE_BUFFER_ALIGNMENT
+ *        boundary so that buffers processed on different cores never share a cache line.
+ *        Released regions are recycled for later requests with the same channel count.
+ *        Allocation and release lock a mutex and must not be called from the audio thread.
+ */
+class BufferArena
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(BufferArena);
+
+    explicit BufferArena(int block_channels = DEFAULT_ARENA_BLOCK_CHANNELS);
+
+    ~BufferArena();
+
+    /**
+     * @brief Allocate a zeroed buffer from the arena.
+     * @param channels The number of channels of the buffer.
+     * @return A non-owning ChunkSampleBuffer pointing into the arena. Must be returned with
+     *         release() and must not be used after the arena is destroyed.
+     */
+    ChunkSampleBuffer allocate(int channels);
+
+    /**
+     * @brief Return a buffer previously allocated with allocate() to the arena.
+     * @param buffer The buffer to release.
+     */
+    void release(const ChunkSampleBuffer& buffer);
+
+    /**
+     * @brief Return the total number of floats reserved by the arena.
+     */
+    size_t reserved_size() const;
+
+private:
+    struct Block
+    {
+        float* data;
+        size_t size;
+        size_t used;
+    };
+
+    static size_t _region_size(int channels);
+
+    int _block_channels;
+    std::vector<Block> _blocks;
+    std::map<int, std::vector<float*>> _free_regions;
+    mutable std::mutex _lock;
+};
+
+} // end namespace sushi::internal::engine
+
+#endif // SUSHI_BUFFER_ARENA_H
@@ -34,34 +34,31 @@ namespace sushi::internal::engine {
 using namespace controller_impl;
 
 Controller::Controller(engine::BaseEngine* engine,
-                       midi_dispatcher::MidiDispatcher* midi_dispatcher,
-                       audio_frontend::BaseAudioFrontend* audio_frontend) : control::SushiControl(&_system_controller_impl,
-                                                                                              &_transport_controller_impl,
-                                                                                              &_timing_controller_impl,
-                                                                                              &_keyboard_controller_impl,
-                                                                                              &_audio_graph_controller_impl,
-                                                                                              &_program_controller_impl,
-                                                                                              &_parameter_controller_impl,
-                                                                                              &_midi_controller_impl,
-                                                                                              &_audio_routing_controller_impl,
-                                                                                              &_cv_gate_controller_impl,
-                                                                                              &_osc_controller_impl,
-                                                                                              &_session_controller_impl),
-                                                                         _system_controller_impl(engine->audio_input_channels(),
-                                                                                                 engine->audio_output_channels()),
-                                                                         _transport_controller_impl(engine),
-                                                                         _timing_controller_impl(engine),
-                                                                         _keyboard_controller_impl(engine),
-                                                                         _audio_graph_controller_impl(engine),
-                                                                         _program_controller_impl(engine),
-                                                                         _parameter_controller_impl(engine),
-                                                                         _midi_controller_impl(engine, midi_dispatcher),
-                                                                         _audio_routing_controller_impl(engine),
-                                                                         _cv_gate_controller_impl(engine),
-                                                                         _osc_controller_impl(engine),
-                                                                         _session_controller_impl(engine,
-                                                                                                  midi_dispatcher,
-                                                                                                  audio_frontend)
+                       midi_dispatcher::MidiDispatcher* midi_dispatcher) : control::SushiControl(&_system_controller_impl,
+                                                                                             &_transport_controller_impl,
+                                                                                             &_timing_controller_impl,
+                                                                                             &_keyboard_controller_impl,
+                                                                                             &_audio_graph_controller_impl,
+                                                                                             &_program_controller_impl,
+                                                                                             &_parameter_controller_impl,
+                                                                                             &_midi_controller_impl,
+                                                                                             &_audio_routing_controller_impl,
+                                                                                             &_cv_gate_controller_impl,
+                                                                                             &_osc_controller_impl,
+                                                                                             &_session_controller_impl),
+                                                                        _system_controller_impl(engine->audio_input_channels(),
+                                                                                                engine->audio_output_channels()),
+                                                                        _transport_controller_impl(engine),
+                                                                        _timing_controller_impl(engine),
+                                                                        _keyboard_controller_impl(engine),
+                                                                        _audio_graph_controller_impl(engine),
+                                                                        _program_controller_impl(engine),
+                                                                        _parameter_controller_impl(engine),
+                                                                        _midi_controller_impl(engine, midi_dispatcher),
+                                                                        _audio_routing_controller_impl(engine),
+                                                                        _cv_gate_controller_impl(engine),
+                                                                        _osc_controller_impl(engine),
+                                                                        _session_controller_impl(engine, midi_dispatcher)
 {
     _event_dispatcher = engine->event_dispatcher();
     _processors = engine->processor_container();
@@ -116,6 +113,10 @@ int Controller::process(Event* event)
     {
         _notify_parameter_listeners(event);
     }
+    else if (event->is_parameter_change_batch_notification())
+    {
+        _notify_parameter_listeners(static_cast<const ParameterChangeBatchNotificationEvent*>(event));
+    }
     else if (event->is_property_change_notification())
     {
         _notify_property_listeners(event);
@@ -219,6 +220,34 @@ void Controller::_notify_parameter_listeners(const Event* event) const
     }
 }
 
+void Controller::_notify_parameter_listeners(const ParameterChangeBatchNotificationEvent* event) const
+{
+    // Formatting values as strings is comparatively expensive, so skip it if no one is listening
+    if (_parameter_change_listeners.empty())
+    {
+        return;
+    }
+    std::shared_ptr<const Processor> processor;
+    for (const auto& change : event->changes())
+    {
+        if (processor == nullptr || processor->id() != change.processor_id)
+        {
+            processor = _processors->processor(change.processor_id);
+        }
+        auto formatted_value = processor ? processor->parameter_value_formatted(change.parameter_id).second : std::string();
+        control::ParameterChangeNotification notification(static_cast<int>(change.processor_id),
+                                                          static_cast<int>(change.parameter_id),
+                                                          change.normalized_value,
+                                                          change.domain_value,
+                                                          formatted_value,
+                                                          event->time());
+        for (auto& listener : _parameter_change_listeners)
+        {
+            listener->notification(&notification);
+        }
+    }
+}
+
 void Controller::_notify_property_listeners(const Event* event) const
 {
     auto typed_event = static_cast<const PropertyChangeNotificationEvent*>(event);
@@ -53,10 +53,6 @@ namespace control_frontend {
 class OSCFrontend;
 }
 
-namespace audio_frontend {
-class BaseAudioFrontend;
-}
-
 namespace engine {
 
 class BaseEngine;
@@ -65,8 +61,7 @@ class Controller : public control::SushiControl, EventPoster
 {
 public:
     Controller(engine::BaseEngine* engine,
-               midi_dispatcher::MidiDispatcher* midi_dispatcher,
-               audio_frontend::BaseAudioFrontend* audio_frontend);
+               midi_dispatcher::MidiDispatcher* midi_dispatcher);
 
     ~Controller() override;
 
@@ -97,6 +92,8 @@ private:
 
     void _notify_parameter_listeners(const Event* event) const;
 
+    void _notify_parameter_listeners(const ParameterChangeBatchNotificationEvent* event) const;
+
     void _notify_property_listeners(const Event* event) const;
 
     void _notify_timing_listeners(const EngineTimingNotificationEvent* event) const;
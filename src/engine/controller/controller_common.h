@@ -79,7 +79,11 @@ inline control::CpuTimings to_external(const sushi::internal::performance::Proce
 {
     return {.avg = timings.avg_case,
             .min = timings.min_case,
-            .max = timings.max_case};
+            .max = timings.max_case,
+            .p50 = timings.p50_case,
+            .p99 = timings.p99_case,
+            .p999 = timings.p999_case,
+            .overruns = timings.overruns};
 }
 
 inline control::TimeSignature to_external(sushi::TimeSignature internal)
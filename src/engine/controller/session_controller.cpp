@@ -112,13 +112,11 @@ inline void to_external(control::OscState& dest, const control_frontend::OscStat
 }
 
 SessionController::SessionController(BaseEngine* engine,
-                                     midi_dispatcher::MidiDispatcher* midi_dispatcher,
-                                     audio_frontend::BaseAudioFrontend* audio_frontend) : _event_dispatcher(engine->event_dispatcher()),
-                                                                                          _engine(engine),
-                                                                                          _midi_dispatcher(midi_dispatcher),
-                                                                                          _audio_frontend(audio_frontend),
-                                                                                          _processors(engine->processor_container()),
-                                                                                          _osc_frontend(nullptr)
+                                     midi_dispatcher::MidiDispatcher* midi_dispatcher) : _event_dispatcher(engine->event_dispatcher()),
+                                                                                         _engine(engine),
+                                                                                         _midi_dispatcher(midi_dispatcher),
+                                                                                         _processors(engine->processor_container()),
+                                                                                         _osc_frontend(nullptr)
 {}
 
 void SessionController::set_osc_frontend(control_frontend::OSCFrontend* osc_frontend)
@@ -154,26 +152,20 @@ control::ControlStatus SessionController::restore_session(const control::Session
 
     auto lambda = [&, state = std::move(new_session)] () -> int
     {
-        bool realtime = _engine->realtime();
-        if (realtime)
-        {
-            ELKLOG_LOG_DEBUG("Pausing engine");
-            _audio_frontend->pause(true);
-        }
-
+        /* The engine is not paused. All changes to the audio graph are collected and applied
+         * by the audio thread in a single period, instead of waiting for it for each change.
+         * The restored processors are not processed until then, so their state can be set
+         * directly. If the engine is not running in realtime, changes are applied directly. */
+        _engine->begin_graph_transaction();
         _clear_all_tracks();
         _restore_tracks(state->tracks);
         _restore_plugin_states(state->tracks);
         _restore_engine(state->engine_state);
+        [[maybe_unused]] auto status = _engine->commit_graph_transaction();
+        ELKLOG_LOG_ERROR_IF(status != EngineReturnStatus::OK, "Failed to apply all audio graph changes of restored session")
         _restore_midi(state->midi_state);
         _restore_osc(state->osc_state);
 
-        if (realtime)
-        {
-            ELKLOG_LOG_DEBUG("Un-Pausing engine");
-            _audio_frontend->pause(false);
-        }
-
         return EventStatus::HANDLED_OK;
     };
 
@@ -27,7 +27,6 @@
 #include "engine/base_event_dispatcher.h"
 #include "engine/midi_dispatcher.h"
 #include "control_frontends/osc_frontend.h"
-#include "audio_frontends/base_audio_frontend.h"
 
 namespace sushi::internal::engine::controller_impl {
 
@@ -37,8 +36,7 @@ class SessionController : public control::SessionController
 {
 public:
     SessionController(BaseEngine* engine,
-                      midi_dispatcher::MidiDispatcher* midi_dispatcher,
-                      audio_frontend::BaseAudioFrontend* audio_frontend);
+                      midi_dispatcher::MidiDispatcher* midi_dispatcher);
 
     ~SessionController() override = default;
 
@@ -71,7 +69,6 @@ private:
     dispatcher::BaseEventDispatcher*    _event_dispatcher;
     engine::BaseEngine*                 _engine;
     midi_dispatcher::MidiDispatcher*    _midi_dispatcher;
-    audio_frontend::BaseAudioFrontend*  _audio_frontend;
     const BaseProcessorContainer*       _processors;
     control_frontend::OSCFrontend*      _osc_frontend;
 };
@@ -31,7 +31,8 @@ TimingController::TimingController(engine::BaseEngine* engine) : _performance_ti
 
 inline control::CpuTimings to_external(performance::ProcessTimings& internal)
 {
-    return {internal.avg_case, internal.min_case, internal.max_case};
+    return {internal.avg_case, internal.min_case, internal.max_case,
+            internal.p50_case, internal.p99_case, internal.p999_case, internal.overruns};
 }
 
 bool TimingController::get_timing_statistics_enabled() const
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Deferred deletion of objects retired from the realtime threads
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#include <algorithm>
+
+#include "deferred_reclaimer.h"
+
+namespace sushi::internal::engine {
+
+constexpr auto RECLAIM_PERIODICITY = std::chrono::milliseconds(10);
+
+DeferredReclaimer::~DeferredReclaimer()
+{
+    stop();
+    flush();
+}
+
+void DeferredReclaimer::run()
+{
+    if (!_running)
+    {
+        _running = true;
+        _thread = std::thread(&DeferredReclaimer::_worker, this);
+    }
+}
+
+void DeferredReclaimer::stop()
+{
+    _running = false;
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+void DeferredReclaimer::retire(RtDeletable* object)
+{
+    auto head = _retired.load(std::memory_order_relaxed);
+    do
+    {
+        object->_next_retired = head;
+    }
+    while (!_retired.compare_exchange_weak(head, object, std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool DeferredReclaimer::retire(BlobData blob)
+{
+    if (blob.data == nullptr)
+    {
+        return true;
+    }
+    for (auto& slot : _retired_blobs)
+    {
+        uint8_t* empty = nullptr;
+        if (slot.load(std::memory_order_relaxed) == nullptr &&
+            slot.compare_exchange_strong(empty, blob.data, std::memory_order_release, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DeferredReclaimer::advance_epoch()
+{
+    _epoch.fetch_add(1, std::memory_order_release);
+}
+
+void DeferredReclaimer::collect()
+{
+    std::scoped_lock lock(_lock);
+    auto epoch = _epoch.load(std::memory_order_acquire);
+    while (!_pending.empty() && _pending.front().epoch < epoch)
+    {
+        _delete(_pending.front());
+        _pending.pop_front();
+    }
+    _take_retired(epoch);
+}
+
+void DeferredReclaimer::flush()
+{
+    std::scoped_lock lock(_lock);
+    _take_retired(0);
+    for (auto& batch : _pending)
+    {
+        _delete(batch);
+    }
+    _pending.clear();
+}
+
+void DeferredReclaimer::_worker()
+{
+    while (_running)
+    {
+        collect();
+        std::this_thread::sleep_for(RECLAIM_PERIODICITY);
+    }
+}
+
+void DeferredReclaimer::_take_retired(uint64_t epoch)
+{
+    Batch batch{0, _retired.exchange(nullptr, std::memory_order_acquire), {}};
+    for (auto& slot : _retired_blobs)
+    {
+        if (slot.load(std::memory_order_relaxed) != nullptr)
+        {
+            batch.blobs.push_back(slot.exchange(nullptr, std::memory_order_acquire));
+        }
+    }
+    if (batch.objects || !batch.blobs.empty())
+    {
+        /* Anything retired after epoch was read could belong to a period that is still
+         * running, so the epoch is read again after the objects are taken. Objects are
+         * deleted when the period with this epoch has finished. */
+        batch.epoch = std::max(epoch, _epoch.load(std::memory_order_acquire));
+        _pending.push_back(std::move(batch));
+    }
+}
+
+void DeferredReclaimer::_delete(Batch& batch)
+{
+    auto object = batch.objects;
+    while (object)
+    {
+        auto next = object->_next_retired;
+        delete object;
+        object = next;
+    }
+    for (auto blob : batch.blobs)
+    {
+        delete[] blob;
+    }
+}
+
+} // end namespace sushi::internal::engine
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Deferred deletion of objects retired from the realtime threads
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_DEFERRED_RECLAIMER_H
+#define SUSHI_DEFERRED_RECLAIMER_H
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sushi/constants.h"
+#include "sushi/types.h"
+
+namespace sushi::internal::engine {
+
+constexpr int MAX_RETIRED_BLOBS = 64;
+
+/**
+ * @brief Deletes objects retired by the realtime threads, in bulk and from a non-rt thread.
+ *        Retiring an object is lock free and never allocates. RtDeletables are chained in
+ *        an intrusive list, so there is no limit to how many can be retired per period.
+ *        An object is only deleted once the audio period it was retired in has finished,
+ *        as signalled by advance_epoch(), so other realtime threads processing the same
+ *        period can still access it safely.
+ */
+class DeferredReclaimer
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(DeferredReclaimer);
+
+    DeferredReclaimer() = default;
+
+    ~DeferredReclaimer();
+
+    /**
+     * @brief Start a thread that periodically calls collect()
+     */
+    void run();
+
+    void stop();
+
+    /**
+     * @brief Retire an object for deletion. Safe to call from any thread.
+     * @param object The object to delete, ownership is transferred to the reclaimer.
+     */
+    void retire(RtDeletable* object);
+
+    /**
+     * @brief Retire the data of a BlobData for deletion. Safe to call from any thread.
+     * @param blob The blob to delete, ownership of its data is transferred to the reclaimer
+     *        if successful.
+     * @return true if the blob was retired, false if too many blobs are already waiting
+     *         and the caller needs to delete it by other means.
+     */
+    bool retire(BlobData blob);
+
+    /**
+     * @brief Signal that all realtime threads are done with the current audio period.
+     *        Called by the engine at the end of every chunk.
+     */
+    void advance_epoch();
+
+    /**
+     * @brief Delete all objects retired in periods that have finished.
+     */
+    void collect();
+
+    /**
+     * @brief Delete all retired objects, regardless of the period they were retired in.
+     *        Only safe to call when no realtime thread is running.
+     */
+    void flush();
+
+private:
+    struct Batch
+    {
+        uint64_t              epoch;
+        RtDeletable*          objects;
+        std::vector<uint8_t*> blobs;
+    };
+
+    void _worker();
+
+    void _take_retired(uint64_t epoch);
+
+    static void _delete(Batch& batch);
+
+    std::atomic<uint64_t>     _epoch{0};
+    std::atomic<RtDeletable*> _retired{nullptr};
+    std::array<std::atomic<uint8_t*>, MAX_RETIRED_BLOBS> _retired_blobs{};
+
+    // Protects _pending, which is only accessed from non-rt threads
+    std::mutex        _lock;
+    std::deque<Batch> _pending;
+
+    std::atomic<bool> _running{false};
+    std::thread       _thread;
+};
+
+} // end namespace sushi::internal::engine
+
+#endif // SUSHI_DEFERRED_RECLAIMER_H
@@ -26,9 +26,11 @@
 namespace sushi::internal::dispatcher {
 
 constexpr std::chrono::milliseconds THREAD_PERIODICITY = std::chrono::milliseconds(1);
-constexpr auto WORKER_THREAD_PERIODICITY = std::chrono::milliseconds(1);
+/* Synchronisation events don't need to be handled right away, but the event thread is woken
+ * up regularly to handle them, so that they don't fill up the queue from the audio thread */
+constexpr int MAX_CHUNKS_BETWEEN_RT_NOTIFICATIONS = MAX_EVENTS_IN_QUEUE / 4;
 constexpr auto TIMING_UPDATE_INTERVAL = std::chrono::seconds(1);
-constexpr auto PARAMETER_UPDATE_RATE = 10;
+constexpr auto PARAMETER_UPDATE_INTERVAL = std::chrono::milliseconds(10);
 // Rate limits broadcast parameter updates to 25 Hz
 constexpr auto MAX_PARAMETER_UPDATE_INTERVAL = std::chrono::milliseconds(40);
 
@@ -43,7 +45,7 @@ EventDispatcher::EventDispatcher(engine::BaseEngine* engine,
                                                                     _event_timer{engine->sample_rate()},
                                                                     _parameter_manager{MAX_PARAMETER_UPDATE_INTERVAL,
                                                                                        engine->processor_container()},
-                                                                    _parameter_update_count{0}
+                                                                    _last_parameter_update{std::chrono::steady_clock::now()}
 {}
 
 EventDispatcher::~EventDispatcher()
@@ -52,17 +54,21 @@ EventDispatcher::~EventDispatcher()
     {
         stop();
     }
-
-    while (!_in_queue.empty())
-    {
-        // As each event goes out of scope, it's deleted.
-        auto event = _in_queue.pop();
-    }
 }
 
 void EventDispatcher::post_event(std::unique_ptr<Event> event)
 {
     _in_queue.push(std::move(event));
+    _wake_up();
+}
+
+void EventDispatcher::notify_rt_events()
+{
+    if (_in_rt_queue->take_events_pushed() || ++_chunks_since_rt_notification >= MAX_CHUNKS_BETWEEN_RT_NOTIFICATIONS)
+    {
+        _chunks_since_rt_notification = 0;
+        _wake_up();
+    }
 }
 
 void EventDispatcher::run()
@@ -78,6 +84,7 @@ void EventDispatcher::run()
 void EventDispatcher::stop()
 {
     _running = false;
+    _wake_up();
     _worker.stop();
     if (_event_thread.joinable())
     {
@@ -157,7 +164,9 @@ int EventDispatcher::dispatch(std::unique_ptr<Event> event)
         }
     }
 
-    if (event->is_parameter_change_notification() || event->is_property_change_notification())
+    if (event->is_parameter_change_notification() ||
+        event->is_parameter_change_batch_notification() ||
+        event->is_property_change_notification())
     {
         _publish_parameter_events(event.get());
         status = EventStatus::HANDLED_OK;
@@ -211,17 +220,65 @@ void EventDispatcher::_event_loop()
         }
 
         // Send updates for any parameters that have changed
-        if (_parameter_update_count++ >= PARAMETER_UPDATE_RATE)
+        if (start_time >= _last_parameter_update + PARAMETER_UPDATE_INTERVAL)
         {
             _parameter_manager.output_parameter_notifications(this, _last_rt_event_time);
-            _parameter_update_count = 0;
+            _last_parameter_update = start_time;
         }
 
-        std::this_thread::sleep_until(start_time + THREAD_PERIODICITY);
+        if (_running == false)
+        {
+            break;
+        }
+
+        /* Sleep until new events are posted, the audio thread signals that there are
+         * RtEvents to process, or queued parameter notifications or events are due */
+        auto deadline = _next_deadline(start_time);
+        bool woken_up = true;
+        if (deadline == std::chrono::steady_clock::time_point::max())
+        {
+            _wakeup.acquire();
+        }
+        else
+        {
+            woken_up = _wakeup.try_acquire_until(deadline);
+        }
+        if (woken_up)
+        {
+            // Cleared before the queues are checked, so that no new events are missed
+            _wakeup_pending = false;
+        }
     }
     while (_running);
 }
 
+std::chrono::steady_clock::time_point EventDispatcher::_next_deadline(std::chrono::steady_clock::time_point now) const
+{
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    if (_parameter_manager.parameter_change_queue_empty() == false ||
+        _parameter_manager.processor_change_queue_empty() == false)
+    {
+        deadline = _last_parameter_update + PARAMETER_UPDATE_INTERVAL;
+    }
+    for (const auto& event : _waiting_list)
+    {
+        /* If audio is not running, waiting events never become due, so they are
+         * checked at most once every THREAD_PERIODICITY */
+        auto time_left = std::max<std::chrono::steady_clock::duration>(_event_timer.time_until_next_chunk(event->time()),
+                                                                       THREAD_PERIODICITY);
+        deadline = std::min(deadline, now + time_left);
+    }
+    return deadline;
+}
+
+void EventDispatcher::_wake_up()
+{
+    if (_wakeup_pending.exchange(true) == false)
+    {
+        _wakeup.release();
+    }
+}
+
 int EventDispatcher::_process_rt_event(RtEvent &rt_event)
 {
     if (rt_event.type() == RtEventType::FLOAT_PARAMETER_CHANGE ||
@@ -277,7 +334,7 @@ std::unique_ptr<Event> EventDispatcher::_next_event()
         event = std::move(_waiting_list.back());
         _waiting_list.pop_back();
     }
-    else if (!_in_queue.empty())
+    else
     {
         event = _in_queue.pop();
     }
@@ -402,6 +459,7 @@ void Worker::run()
 void Worker::stop()
 {
     _running = false;
+    _queue.wake_up();
     if (_worker_thread.joinable())
     {
         _worker_thread.join();
@@ -421,10 +479,9 @@ void Worker::_worker()
     do
     {
         auto start_time = std::chrono::steady_clock::now();
-        while (!_queue.empty())
+        while (auto event = _queue.pop())
         {
             int status = EventStatus::UNRECOGNIZED_EVENT;
-            auto event = _queue.pop();
 
             if (event->is_engine_event())
             {
@@ -456,7 +513,11 @@ void Worker::_worker()
             _engine->update_timings();
         }
 
-        std::this_thread::sleep_until(start_time + WORKER_THREAD_PERIODICITY);
+        if (_running)
+        {
+            // Sleep until new work is queued, but wake up in time for the next timing update
+            _queue.wait_for_data(timing_update_counter + TIMING_UPDATE_INTERVAL - start_time);
+        }
     }
     while (_running);
 }
@@ -22,6 +22,8 @@
 #define SUSHI_EVENT_DISPATCHER_H
 
 #include <deque>
+#include <mutex>
+#include <semaphore>
 #include <vector>
 #include <thread>
 
@@ -29,7 +31,7 @@
 #include "engine/base_engine.h"
 #include "engine/event_timer.h"
 #include "engine/parameter_manager.h"
-#include "library/synchronised_fifo.h"
+#include "library/mpsc_queue.h"
 #include "library/rt_event_fifo.h"
 #include "library/event_interface.h"
 
@@ -44,7 +46,7 @@ class BaseEventDispatcher;
 class Accessor;
 class WorkerAccessor;
 
-using EventQueue = SynchronizedQueue<std::unique_ptr<Event>>;
+using EventQueue = MpscQueue<Event>;
 
 /**
  * @brief Low priority worker for handling possibly time consuming tasks like
@@ -101,6 +103,13 @@ public:
     void set_sample_rate(float sample_rate) override {_event_timer.set_sample_rate(sample_rate);}
     void set_time(Time timestamp) override {_event_timer.set_incoming_time(timestamp);}
 
+    /**
+     * @brief Called from the audio thread at the end of every audio chunk. Wakes up the
+     *        event thread if the chunk produced any RtEvents besides the synchronisation
+     *        event, which are otherwise only handled once in a while.
+     */
+    void notify_rt_events() override;
+
     int dispatch(std::unique_ptr<Event> event) override;
 
 private:
@@ -108,6 +117,10 @@ private:
 
     void _event_loop();
 
+    std::chrono::steady_clock::time_point _next_deadline(std::chrono::steady_clock::time_point now) const;
+
+    void _wake_up();
+
     int _process_rt_event(RtEvent& rt_event);
 
     std::unique_ptr<Event> _next_event();
@@ -122,6 +135,13 @@ private:
 
     EventQueue _in_queue;
 
+    /* Wakes up the event thread, released both by threads posting events and by the audio
+     * thread. Releasing is lock free, and only makes a system call if the event thread is
+     * sleeping. _wakeup_pending makes sure it is never released more than once */
+    std::binary_semaphore       _wakeup{0};
+    std::atomic<bool>           _wakeup_pending{false};
+    int                         _chunks_since_rt_notification{0};
+
     RtSafeRtEventFifo*          _in_rt_queue;
     RtSafeRtEventFifo*          _out_rt_queue;
 
@@ -130,7 +150,7 @@ private:
     Worker                      _worker;
     event_timer::EventTimer     _event_timer;
     ParameterManager            _parameter_manager;
-    int                         _parameter_update_count;
+    std::chrono::steady_clock::time_point _last_parameter_update;
     Time                        _last_rt_event_time{};
 
     std::vector<EventPoster*> _keyboard_event_listeners;
@@ -45,6 +45,18 @@ public:
      */
     std::pair<bool, int> sample_offset_from_realtime(Time timestamp) const;
 
+    /**
+     * @brief Get the time left until a timestamp falls within the next chunk, provided
+     *        that audio keeps running.
+     * @param timestamp A real time timestamp
+     * @return The time until sample_offset_from_realtime() returns true for timestamp,
+     *         zero or negative if it already does
+     */
+    Time time_until_next_chunk(Time timestamp) const
+    {
+        return timestamp - _incoming_chunk_time.load() - _chunk_time + Time(1);
+    }
+
     /**
      * @brief Convert a sample offset to real time.
      * @param offset Offset in samples
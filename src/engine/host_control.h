@@ -22,7 +22,10 @@
 #ifndef SUSHI_HOST_CONTROL_H
 #define SUSHI_HOST_CONTROL_H
 
+#include <atomic>
+
 #include "base_event_dispatcher.h"
+#include "engine/deferred_reclaimer.h"
 #include "engine/transport.h"
 #include "engine/plugin_library.h"
 
@@ -33,10 +36,14 @@ class HostControl
 public:
     HostControl(dispatcher::BaseEventDispatcher* event_dispatcher,
                 engine::Transport* transport,
-                engine::PluginLibrary* library) :
+                engine::PluginLibrary* library,
+                engine::DeferredReclaimer* reclaimer = nullptr,
+                std::atomic<int>* audio_routing_generation = nullptr) :
                     _event_dispatcher(event_dispatcher),
                     _transport(transport),
-                    _plugin_library(library)
+                    _plugin_library(library),
+                    _reclaimer(reclaimer),
+                    _audio_routing_generation(audio_routing_generation)
     {}
 
     /**
@@ -72,10 +79,33 @@ public:
         return _plugin_library->to_absolute_path(path);
     }
 
+    /**
+     * @brief Get the engine's reclaimer for objects deleted from the realtime threads.
+     *        May be null, in which case deletion is requested through events instead.
+     */
+    engine::DeferredReclaimer* reclaimer()
+    {
+        return _reclaimer;
+    }
+
+    /**
+     * @brief Signal to the engine that audio connections between processors, or the
+     *        signal chain of a track, have changed. Safe to call from any thread.
+     */
+    void notify_audio_routing_changed()
+    {
+        if (_audio_routing_generation)
+        {
+            _audio_routing_generation->fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
 protected:
     dispatcher::BaseEventDispatcher* _event_dispatcher;
     engine::Transport*               _transport;
     engine::PluginLibrary*           _plugin_library;
+    engine::DeferredReclaimer*       _reclaimer;
+    std::atomic<int>*                _audio_routing_generation;
 };
 
 } // end namespace sushi::internal
@@ -243,6 +243,12 @@ JsonConfigReturnStatus JsonConfigurator::load_host_config()
         ELKLOG_LOG_INFO("Enable master limiter set to {}", host_config["master_limiter"].GetBool());
     }
 
+    if (host_config.HasMember("master_limiter_multicore"))
+    {
+        _engine->enable_multicore_master_limiter(host_config["master_limiter_multicore"].GetBool());
+        ELKLOG_LOG_INFO("Multicore master limiter set to {}", host_config["master_limiter_multicore"].GetBool());
+    }
+
     return JsonConfigReturnStatus::OK;
 }
 
@@ -32,67 +32,67 @@ namespace sushi::internal::midi_dispatcher {
 
 ELKLOG_GET_LOGGER_WITH_MODULE_NAME("midi dispatcher");
 
-inline std::unique_ptr<Event> make_note_on_event(const InputConnection& c,
-                                                 const midi::NoteOnMessage& msg,
-                                                 Time timestamp)
+inline KeyboardEvent make_note_on_event(const InputConnection& c,
+                                        const midi::NoteOnMessage& msg,
+                                        Time timestamp)
 {
     if (msg.velocity == 0)
     {
-        return std::make_unique<KeyboardEvent>(KeyboardEvent::Subtype::NOTE_OFF, c.target, msg.channel, msg.note, 0.5f, timestamp);
+        return KeyboardEvent(KeyboardEvent::Subtype::NOTE_OFF, c.target, msg.channel, msg.note, 0.5f, timestamp);
     }
 
     float velocity = msg.velocity / static_cast<float>(midi::MAX_VALUE);
-    return std::make_unique<KeyboardEvent>(KeyboardEvent::Subtype::NOTE_ON, c.target, msg.channel, msg.note, velocity, timestamp);
+    return KeyboardEvent(KeyboardEvent::Subtype::NOTE_ON, c.target, msg.channel, msg.note, velocity, timestamp);
 }
 
-inline std::unique_ptr<Event> make_note_off_event(const InputConnection& c,
-                                                  const midi::NoteOffMessage& msg,
-                                                  Time timestamp)
+inline KeyboardEvent make_note_off_event(const InputConnection& c,
+                                         const midi::NoteOffMessage& msg,
+                                         Time timestamp)
 {
     float velocity = msg.velocity / static_cast<float>(midi::MAX_VALUE);
-    return std::make_unique<KeyboardEvent>(KeyboardEvent::Subtype::NOTE_OFF, c.target, msg.channel, msg.note, velocity, timestamp);
+    return KeyboardEvent(KeyboardEvent::Subtype::NOTE_OFF, c.target, msg.channel, msg.note, velocity, timestamp);
 }
 
-inline std::unique_ptr<Event> make_note_aftertouch_event(const InputConnection& c,
-                                                         const midi::PolyKeyPressureMessage& msg,
-                                                         Time timestamp)
+inline KeyboardEvent make_note_aftertouch_event(const InputConnection& c,
+                                                const midi::PolyKeyPressureMessage& msg,
+                                                Time timestamp)
 {
     float pressure = msg.pressure / static_cast<float>(midi::MAX_VALUE);
-    return std::make_unique<KeyboardEvent>(KeyboardEvent::Subtype::NOTE_AFTERTOUCH, c.target, msg.channel, msg.note, pressure, timestamp);
+    return KeyboardEvent(KeyboardEvent::Subtype::NOTE_AFTERTOUCH, c.target, msg.channel, msg.note, pressure, timestamp);
 }
 
-inline std::unique_ptr<Event> make_aftertouch_event(const InputConnection& c,
-                                                    const midi::ChannelPressureMessage& msg,
-                                                    Time timestamp)
+inline KeyboardEvent make_aftertouch_event(const InputConnection& c,
+                                           const midi::ChannelPressureMessage& msg,
+                                           Time timestamp)
 {
     float pressure = msg.pressure / static_cast<float>(midi::MAX_VALUE);
-    return std::make_unique<KeyboardEvent>(KeyboardEvent::Subtype::AFTERTOUCH, c.target, msg.channel, pressure, timestamp);
+    return KeyboardEvent(KeyboardEvent::Subtype::AFTERTOUCH, c.target, msg.channel, pressure, timestamp);
 }
 
-inline std::unique_ptr<Event> make_modulation_event(const InputConnection& c,
-                                                    const midi::ControlChangeMessage& msg,
-                                                    Time timestamp)
+inline KeyboardEvent make_modulation_event(const InputConnection& c,
+                                           const midi::ControlChangeMessage& msg,
+                                           Time timestamp)
 {
     float value = msg.value / static_cast<float>(midi::MAX_VALUE);
-    return std::make_unique<KeyboardEvent>(KeyboardEvent::Subtype::MODULATION, c.target, msg.channel, value, timestamp);
+    return KeyboardEvent(KeyboardEvent::Subtype::MODULATION, c.target, msg.channel, value, timestamp);
 }
 
-inline std::unique_ptr<Event> make_pitch_bend_event(const InputConnection& c,
-                                                    const midi::PitchBendMessage& msg,
-                                                    Time timestamp)
+inline KeyboardEvent make_pitch_bend_event(const InputConnection& c,
+                                           const midi::PitchBendMessage& msg,
+                                           Time timestamp)
 {
     float value = (msg.value / static_cast<float>(midi::PITCH_BEND_MIDDLE)) - 1.0f;
-    return std::make_unique<KeyboardEvent>(KeyboardEvent::Subtype::PITCH_BEND, c.target, msg.channel, value, timestamp);
+    return KeyboardEvent(KeyboardEvent::Subtype::PITCH_BEND, c.target, msg.channel, value, timestamp);
 }
 
-inline std::unique_ptr<Event> make_wrapped_midi_event(const InputConnection& c,
-                                                      const uint8_t* data,
-                                                      size_t size,
-                                                      Time timestamp)
+inline KeyboardEvent make_wrapped_midi_event(const InputConnection& c,
+                                             const uint8_t* data,
+                                             size_t size,
+                                             Time timestamp)
 {
     MidiDataByte midi_data{0};
     std::copy(data, data + size, midi_data.data());
-    return std::make_unique<KeyboardEvent>(KeyboardEvent::Subtype::WRAPPED_MIDI, c.target, midi_data, timestamp);
+    return KeyboardEvent(KeyboardEvent::Subtype::WRAPPED_MIDI, c.target, midi_data, timestamp);
 }
 
 inline std::unique_ptr<Event> make_param_change_event(InputConnection& c,
@@ -130,8 +130,10 @@ inline std::unique_ptr<Event> make_program_change_event(const InputConnection& c
     return std::make_unique<ProgramChangeEvent>(c.target, msg.program, timestamp);
 }
 
-MidiDispatcher::MidiDispatcher(dispatcher::BaseEventDispatcher* event_dispatcher) : _frontend(nullptr),
-                                                                                    _event_dispatcher(event_dispatcher)
+MidiDispatcher::MidiDispatcher(dispatcher::BaseEventDispatcher* event_dispatcher,
+                               engine::BaseEngine* engine) : _frontend(nullptr),
+                                                             _event_dispatcher(event_dispatcher),
+                                                             _engine(engine)
 {
     _event_dispatcher->subscribe_to_keyboard_events(this);
     _event_dispatcher->subscribe_to_engine_notifications(this);
@@ -354,9 +356,11 @@ MidiDispatcherStatus MidiDispatcher::connect_kb_to_track(int midi_input,
     connection.min_range = 0;
     connection.max_range = 0;
 
-    std::scoped_lock lock(_kb_routes_in_lock);
-
-    _kb_routes_in[midi_input][channel].push_back(connection);
+    {
+        std::scoped_lock lock(_kb_routes_in_lock);
+        _kb_routes_in[midi_input][channel].push_back(connection);
+    }
+    _publish_rt_routes();
     ELKLOG_LOG_INFO("Connected MIDI port \"{}\" to track ID \"{}\"", midi_input, track_id);
     return MidiDispatcherStatus::OK;
 }
@@ -371,21 +375,24 @@ MidiDispatcherStatus MidiDispatcher::disconnect_kb_from_track(int midi_input,
         return MidiDispatcherStatus::INVALID_MIDI_INPUT;
     }
 
-    std::scoped_lock lock(_kb_routes_in_lock);
-
-    auto connections = _kb_routes_in.find(midi_input); // All connections for the midi_input
-    if (connections != _kb_routes_in.end())
     {
-        auto& connection_vector = connections->second[channel];
-        auto erase_iterator = std::remove_if(connection_vector.begin(),
-                                             connection_vector.end(),
-                                             [&](const auto& c)
-                                             {
-                                                 return c.target == track_id;
-                                             });
+        std::scoped_lock lock(_kb_routes_in_lock);
 
-        connection_vector.erase(erase_iterator, connection_vector.end());
+        auto connections = _kb_routes_in.find(midi_input); // All connections for the midi_input
+        if (connections != _kb_routes_in.end())
+        {
+            auto& connection_vector = connections->second[channel];
+            auto erase_iterator = std::remove_if(connection_vector.begin(),
+                                                 connection_vector.end(),
+                                                 [&](const auto& c)
+                                                 {
+                                                     return c.target == track_id;
+                                                 });
+
+            connection_vector.erase(erase_iterator, connection_vector.end());
+        }
     }
+    _publish_rt_routes();
 
     ELKLOG_LOG_INFO("Disconnected MIDI port \"{}\" from track ID \"{}\"", midi_input, track_id);
     return MidiDispatcherStatus::OK;
@@ -453,9 +460,11 @@ MidiDispatcherStatus MidiDispatcher::connect_raw_midi_to_track(int midi_input,
     connection.min_range = 0;
     connection.max_range = 0;
 
-    std::scoped_lock lock(_raw_routes_in_lock);
-
-    _raw_routes_in[midi_input][channel].push_back(connection);
+    {
+        std::scoped_lock lock(_raw_routes_in_lock);
+        _raw_routes_in[midi_input][channel].push_back(connection);
+    }
+    _publish_rt_routes();
     ELKLOG_LOG_INFO("Connected MIDI port \"{}\" to track ID \"{}\"", midi_input, track_id);
     return MidiDispatcherStatus::OK;
 }
@@ -469,21 +478,24 @@ MidiDispatcherStatus MidiDispatcher::disconnect_raw_midi_from_track(int midi_inp
         return MidiDispatcherStatus::INVALID_MIDI_INPUT;
     }
 
-    std::scoped_lock lock(_raw_routes_in_lock);
-
-    auto connections = _raw_routes_in.find(midi_input); // All connections for the midi_input
-    if (connections != _raw_routes_in.end())
     {
-        auto& connection_vector = connections->second[channel];
-        auto erase_iterator = std::remove_if(connection_vector.begin(),
-                                             connection_vector.end(),
-                                             [&](const auto& c)
-                                             {
-                                                 return c.target == track_id;
-                                             });
+        std::scoped_lock lock(_raw_routes_in_lock);
 
-        connection_vector.erase(erase_iterator, connection_vector.end());
+        auto connections = _raw_routes_in.find(midi_input); // All connections for the midi_input
+        if (connections != _raw_routes_in.end())
+        {
+            auto& connection_vector = connections->second[channel];
+            auto erase_iterator = std::remove_if(connection_vector.begin(),
+                                                 connection_vector.end(),
+                                                 [&](const auto& c)
+                                                 {
+                                                     return c.target == track_id;
+                                                 });
+
+            connection_vector.erase(erase_iterator, connection_vector.end());
+        }
     }
+    _publish_rt_routes();
 
     ELKLOG_LOG_INFO("Disconnected MIDI port \"{}\" from track ID \"{}\"", midi_input, track_id);
     return MidiDispatcherStatus::OK;
@@ -595,26 +607,26 @@ void MidiDispatcher::send_midi(int port, MidiDataByte data, Time timestamp)
 {
     const int channel = midi::decode_channel(data);
     const int size = static_cast<int>(data.size());
-    /* Dispatch raw midi messages */
+
+    /* Keyboard and raw midi routes are read from a snapshot without locking */
+    RcuSnapshot<RtInputRoutes>::ReadLock rt_routes(_rt_routes_in);
+    const InputConnections* kb_cons = nullptr;
+    if (rt_routes.get() != nullptr && port >= 0 && port < static_cast<int>(rt_routes->size()))
     {
-        std::scoped_lock lock(_raw_routes_in_lock);
+        const auto& routes = (*rt_routes.get())[port];
+        kb_cons = &routes.keyboard;
 
-        const auto& raw_cons_in = _raw_routes_in.find(port);
-        if (raw_cons_in != _raw_routes_in.end())
+        /* Dispatch raw midi messages */
+        for (const auto& c : routes.raw[midi::MidiChannel::OMNI])
         {
-            for (auto c : raw_cons_in->second[midi::MidiChannel::OMNI])
-            {
-                _event_dispatcher->post_event(make_wrapped_midi_event(c, data.data(), size, timestamp));
-            }
-            for (auto c : raw_cons_in->second[channel])
-            {
-                _event_dispatcher->post_event(make_wrapped_midi_event(c, data.data(), size, timestamp));
-            }
+            _send_keyboard_event(make_wrapped_midi_event(c, data.data(), size, timestamp));
+        }
+        for (const auto& c : routes.raw[channel])
+        {
+            _send_keyboard_event(make_wrapped_midi_event(c, data.data(), size, timestamp));
         }
     }
 
-    std::scoped_lock kb_lock(_kb_routes_in_lock);
-
     /* Dispatch decoded midi messages */
     midi::MessageType type = midi::decode_message_type(data);
     switch (type)
@@ -637,19 +649,15 @@ void MidiDispatcher::send_midi(int port, MidiDataByte data, Time timestamp)
                     _event_dispatcher->post_event(make_param_change_event(c, decoded_msg, timestamp));
                 }
             }
-            if (decoded_msg.controller == midi::MOD_WHEEL_CONTROLLER_NO)
+            if (decoded_msg.controller == midi::MOD_WHEEL_CONTROLLER_NO && kb_cons != nullptr)
             {
-                const auto& cons = _kb_routes_in.find(port);
-                if (cons != _kb_routes_in.end())
+                for (const auto& c : (*kb_cons)[midi::MidiChannel::OMNI])
                 {
-                    for (auto c : cons->second[midi::MidiChannel::OMNI])
-                    {
-                        _event_dispatcher->post_event(make_modulation_event(c, decoded_msg, timestamp));
-                    }
-                    for (auto c : cons->second[decoded_msg.channel])
-                    {
-                        _event_dispatcher->post_event(make_modulation_event(c, decoded_msg, timestamp));
-                    }
+                    _send_keyboard_event(make_modulation_event(c, decoded_msg, timestamp));
+                }
+                for (const auto& c : (*kb_cons)[decoded_msg.channel])
+                {
+                    _send_keyboard_event(make_modulation_event(c, decoded_msg, timestamp));
                 }
             }
             break;
@@ -658,16 +666,15 @@ void MidiDispatcher::send_midi(int port, MidiDataByte data, Time timestamp)
         case midi::MessageType::NOTE_ON:
         {
             midi::NoteOnMessage decoded_msg = midi::decode_note_on(data);
-            const auto& cons = _kb_routes_in.find(port);
-            if (cons != _kb_routes_in.end())
+            if (kb_cons != nullptr)
             {
-                for (auto c : cons->second[midi::MidiChannel::OMNI])
+                for (const auto& c : (*kb_cons)[midi::MidiChannel::OMNI])
                 {
-                    _event_dispatcher->post_event(make_note_on_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_note_on_event(c, decoded_msg, timestamp));
                 }
-                for (auto c : cons->second[decoded_msg.channel])
+                for (const auto& c : (*kb_cons)[decoded_msg.channel])
                 {
-                    _event_dispatcher->post_event(make_note_on_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_note_on_event(c, decoded_msg, timestamp));
                 }
             }
             break;
@@ -676,16 +683,15 @@ void MidiDispatcher::send_midi(int port, MidiDataByte data, Time timestamp)
         case midi::MessageType::NOTE_OFF:
         {
             midi::NoteOffMessage decoded_msg = midi::decode_note_off(data);
-            const auto& cons = _kb_routes_in.find(port);
-            if (cons != _kb_routes_in.end())
+            if (kb_cons != nullptr)
             {
-                for (auto c : cons->second[midi::MidiChannel::OMNI])
+                for (const auto& c : (*kb_cons)[midi::MidiChannel::OMNI])
                 {
-                    _event_dispatcher->post_event(make_note_off_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_note_off_event(c, decoded_msg, timestamp));
                 }
-                for (auto c : cons->second[decoded_msg.channel])
+                for (const auto& c : (*kb_cons)[decoded_msg.channel])
                 {
-                    _event_dispatcher->post_event(make_note_off_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_note_off_event(c, decoded_msg, timestamp));
                 }
             }
             break;
@@ -694,16 +700,15 @@ void MidiDispatcher::send_midi(int port, MidiDataByte data, Time timestamp)
         case midi::MessageType::PITCH_BEND:
         {
             midi::PitchBendMessage decoded_msg = midi::decode_pitch_bend(data);
-            const auto& cons = _kb_routes_in.find(port);
-            if (cons != _kb_routes_in.end())
+            if (kb_cons != nullptr)
             {
-                for (auto c : cons->second[midi::MidiChannel::OMNI])
+                for (const auto& c : (*kb_cons)[midi::MidiChannel::OMNI])
                 {
-                    _event_dispatcher->post_event(make_pitch_bend_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_pitch_bend_event(c, decoded_msg, timestamp));
                 }
-                for (auto c : cons->second[decoded_msg.channel])
+                for (const auto& c : (*kb_cons)[decoded_msg.channel])
                 {
-                    _event_dispatcher->post_event(make_pitch_bend_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_pitch_bend_event(c, decoded_msg, timestamp));
                 }
             }
             break;
@@ -712,16 +717,15 @@ void MidiDispatcher::send_midi(int port, MidiDataByte data, Time timestamp)
         case midi::MessageType::POLY_KEY_PRESSURE:
         {
             midi::PolyKeyPressureMessage decoded_msg = midi::decode_poly_key_pressure(data);
-            const auto& cons = _kb_routes_in.find(port);
-            if (cons != _kb_routes_in.end())
+            if (kb_cons != nullptr)
             {
-                for (auto c : cons->second[midi::MidiChannel::OMNI])
+                for (const auto& c : (*kb_cons)[midi::MidiChannel::OMNI])
                 {
-                    _event_dispatcher->post_event(make_note_aftertouch_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_note_aftertouch_event(c, decoded_msg, timestamp));
                 }
-                for (auto c : cons->second[decoded_msg.channel])
+                for (const auto& c : (*kb_cons)[decoded_msg.channel])
                 {
-                    _event_dispatcher->post_event(make_note_aftertouch_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_note_aftertouch_event(c, decoded_msg, timestamp));
                 }
             }
             break;
@@ -730,16 +734,15 @@ void MidiDispatcher::send_midi(int port, MidiDataByte data, Time timestamp)
         case midi::MessageType::CHANNEL_PRESSURE:
         {
             midi::ChannelPressureMessage decoded_msg = midi::decode_channel_pressure(data);
-            const auto& cons = _kb_routes_in.find(port);
-            if (cons != _kb_routes_in.end())
+            if (kb_cons != nullptr)
             {
-                for (auto c : cons->second[midi::MidiChannel::OMNI])
+                for (const auto& c : (*kb_cons)[midi::MidiChannel::OMNI])
                 {
-                    _event_dispatcher->post_event(make_aftertouch_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_aftertouch_event(c, decoded_msg, timestamp));
                 }
-                for (auto c : cons->second[decoded_msg.channel])
+                for (const auto& c : (*kb_cons)[decoded_msg.channel])
                 {
-                    _event_dispatcher->post_event( make_aftertouch_event(c, decoded_msg, timestamp));
+                    _send_keyboard_event(make_aftertouch_event(c, decoded_msg, timestamp));
                 }
             }
             break;
@@ -770,6 +773,40 @@ void MidiDispatcher::send_midi(int port, MidiDataByte data, Time timestamp)
     }
 }
 
+void MidiDispatcher::_send_keyboard_event(const KeyboardEvent& event)
+{
+    // Go directly to the audio thread if possible, the event dispatcher is only used as a fallback
+    if (_engine != nullptr && _engine->send_timed_rt_event(event.to_rt_event(0), event.time()) == engine::EngineReturnStatus::OK)
+    {
+        return;
+    }
+    _event_dispatcher->post_event(std::make_unique<KeyboardEvent>(event));
+}
+
+void MidiDispatcher::_publish_rt_routes()
+{
+    std::scoped_lock lock(_rt_routes_publish_lock, _kb_routes_in_lock, _raw_routes_in_lock);
+    auto routes = std::make_unique<RtInputRoutes>();
+    auto port_routes = [&](int port) -> InputRoutes&
+    {
+        if (port >= static_cast<int>(routes->size()))
+        {
+            routes->resize(port + 1);
+        }
+        return (*routes)[port];
+    };
+
+    for (const auto& [port, connections] : _kb_routes_in)
+    {
+        port_routes(port).keyboard = connections;
+    }
+    for (const auto& [port, connections] : _raw_routes_in)
+    {
+        port_routes(port).raw = connections;
+    }
+    _rt_routes_in.publish(std::move(routes));
+}
+
 int MidiDispatcher::process(Event* event)
 {
     if (event->is_keyboard_event())
@@ -35,11 +35,13 @@
 #include "library/processor.h"
 #include "control_frontends/base_midi_frontend.h"
 #include "library/event_interface.h"
+#include "library/rcu_snapshot.h"
 
 namespace sushi::internal {
 
 namespace engine {
 class BaseProcessorContainer;
+class BaseEngine;
 }
 
 namespace midi_dispatcher {
@@ -115,7 +117,14 @@ class MidiDispatcher : public EventPoster, public midi_receiver::MidiReceiver
     SUSHI_DECLARE_NON_COPYABLE(MidiDispatcher);
 
 public:
-    explicit MidiDispatcher(dispatcher::BaseEventDispatcher* event_dispatcher);
+    /**
+     * @brief Create a MidiDispatcher
+     * @param event_dispatcher The dispatcher to post events to
+     * @param engine If not null, keyboard and raw midi events are sent directly to the
+     *        realtime part of this engine instead of through event_dispatcher
+     */
+    explicit MidiDispatcher(dispatcher::BaseEventDispatcher* event_dispatcher,
+                            engine::BaseEngine* engine = nullptr);
 
     ~MidiDispatcher() override;
 
@@ -372,6 +381,15 @@ private:
     std::vector<CCInputConnection> _get_cc_input_connections(std::optional<int> processor_id_filter);
     std::vector<PCInputConnection> _get_pc_input_connections(std::optional<int> processor_id_filter);
 
+    void _send_keyboard_event(const KeyboardEvent& event);
+
+    /**
+     * @brief Rebuild the snapshot of keyboard and raw midi routes read by send_midi().
+     *        Must be called after every change to _kb_routes_in or _raw_routes_in,
+     *        without holding their locks.
+     */
+    void _publish_rt_routes();
+
     using InputConnections = std::array<std::vector<InputConnection>, midi::MidiChannel::OMNI + 1>;
 
     using KeyboardRoutesIn = std::map<int, InputConnections>;
@@ -386,6 +404,15 @@ private:
     PcRoutes _pc_routes;
     RawRoutesIn _raw_routes_in;
 
+    struct InputRoutes
+    {
+        InputConnections keyboard;
+        InputConnections raw;
+    };
+    // Copy of _kb_routes_in and _raw_routes_in, indexed by midi input
+    using RtInputRoutes = std::vector<InputRoutes>;
+    RcuSnapshot<RtInputRoutes> _rt_routes_in;
+
     int _midi_inputs {0};
     int _midi_outputs {0};
 
@@ -394,11 +421,13 @@ private:
     std::mutex _cc_routes_lock;
     std::mutex _pc_routes_lock;
     std::mutex _raw_routes_in_lock;
+    std::mutex _rt_routes_publish_lock;
 
     std::vector<int> _enabled_clock_out;
 
     midi_frontend::BaseMidiFrontend* _frontend;
     dispatcher::BaseEventDispatcher* _event_dispatcher;
+    engine::BaseEngine* _engine;
 };
 
 } // end namespace midi_dispatcher
@@ -18,28 +18,14 @@
  * @Copyright 2017-2023 Elk Audio AB, Stockholm
  */
 
+#include <algorithm>
+
 #include "parameter_manager.h"
 #include "library/processor.h"
 #include "engine/base_processor_container.h"
 
 namespace sushi::internal {
 
-inline void send_parameter_notification(ObjectId processor_id,
-                                        ObjectId parameter_id,
-                                        float normalized_value,
-                                        float domain_value,
-                                        const std::string& formatted_value,
-                                        dispatcher::BaseEventDispatcher* dispatcher)
-{
-    auto event = std::make_unique<ParameterChangeNotificationEvent>(processor_id,
-                                                                    parameter_id,
-                                                                    normalized_value,
-                                                                    domain_value,
-                                                                    formatted_value,
-                                                                    IMMEDIATE_PROCESS);
-    dispatcher->dispatch(std::move(event));
-}
-
 ParameterManager::ParameterManager(Time update_rate,
                                    const engine::BaseProcessorContainer* processor_container) : _processors(processor_container),
                                                                                                        _update_rate(update_rate)
@@ -47,29 +33,104 @@ ParameterManager::ParameterManager(Time update_rate,
 
 void ParameterManager::track_parameters(ObjectId processor_id)
 {
-    if (auto processor = _processors->processor(processor_id))
+    auto processor = _processors->processor(processor_id);
+    if (processor == nullptr || _processor_entries.count(processor_id) > 0)
     {
-        auto& param_map = _parameters[processor->id()];
+        return;
+    }
 
-        for (const auto& p: processor->all_parameters())
+    const auto& parameters = processor->all_parameters();
+    ProcessorEntry processor_entry{_parameters.size(), parameters.size(), {}};
+
+    /* Ids are unique, so if they are all below the parameter count they are a permutation
+     * of the slots. Otherwise, like for Vst3 plugins where ids are arbitrary 32 bit values,
+     * the slots are looked up by id */
+    bool dense = std::all_of(parameters.begin(), parameters.end(), [&](const auto& p)
+    {
+        return static_cast<size_t>(p->id()) < processor_entry.count;
+    });
+    if (dense == false)
+    {
+        for (size_t i = 0; i < parameters.size(); ++i)
         {
-            auto type = p->type();
-            if (type == ParameterType::BOOL || type == ParameterType::INT || type == ParameterType::FLOAT)
-            {
-                param_map.insert({p->id(), {.value = processor->parameter_value(p->id()).second, .last_update = Time(0)}});
-            }
+            processor_entry.slots[parameters[i]->id()] = i;
         }
     }
+
+    _parameters.resize(processor_entry.offset + processor_entry.count, ParameterEntry{.processor_id = processor_id,
+                                                                                      .parameter_id = 0,
+                                                                                      .value = 0.0f,
+                                                                                      .last_update = Time(0),
+                                                                                      .update_time = Time(0),
+                                                                                      .tracked = false,
+                                                                                      .queued = false});
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        const auto& p = parameters[i];
+        auto& entry = _parameters[processor_entry.offset + (dense ? p->id() : i)];
+        entry.parameter_id = p->id();
+        auto type = p->type();
+        if (type == ParameterType::BOOL || type == ParameterType::INT || type == ParameterType::FLOAT)
+        {
+            entry.value = processor->parameter_value(p->id()).second;
+            entry.tracked = true;
+        }
+    }
+    _processor_entries[processor_id] = std::move(processor_entry);
 }
 
 void ParameterManager::untrack_parameters(ObjectId processor_id)
 {
-    _parameters.erase(processor_id);
+    auto node = _processor_entries.find(processor_id);
+    if (node == _processor_entries.end())
+    {
+        return;
+    }
+    auto offset = node->second.offset;
+    auto count = node->second.count;
+    _processor_entries.erase(node);
+
+    /* Close the gap in the flat parameter table, and move the indexes of everything
+     * after it. This is rare compared to parameter updates so doing it eagerly is fine */
+    _parameters.erase(_parameters.begin() + offset, _parameters.begin() + offset + count);
+    for (auto& [id, entry] : _processor_entries)
+    {
+        if (entry.offset > offset)
+        {
+            entry.offset -= count;
+        }
+    }
+    auto last = std::remove_if(_parameter_change_queue.begin(), _parameter_change_queue.end(),
+                               [&](int i) {return static_cast<size_t>(i) >= offset && static_cast<size_t>(i) < offset + count;});
+    _parameter_change_queue.erase(last, _parameter_change_queue.end());
+    for (auto& i : _parameter_change_queue)
+    {
+        if (static_cast<size_t>(i) > offset)
+        {
+            i -= static_cast<int>(count);
+        }
+    }
 }
 
 void ParameterManager::mark_parameter_changed(ObjectId processor_id, ObjectId parameter_id, Time timestamp)
 {
-    _parameter_change_queue.push_back(ParameterUpdate{processor_id, parameter_id, timestamp});
+    int index = _find_entry(processor_id, parameter_id);
+    if (index < 0)
+    {
+        return;
+    }
+    auto& entry = _parameters[index];
+    if (entry.queued)
+    {
+        // Coalesce with the already queued change and notify when the latest one is due
+        entry.update_time = std::max(entry.update_time, timestamp);
+    }
+    else
+    {
+        entry.update_time = timestamp;
+        entry.queued = true;
+        _parameter_change_queue.push_back(index);
+    }
 }
 
 void ParameterManager::mark_processor_changed(ObjectId processor_id, Time timestamp)
@@ -89,56 +150,49 @@ void ParameterManager::mark_processor_changed(ObjectId processor_id, Time timest
 
 void ParameterManager::output_parameter_notifications(dispatcher::BaseEventDispatcher* dispatcher, Time target_time)
 {
-    _output_processor_notifications(dispatcher, target_time);
-    _output_parameter_notifications(dispatcher, target_time);
+    _output_processor_notifications(target_time);
+    _output_parameter_notifications(target_time);
+
+    if (_batch.empty() == false)
+    {
+        // Copied rather than moved, so that _batch keeps its capacity between calls
+        auto event = std::make_unique<ParameterChangeBatchNotificationEvent>(_batch, IMMEDIATE_PROCESS);
+        dispatcher->dispatch(std::move(event));
+        _batch.clear();
+    }
 }
 
-void ParameterManager::_output_parameter_notifications(dispatcher::BaseEventDispatcher* dispatcher, Time timestamp)
+void ParameterManager::_output_parameter_notifications(Time timestamp)
 {
-    auto i = _parameter_change_queue.begin();
-    auto swap_iter = i;
-    while (i != _parameter_change_queue.end())
+    std::shared_ptr<const Processor> processor;
+    auto keep = _parameter_change_queue.begin();
+    for (auto index : _parameter_change_queue)
     {
-        if (auto proc_node = _parameters.find(i->processor_id); proc_node != _parameters.end())
+        auto& entry = _parameters[index];
+        /* Send update if the update time has passed and the last update was sent
+         * longer than _update_rate ago, otherwise keep it queued and check next time */
+        if (entry.update_time <= timestamp && (entry.last_update + _update_rate) <= timestamp)
         {
-            auto& param_entries = proc_node->second;
-
-            if (const auto& param_node = param_entries.find(i->parameter_id); param_node != param_entries.end())
+            entry.queued = false;
+            // Consecutive changes are commonly from the same processor, avoid looking it up again
+            if (processor == nullptr || processor->id() != entry.processor_id)
             {
-                auto& param_entry = param_node->second;
-                /* Send update if the update time has passed and the last update was sent
-                 * longer than _update_rate ago */
-                if (i->update_time <= timestamp && (param_entry.last_update + _update_rate) <= timestamp)
-                {
-                    if (auto processor = _processors->processor(i->processor_id))
-                    {
-                        float value = processor->parameter_value(i->parameter_id).second;
-                        if (value != param_entry.value)
-                        {
-                            send_parameter_notification(i->processor_id, i->parameter_id, value,
-                                                        processor->parameter_value_in_domain(i->parameter_id).second,
-                                                        processor->parameter_value_formatted(i->parameter_id).second,
-                                                        dispatcher);
-                            param_entry.last_update = timestamp;
-                            param_entry.value = value;
-                        }
-                    }
-                }
-                    /* If this parameter was not a duplicate, but still updated too recently,
-                     * put it at the front of the queue and check next time */
-                else if (param_entry.last_update != timestamp)
-                {
-                    std::iter_swap(i, swap_iter);
-                    swap_iter++;
-                }
+                processor = _processors->processor(entry.processor_id);
+            }
+            if (processor)
+            {
+                _add_if_changed(entry, processor.get(), timestamp);
             }
         }
-        i++;
+        else
+        {
+            *keep++ = index;
+        }
     }
-    _parameter_change_queue.erase(swap_iter, _parameter_change_queue.end());
+    _parameter_change_queue.erase(keep, _parameter_change_queue.end());
 }
 
-void ParameterManager::_output_processor_notifications(dispatcher::BaseEventDispatcher* dispatcher, Time timestamp)
+void ParameterManager::_output_processor_notifications(Time timestamp)
 {
     auto i = _processor_change_queue.begin();
     auto swap_iter = i;
@@ -148,20 +202,16 @@ void ParameterManager::_output_processor_notifications(dispatcher::BaseEventDisp
          * and send a notification anyway, regardless if one was sent recently */
         if (i->update_time <= timestamp)
         {
-            if (auto processor = _processors->processor(i->processor_id))
+            auto processor = _processors->processor(i->processor_id);
+            auto node = _processor_entries.find(i->processor_id);
+            if (processor && node != _processor_entries.end())
             {
-                auto& param_entries = _parameters[i->processor_id];
-                for (auto& p: param_entries)
+                const auto& processor_entry = node->second;
+                for (size_t p = processor_entry.offset; p < processor_entry.offset + processor_entry.count; ++p)
                 {
-                    auto& entry = p.second;
-                    float value = processor->parameter_value(p.first).second;
-                    if (value != entry.value)
+                    if (_parameters[p].tracked)
                     {
-                        send_parameter_notification(i->processor_id, p.first, value,
-                                                    processor->parameter_value_in_domain(p.first).second,
-                                                    processor->parameter_value_formatted(p.first).second, dispatcher);
-                        entry.value = value;
-                        entry.last_update = timestamp;
+                        _add_if_changed(_parameters[p], processor.get(), timestamp);
                     }
                 }
             }
@@ -176,9 +226,54 @@ void ParameterManager::_output_processor_notifications(dispatcher::BaseEventDisp
     _processor_change_queue.erase(swap_iter, _processor_change_queue.end());
 }
 
+int ParameterManager::_find_entry(ObjectId processor_id, ObjectId parameter_id) const
+{
+    auto node = _processor_entries.find(processor_id);
+    if (node == _processor_entries.end())
+    {
+        return -1;
+    }
+    const auto& processor_entry = node->second;
+    size_t slot = parameter_id;
+    if (processor_entry.slots.empty() == false)
+    {
+        auto slot_node = processor_entry.slots.find(parameter_id);
+        if (slot_node == processor_entry.slots.end())
+        {
+            return -1;
+        }
+        slot = slot_node->second;
+    }
+    else if (slot >= processor_entry.count)
+    {
+        return -1;
+    }
+    auto index = processor_entry.offset + slot;
+    return _parameters[index].tracked ? static_cast<int>(index) : -1;
+}
+
+void ParameterManager::_add_if_changed(ParameterEntry& entry, const Processor* processor, Time timestamp)
+{
+    float value = processor->parameter_value(entry.parameter_id).second;
+    if (value != entry.value)
+    {
+        _batch.push_back({.processor_id = entry.processor_id,
+                          .parameter_id = entry.parameter_id,
+                          .normalized_value = value,
+                          .domain_value = processor->parameter_value_in_domain(entry.parameter_id).second});
+        entry.value = value;
+        entry.last_update = timestamp;
+    }
+}
+
 bool ParameterManager::parameter_change_queue_empty() const
 {
     return _parameter_change_queue.empty();
 }
 
-} // end namespace sushi::internal
\ No newline at end of file
+bool ParameterManager::processor_change_queue_empty() const
+{
+    return _processor_change_queue.empty();
+}
+
+} // end namespace sushi::internal
@@ -35,6 +35,7 @@ namespace sushi::internal {
 
 namespace engine {class BaseProcessorContainer;}
 namespace dispatcher {class BaseEventDispatcher;}
+class Processor;
 
 class ParameterManagerAccessor;
 
@@ -76,9 +77,9 @@ public:
     void mark_processor_changed(ObjectId processor_id, Time timestamp);
 
     /**
-     * @brief Output ParameterChangedNotificationEvents for all queued parameter changes up until
-     *        a given timestamp. If a parameter was queued several time, only one notification
-     *        will be sent.
+     * @brief Output a ParameterChangeBatchNotificationEvent with all queued parameter changes
+     *        up until a given timestamp. If a parameter was queued several times, it will
+     *        only be included once.
      * @param dispatcher The dispatcher to send events to.
      * @param target_time All queued updates with a timestamp equal to or lower that this will be processed
      */
@@ -86,24 +87,36 @@ public:
 
     bool parameter_change_queue_empty() const;
 
+    bool processor_change_queue_empty() const;
+
 private:
     friend ParameterManagerAccessor;
 
-    void _output_parameter_notifications(dispatcher::BaseEventDispatcher* dispatcher, Time timestamp);
+    using ParameterChange = ParameterChangeBatchNotificationEvent::ParameterChange;
+
+    void _output_parameter_notifications(Time timestamp);
 
-    void _output_processor_notifications(dispatcher::BaseEventDispatcher* dispatcher, Time timestamp);
+    void _output_processor_notifications(Time timestamp);
 
     struct ParameterEntry
     {
+        ObjectId processor_id;
+        ObjectId parameter_id;
         float value;
         Time last_update;
+        Time update_time;
+        bool tracked;
+        bool queued;
     };
 
-    struct ParameterUpdate
+    // The range in _parameters holding the parameters of one processor, one slot per parameter
+    struct ProcessorEntry
     {
-        ObjectId processor_id;
-        ObjectId parameter_id;
-        Time update_time;
+        size_t offset;
+        size_t count;
+        /* Slot of every parameter id, relative to offset. Empty if the parameter ids are
+         * 0 to count - 1, as for internal plugins, in which case the id is the slot. */
+        std::unordered_map<ObjectId, size_t> slots;
     };
 
     struct ProcessorUpdate
@@ -112,16 +125,24 @@ private:
         Time update_time;
     };
 
-    using Parameters = std::unordered_map<ObjectId, std::unordered_map<ObjectId, ParameterEntry>>;
+    int _find_entry(ObjectId processor_id, ObjectId parameter_id) const;
+
+    void _add_if_changed(ParameterEntry& entry, const Processor* processor, Time timestamp);
 
     std::vector<ProcessorUpdate> _processor_change_queue;
-    std::vector<ParameterUpdate> _parameter_change_queue;
+
+    // Indexes into _parameters, every parameter is queued at most once
+    std::vector<int> _parameter_change_queue;
+
+    // Changes to include in the next batch notification
+    std::vector<ParameterChange> _batch;
 
     const engine::BaseProcessorContainer* _processors;
     Time _update_rate;
 
     // Note this is only accessed from the event loop thread, so no mutex is needed
-    Parameters _parameters;
+    std::vector<ParameterEntry> _parameters;
+    std::unordered_map<ObjectId, ProcessorEntry> _processor_entries;
 };
 
 } // end namespace sushi::internal
@@ -18,7 +18,8 @@
  * @Copyright 2017-2023 Elk Audio AB, Stockholm
  */
 
-#include <thread>
+#include <algorithm>
+#include <cassert>
 
 #include "elklog/static_logger.h"
 
@@ -28,43 +29,162 @@ ELKLOG_GET_LOGGER_WITH_MODULE_NAME("event_receiver");
 
 namespace sushi::internal::receiver {
 
-constexpr int MAX_RETRIES = 100;
+constexpr uint64_t RESPONSE_ID_MASK = 0xFFFF;
+constexpr uint64_t RESPONSE_WAITING = 1u << 16;
+constexpr uint64_t RESPONSE_RECEIVED = 1u << 17;
+constexpr uint64_t RESPONSE_HANDLED_OK = 1u << 18;
+constexpr int GENERATION_SHIFT = 32;
 
-bool AsynchronousEventReceiver::wait_for_response(EventId id, std::chrono::milliseconds timeout)
+// Only used if no RtConditionVariable could be created
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(2);
+
+static_assert((RESPONSE_TABLE_SIZE & (RESPONSE_TABLE_SIZE - 1)) == 0, "Table size must be a power of 2");
+
+inline uint64_t slot_value(uint32_t generation, uint64_t state)
+{
+    return (static_cast<uint64_t>(generation) << GENERATION_SHIFT) | state;
+}
+
+inline uint32_t slot_generation(uint64_t value)
+{
+    return static_cast<uint32_t>(value >> GENERATION_SHIFT);
+}
+
+AsynchronousEventReceiver::AsynchronousEventReceiver()
+{
+    for (auto& response : _responses)
+    {
+        response.store(0);
+    }
+    try
+    {
+        _rt_notifier = twine::RtConditionVariable::create_rt_condition_variable();
+    }
+    catch ([[maybe_unused]] const std::exception& e)
+    {
+        ELKLOG_LOG_ERROR("Failed to instantiate RtConditionVariable ({}), falling back to polling", e.what());
+    }
+    if (_rt_notifier)
+    {
+        _running = true;
+        _relay_thread = std::thread(&AsynchronousEventReceiver::_relay_loop, this);
+    }
+}
+
+AsynchronousEventReceiver::~AsynchronousEventReceiver()
+{
+    if (_running)
+    {
+        _running = false;
+        _rt_notifier->notify();
+        _relay_thread.join();
+    }
+}
+
+ResponseTicket AsynchronousEventReceiver::expect_response(EventId id)
+{
+    auto& slot = _responses[id & (RESPONSE_TABLE_SIZE - 1)];
+    uint64_t current = slot.load(std::memory_order_acquire);
+    uint64_t waiting;
+    do
+    {
+        waiting = slot_value(slot_generation(current) + 1, id | RESPONSE_WAITING);
+    }
+    while (slot.compare_exchange_weak(current, waiting, std::memory_order_acq_rel) == false);
+
+    ELKLOG_LOG_WARNING_IF(current & RESPONSE_WAITING, "RtEvent with id {} replaced the wait for RtEvent with id {}",
+                          id, current & RESPONSE_ID_MASK);
+    return {id, slot_generation(waiting)};
+}
+
+void AsynchronousEventReceiver::notify_response(const RtEvent& event)
 {
-    int retries = 0;
-    while (retries < MAX_RETRIES)
+    assert(is_returnable_event(event));
+    auto typed_event = event.returnable_event();
+    EventId id = typed_event->event_id();
+    auto& slot = _responses[id & (RESPONSE_TABLE_SIZE - 1)];
+
+    // Responses to events that no thread waits for, or has stopped waiting for, are dropped
+    uint64_t current = slot.load(std::memory_order_acquire);
+    if ((current & RESPONSE_WAITING) == 0 || (current & RESPONSE_ID_MASK) != id)
+    {
+        return;
+    }
+    uint64_t response = (current & ~RESPONSE_WAITING) | RESPONSE_RECEIVED;
+    if (typed_event->status() == ReturnableRtEvent::EventStatus::HANDLED_OK)
     {
-        RtEvent event;
-        while (_queue->pop(event))
+        response |= RESPONSE_HANDLED_OK;
+    }
+    // Fails if the wait was cancelled or replaced since the slot was read
+    if (slot.compare_exchange_strong(current, response, std::memory_order_acq_rel) && _rt_notifier)
+    {
+        _rt_notifier->notify();
+    }
+}
+
+bool AsynchronousEventReceiver::wait_for_response(ResponseTicket ticket, std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    std::unique_lock lock(_wait_lock);
+    auto result = _take_response(ticket);
+    while (result == TakeResult::PENDING)
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
         {
-            if (is_returnable_event(event))
+            auto waiting = slot_value(ticket.generation, ticket.id | RESPONSE_WAITING);
+            auto& slot = _responses[ticket.id & (RESPONSE_TABLE_SIZE - 1)];
+            if (slot.compare_exchange_strong(waiting, slot_value(ticket.generation, 0), std::memory_order_acq_rel))
             {
-                auto typed_event = event.returnable_event();
-                if (typed_event->event_id() == id)
-                {
-                    auto handled_ok = typed_event->status() == ReturnableRtEvent::EventStatus::HANDLED_OK;
-                    ELKLOG_LOG_ERROR_IF(handled_ok == false, "RtEvent with id {} returned with error", id);
-                    return handled_ok;
-                }
-                bool status = (typed_event->status() == ReturnableRtEvent::EventStatus::HANDLED_OK);
-                _receive_list.push_back(Node{typed_event->event_id(), status});
+                ELKLOG_LOG_WARNING("Waiting for RtEvent with id {} timed out", ticket.id);
+                return false;
             }
+            // The response arrived just before the wait could be cancelled
+            result = _take_response(ticket);
+            break;
         }
-        for (auto i = _receive_list.begin(); i != _receive_list.end(); ++i)
+        _response_notifier.wait_until(lock, _rt_notifier ? deadline : std::min(deadline, now + POLL_INTERVAL));
+        result = _take_response(ticket);
+    }
+
+    ELKLOG_LOG_ERROR_IF(result == TakeResult::LOST, "Wait for RtEvent with id {} was replaced by another event", ticket.id);
+    ELKLOG_LOG_ERROR_IF(result == TakeResult::HANDLED_ERROR, "RtEvent with id {} returned with error", ticket.id);
+    return result == TakeResult::HANDLED_OK;
+}
+
+AsynchronousEventReceiver::TakeResult AsynchronousEventReceiver::_take_response(ResponseTicket ticket)
+{
+    auto& slot = _responses[ticket.id & (RESPONSE_TABLE_SIZE - 1)];
+    uint64_t response = slot.load(std::memory_order_acquire);
+    if (slot_generation(response) != ticket.generation || (response & RESPONSE_ID_MASK) != ticket.id)
+    {
+        return TakeResult::LOST;
+    }
+    if (response & RESPONSE_WAITING)
+    {
+        return TakeResult::PENDING;
+    }
+    // Clear the slot, keeping the generation so that the next wait in the slot gets a new one
+    if ((response & RESPONSE_RECEIVED) == 0 ||
+        slot.compare_exchange_strong(response, slot_value(ticket.generation, 0), std::memory_order_acq_rel) == false)
+    {
+        return TakeResult::LOST;
+    }
+    return (response & RESPONSE_HANDLED_OK) ? TakeResult::HANDLED_OK : TakeResult::HANDLED_ERROR;
+}
+
+void AsynchronousEventReceiver::_relay_loop()
+{
+    while (_running)
+    {
+        _rt_notifier->wait();
         {
-            if (i->id == id)
-            {
-                bool status = i->status;
-                _receive_list.erase(i);
-                return status;
-            }
+            // Waiting threads check their slot with the lock held, so none of them can miss this
+            std::scoped_lock lock(_wait_lock);
         }
-        std::this_thread::sleep_for(timeout / MAX_RETRIES);
-        retries++;
+        _response_notifier.notify_all();
     }
-    ELKLOG_LOG_WARNING("Waiting for RtEvent with id {} timed out", id);
-    return false;
 }
 
 } // end namespace sushi::internal::receiver
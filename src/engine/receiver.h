@@ -21,35 +21,95 @@
 #ifndef SUSHI_ASYNCHRONOUS_RECEIVER_H
 #define SUSHI_ASYNCHRONOUS_RECEIVER_H
 
-#include <vector>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "twine/twine.h"
+
+#include "sushi/constants.h"
 
 #include "library/id_generator.h"
-#include "library/rt_event_fifo.h"
+#include "library/rt_event.h"
 
 namespace sushi::internal::receiver {
 
+/* Number of slots in the response table. Responses are stored in the slot given by
+ * their EventId, so this limits how many events can be waited for at the same time */
+constexpr int RESPONSE_TABLE_SIZE = 1024;
+
+/**
+ * @brief Identifies a thread waiting for the response to an event. The generation
+ *        tells apart successive waits that use the same slot in the response table.
+ */
+struct ResponseTicket
+{
+    EventId  id;
+    uint32_t generation;
+};
+
 class AsynchronousEventReceiver
 {
 public:
-    explicit AsynchronousEventReceiver(RtSafeRtEventFifo* queue) : _queue{queue} {}
+    SUSHI_DECLARE_NON_COPYABLE(AsynchronousEventReceiver);
+
+    AsynchronousEventReceiver();
+
+    ~AsynchronousEventReceiver();
+
+    /**
+     * @brief Register that the calling thread is going to wait for the response to an
+     *        event. Must be called before the event is sent, as responses to events that
+     *        no thread is waiting for are dropped.
+     * @param id EventId of the event
+     * @return A ticket to pass to wait_for_response()
+     */
+    ResponseTicket expect_response(EventId id);
+
+    /**
+     * @brief Store the response to a returnable event and wake up the thread waiting
+     *        for it. Called from the rt thread, does not allocate, block or take locks.
+     * @param event The returnable event that was handled
+     */
+    void notify_response(const RtEvent& event);
 
     /**
      * @brief Blocks the current thread while waiting for a response to a given event
-     * @param id EventId of the event the thread is waiting for
+     * @param ticket The ticket returned by expect_response() for the event
      * @param timeout Maximum wait time
      * @return true if the event was received in time and handled properly, false otherwise
      */
-    bool wait_for_response(EventId id, std::chrono::milliseconds timeout);
+    bool wait_for_response(ResponseTicket ticket, std::chrono::milliseconds timeout);
 
 private:
-    struct Node
+    enum class TakeResult
     {
-        EventId id;
-        bool    status;
+        PENDING,
+        HANDLED_OK,
+        HANDLED_ERROR,
+        LOST
     };
-    std::vector<Node> _receive_list;
-    RtSafeRtEventFifo* _queue;
+
+    TakeResult _take_response(ResponseTicket ticket);
+
+    void _relay_loop();
+
+    /* Every slot packs the generation, the EventId and the state of a wait into one
+     * word, so that both sides can check and update it atomically */
+    std::array<std::atomic<uint64_t>, RESPONSE_TABLE_SIZE> _responses;
+
+    /* The rt thread can not notify a std::condition_variable safely, it notifies a relay
+     * thread which wakes up the waiting threads. If nullptr, waiting threads poll instead */
+    std::unique_ptr<twine::RtConditionVariable> _rt_notifier;
+    std::atomic<bool> _running{false};
+    std::thread _relay_thread;
+
+    std::mutex _wait_lock;
+    std::condition_variable _response_notifier;
 };
 
 } // end namespace sushi::internal::receiver
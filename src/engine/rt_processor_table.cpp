@@ -0,0 +1,172 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Compact lookup of processors by id for the realtime part of the engine
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "elklog/static_logger.h"
+
+#include "rt_processor_table.h"
+
+namespace sushi::internal::engine {
+
+ELKLOG_GET_LOGGER_WITH_MODULE_NAME("engine");
+
+/* The table is grown when it is half full, and insertions are refused when it is
+ * 3/4 full so that probe sequences stay short and lookups always terminate */
+constexpr int GROW_LOAD_FACTOR_DIVISOR = 2;
+constexpr int MAX_LOAD_FACTOR_NUMERATOR = 3;
+constexpr int MAX_LOAD_FACTOR_DENOMINATOR = 4;
+
+RtProcessorTable::RtProcessorTable(int initial_size)
+{
+    // Round up to a power of 2
+    int size = 1;
+    while (size < initial_size)
+    {
+        size *= 2;
+    }
+    _storage = new Storage(size);
+    _capacity = size;
+}
+
+RtProcessorTable::~RtProcessorTable()
+{
+    delete _storage;
+    delete _pending_storage.load();
+    delete _retired_storage.load();
+}
+
+bool RtProcessorTable::insert(Processor* processor)
+{
+    assert(processor);
+    if (_pending_storage.load(std::memory_order_acquire))
+    {
+        _swap_in_pending_storage();
+    }
+    int size = _size.load(std::memory_order_relaxed);
+    if ((size + 1) * MAX_LOAD_FACTOR_DENOMINATOR > capacity() * MAX_LOAD_FACTOR_NUMERATOR)
+    {
+        // Logging is not realtime safe, the failure is reported from prepare_insert() instead
+        _failed_inserts.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (_insert_entry(*_storage, {processor->id(), processor}) == false)
+    {
+        return false;
+    }
+    _size.store(size + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool RtProcessorTable::remove(ObjectId id)
+{
+    auto& storage = *_storage;
+    auto mask = storage.mask;
+    auto i = _hash(id) & mask;
+    while (storage.entries[i].id != id)
+    {
+        if (storage.entries[i].processor == nullptr)
+        {
+            return false;
+        }
+        i = (i + 1) & mask;
+    }
+    if (storage.entries[i].processor == nullptr)
+    {
+        return false;
+    }
+
+    /* Backward shift deletion, move up any following entries that would otherwise
+     * become unreachable, this way no tombstones are needed */
+    auto empty = i;
+    for (auto j = (i + 1) & mask; storage.entries[j].processor != nullptr; j = (j + 1) & mask)
+    {
+        auto home = _hash(storage.entries[j].id) & mask;
+        // Move the entry if its home slot is not cyclically within (empty, j]
+        if (((j - home) & mask) >= ((j - empty) & mask))
+        {
+            storage.entries[empty] = storage.entries[j];
+            empty = j;
+        }
+    }
+    storage.entries[empty] = Entry();
+    _size.store(_size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    return true;
+}
+
+void RtProcessorTable::prepare_insert(int count)
+{
+    std::scoped_lock lock(_prepare_lock);
+    delete _retired_storage.exchange(nullptr, std::memory_order_acquire);
+
+    int failed_inserts = _failed_inserts.exchange(0, std::memory_order_relaxed);
+    ELKLOG_LOG_ERROR_IF(failed_inserts > 0, "{} processors were not inserted in the realtime part, "
+                                            "the processor table was full", failed_inserts);
+
+    int capacity = std::max(_capacity.load(), _pending_storage.load() ? static_cast<int>(_pending_storage.load()->entries.size()) : 0);
+    if ((_size.load() + count) * GROW_LOAD_FACTOR_DIVISOR > capacity)
+    {
+        int new_capacity = capacity * 2;
+        while ((_size.load() + count) * GROW_LOAD_FACTOR_DIVISOR > new_capacity)
+        {
+            new_capacity *= 2;
+        }
+        auto new_storage = new Storage(new_capacity);
+        /* If the previously prepared storage was not swapped in yet it is still owned
+         * by this thread and can safely be replaced */
+        delete _pending_storage.exchange(new_storage, std::memory_order_acq_rel);
+    }
+}
+
+bool RtProcessorTable::_insert_entry(Storage& storage, const Entry& entry)
+{
+    for (auto i = _hash(entry.id) & storage.mask; ; i = (i + 1) & storage.mask)
+    {
+        auto& slot = storage.entries[i];
+        if (slot.processor == nullptr)
+        {
+            slot = entry;
+            return true;
+        }
+        if (slot.id == entry.id)
+        {
+            return false;
+        }
+    }
+}
+
+void RtProcessorTable::_swap_in_pending_storage()
+{
+    auto new_storage = _pending_storage.exchange(nullptr, std::memory_order_acq_rel);
+    for (const auto& entry : _storage->entries)
+    {
+        if (entry.processor)
+        {
+            _insert_entry(*new_storage, entry);
+        }
+    }
+    auto old_storage = _storage;
+    _storage = new_storage;
+    _capacity.store(static_cast<int>(new_storage->entries.size()), std::memory_order_relaxed);
+    _retired_storage.store(old_storage, std::memory_order_release);
+}
+
+} // end namespace sushi::internal::engine
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Compact lookup of processors by id for the realtime part of the engine
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_RT_PROCESSOR_TABLE_H
+#define SUSHI_RT_PROCESSOR_TABLE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "library/id_generator.h"
+#include "library/processor.h"
+
+namespace sushi::internal::engine {
+
+constexpr int DEFAULT_RT_PROCESSOR_TABLE_SIZE = 256;
+
+/**
+ * @brief Open addressing hash table mapping processor ids to processors.
+ *
+ *        Lookups, insertions and removals are realtime safe, and must all be done from
+ *        the same thread, i.e. the audio thread when the engine is running. Memory is
+ *        only allocated in prepare_insert(), which must be called from a non-rt thread
+ *        before every insertion. When the table is getting full, prepare_insert() allocates
+ *        a larger table that the next call to insert() moves the entries to and swaps in.
+ *        The old table is freed in a later call to prepare_insert().
+ */
+class RtProcessorTable
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(RtProcessorTable);
+
+    explicit RtProcessorTable(int initial_size = DEFAULT_RT_PROCESSOR_TABLE_SIZE);
+
+    ~RtProcessorTable();
+
+    /**
+     * @brief Look up a processor. Realtime safe.
+     * @param id The id of the processor
+     * @return A pointer to the processor if found, nullptr otherwise
+     */
+    Processor* find(ObjectId id) const
+    {
+        const auto& storage = *_storage;
+        for (auto i = _hash(id) & storage.mask; ; i = (i + 1) & storage.mask)
+        {
+            const auto& entry = storage.entries[i];
+            if (entry.processor == nullptr || entry.id == id)
+            {
+                return entry.processor;
+            }
+        }
+    }
+
+    /**
+     * @brief Add a processor. Realtime safe, provided that prepare_insert() was called first.
+     *        Insertions refused because the table is full are counted and logged by the
+     *        next call to prepare_insert(), as they mean that prepare_insert() was not called.
+     * @param processor The processor to add
+     * @return true if the processor was added, false if a processor with the same id
+     *         is already in the table or if the table is full
+     */
+    bool insert(Processor* processor);
+
+    /**
+     * @brief Remove a processor. Realtime safe.
+     * @param id The id of the processor to remove
+     * @return true if the processor was found and removed, false otherwise
+     */
+    bool remove(ObjectId id);
+
+    /**
+     * @brief Make sure that the next calls to insert() do not run out of space.
+     *        Not realtime safe, must be called from a non-rt thread.
+     * @param count The number of processors that will be inserted
+     */
+    void prepare_insert(int count = 1);
+
+    /**
+     * @brief The number of processors in the table
+     */
+    int size() const
+    {
+        return _size.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief The number of slots currently allocated for the table.
+     */
+    int capacity() const
+    {
+        return _capacity.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief The number of insertions refused because the table was full, since the
+     *        last call to prepare_insert().
+     */
+    int failed_inserts() const
+    {
+        return _failed_inserts.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry
+    {
+        ObjectId   id{0};
+        Processor* processor{nullptr};
+    };
+
+    struct Storage
+    {
+        explicit Storage(int size) : entries(static_cast<size_t>(size)), mask(static_cast<uint32_t>(size - 1)) {}
+
+        std::vector<Entry> entries;
+        uint32_t mask;
+    };
+
+    static uint32_t _hash(ObjectId id)
+    {
+        /* Multiplying with an odd constant is a bijection modulo the table size, so
+         * the mostly sequential processor ids rarely collide */
+        return static_cast<uint32_t>(id) * 2654435769u;
+    }
+
+    static bool _insert_entry(Storage& storage, const Entry& entry);
+
+    void _swap_in_pending_storage();
+
+    Storage* _storage;
+    std::atomic<Storage*> _pending_storage{nullptr};
+    std::atomic<Storage*> _retired_storage{nullptr};
+    std::atomic<int> _size{0};
+    std::atomic<int> _capacity{0};
+    std::atomic<int> _failed_inserts{0};
+
+    std::mutex _prepare_lock;
+};
+
+} // end namespace sushi::internal::engine
+
+#endif // SUSHI_RT_PROCESSOR_TABLE_H
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Publishes meters, transport and timing data to a memory mapped file
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "elklog/static_logger.h"
+
+#include "telemetry_publisher.h"
+
+namespace sushi::internal::engine {
+
+ELKLOG_GET_LOGGER_WITH_MODULE_NAME("telemetry");
+
+constexpr float CLIP_LEVEL = 1.0f;
+
+TelemetryPublisher::~TelemetryPublisher()
+{
+    close();
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+
+bool TelemetryPublisher::open(const std::string& path)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        ELKLOG_LOG_ERROR("Failed to open telemetry file {}: {}", path, strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, sizeof(TelemetryData)) != 0)
+    {
+        ELKLOG_LOG_ERROR("Failed to set size of telemetry file {}: {}", path, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    void* memory = mmap(nullptr, sizeof(TelemetryData), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED)
+    {
+        ELKLOG_LOG_ERROR("Failed to map telemetry file {}: {}", path, strerror(errno));
+        return false;
+    }
+    // Keep the pages resident so the audio thread never page faults when writing
+    if (mlock(memory, sizeof(TelemetryData)) != 0)
+    {
+        ELKLOG_LOG_WARNING("Failed to lock telemetry file {} in memory", path);
+    }
+
+    _data = static_cast<TelemetryData*>(memory);
+    std::memset(_data, 0, sizeof(TelemetryData));
+    _data->version = TELEMETRY_VERSION;
+    std::atomic_ref<uint32_t>(_data->magic).store(TELEMETRY_MAGIC, std::memory_order_release);
+    ELKLOG_LOG_INFO("Publishing telemetry to {}", path);
+    return true;
+}
+
+void TelemetryPublisher::close()
+{
+    if (_data)
+    {
+        munlock(_data, sizeof(TelemetryData));
+        munmap(_data, sizeof(TelemetryData));
+        _data = nullptr;
+    }
+}
+
+#else
+
+bool TelemetryPublisher::open(const std::string& path)
+{
+    ELKLOG_LOG_ERROR("Telemetry is not supported on this platform, not publishing to {}", path);
+    return false;
+}
+
+void TelemetryPublisher::close() {}
+
+#endif
+
+void TelemetryPublisher::set_sample_rate(float sample_rate)
+{
+    _period_ns = AUDIO_CHUNK_SIZE * 1'000'000'000.0f / sample_rate;
+}
+
+void TelemetryPublisher::measure_input_rt(const ChunkSampleBuffer& in)
+{
+    _input_channels = _calc_peaks(_input_peaks, in);
+}
+
+void TelemetryPublisher::publish_rt(const ChunkSampleBuffer& out,
+                                    const Transport& transport,
+                                    const AudioGraph& graph,
+                                    std::chrono::nanoseconds process_time)
+{
+    if (_data == nullptr)
+    {
+        return;
+    }
+
+    ChannelPeaks output_peaks;
+    int output_channels = _calc_peaks(output_peaks, out);
+
+    // The sequence is odd while writing, readers retry if it is odd or has changed
+    std::atomic_ref<uint32_t> sequence(_data->sequence);
+    auto current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _update_channels(_data->inputs, _input_peaks, _input_channels);
+    _data->input_channels = _input_channels;
+    _update_channels(_data->outputs, output_peaks, output_channels);
+    _data->output_channels = output_channels;
+
+    _data->period++;
+    _data->timestamp = transport.current_process_time().count();
+    _data->sample_count = transport.current_samples();
+    _data->beats = transport.current_beats();
+    _data->bar_beats = transport.current_bar_beats();
+    _data->tempo = transport.current_tempo();
+    _data->playing_mode = static_cast<uint32_t>(transport.playing_mode());
+    _data->engine_load = static_cast<float>(process_time.count()) / _period_ns;
+
+    uint32_t nodes = 0;
+    graph.for_each_render_time([&](const Track* track, float render_time)
+    {
+        if (nodes < TELEMETRY_MAX_NODES)
+        {
+            _data->nodes[nodes++] = {static_cast<uint32_t>(track->id()), render_time / _period_ns};
+        }
+    });
+    _data->node_count = nodes;
+
+    sequence.store(current + 2, std::memory_order_release);
+}
+
+int TelemetryPublisher::_calc_peaks(ChannelPeaks& peaks, const ChunkSampleBuffer& buffer)
+{
+    int channel_count = std::min(buffer.channel_count(), TELEMETRY_MAX_CHANNELS);
+    for (int c = 0; c < channel_count; ++c)
+    {
+        peaks[c] = buffer.calc_peak_value(c);
+    }
+    return channel_count;
+}
+
+void TelemetryPublisher::_update_channels(TelemetryChannel* channels, const ChannelPeaks& peaks, int channel_count)
+{
+    for (int c = 0; c < channel_count; ++c)
+    {
+        channels[c].peak = peaks[c];
+        if (peaks[c] >= CLIP_LEVEL)
+        {
+            channels[c].clip_count++;
+        }
+    }
+}
+
+} // end namespace sushi::internal::engine
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Publishes meters, transport and timing data to a memory mapped file
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_TELEMETRY_PUBLISHER_H
+#define SUSHI_TELEMETRY_PUBLISHER_H
+
+#include <array>
+#include <chrono>
+#include <string>
+
+#include "sushi/constants.h"
+#include "sushi/sample_buffer.h"
+#include "sushi/telemetry.h"
+
+#include "engine/audio_graph.h"
+#include "engine/transport.h"
+
+namespace sushi::internal::engine {
+
+/**
+ * @brief Writes the state of the engine to a memory mapped file at the end of every
+ *        period, so that local UIs and monitoring tools can read meters and timings
+ *        directly, without any events, notifications or system calls. See
+ *        sushi/telemetry.h for the layout of the file and how to read it.
+ */
+class TelemetryPublisher
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(TelemetryPublisher);
+
+    TelemetryPublisher() = default;
+
+    ~TelemetryPublisher();
+
+    /**
+     * @brief Create the file and map it into memory
+     * @param path Path of the file, preferably on a memory backed file system, i.e. /dev/shm
+     * @return true if successful, false otherwise
+     */
+    bool open(const std::string& path);
+
+    void close();
+
+    bool is_open() const {return _data != nullptr;}
+
+    void set_sample_rate(float sample_rate);
+
+    /**
+     * @brief Measure the input of the engine for the current period. Called from the audio
+     *        thread before any tracks are rendered, as the audio frontend may pass the same
+     *        buffer as input and output.
+     * @param in The engine's audio input
+     */
+    void measure_input_rt(const ChunkSampleBuffer& in);
+
+    /**
+     * @brief Publish the state of the engine for the current period. Called from the
+     *        audio thread after all tracks are rendered. Input levels are the ones from
+     *        the last call to measure_input_rt().
+     * @param out The engine's audio output
+     * @param transport The engine's transport
+     * @param graph The audio graph, must measure render times
+     * @param process_time Time spent processing the current period
+     */
+    void publish_rt(const ChunkSampleBuffer& out,
+                    const Transport& transport,
+                    const AudioGraph& graph,
+                    std::chrono::nanoseconds process_time);
+
+private:
+    using ChannelPeaks = std::array<float, TELEMETRY_MAX_CHANNELS>;
+
+    static int _calc_peaks(ChannelPeaks& peaks, const ChunkSampleBuffer& buffer);
+
+    static void _update_channels(TelemetryChannel* channels, const ChannelPeaks& peaks, int channel_count);
+
+    TelemetryData* _data{nullptr};
+    float          _period_ns{1.0f};
+    ChannelPeaks   _input_peaks{};
+    int            _input_channels{0};
+};
+
+} // end namespace sushi::internal::engine
+
+#endif // SUSHI_TELEMETRY_PUBLISHER_H
@@ -45,16 +45,23 @@ inline std::pair<float, float> calc_l_r_gain(float gain, float pan)
     return {left_gain, right_gain};
 }
 
+inline ChunkSampleBuffer allocate_buffer(BufferArena* arena, int channels)
+{
+    return arena ? arena->allocate(channels) : ChunkSampleBuffer(channels);
+}
+
 Track::Track(HostControl host_control,
              int channels,
              performance::PerformanceTimer* timer,
              bool pan_controls,
-             TrackType type) : InternalPlugin(host_control),
-                                  _input_buffer{std::max(channels, 2)},
-                                  _output_buffer{std::max(channels, 2)},
-                                  _buses{1},
-                                  _type{type},
-                                  _timer{timer}
+             TrackType type,
+             std::shared_ptr<BufferArena> arena) : InternalPlugin(host_control),
+                                                   _buffer_arena{std::move(arena)},
+                                                   _input_buffer{allocate_buffer(_buffer_arena.get(), std::max(channels, 2))},
+                                                   _output_buffer{allocate_buffer(_buffer_arena.get(), std::max(channels, 2))},
+                                                   _buses{1},
+                                                   _type{type},
+                                                   _timer{timer}
 {
     _max_input_channels = channels;
     _max_output_channels = std::max(channels, 2);
@@ -63,12 +70,16 @@ Track::Track(HostControl host_control,
     _common_init((pan_controls && channels <= 2) ? PanMode::PAN_AND_GAIN : PanMode::GAIN_ONLY);
 }
 
-Track::Track(HostControl host_control, int buses, performance::PerformanceTimer* timer) : InternalPlugin(host_control),
-                                                                                          _input_buffer{buses * 2},
-                                                                                          _output_buffer{buses * 2},
-                                                                                          _buses{buses},
-                                                                                          _type{TrackType::REGULAR},
-                                                                                          _timer{timer}
+Track::Track(HostControl host_control,
+             int buses,
+             performance::PerformanceTimer* timer,
+             std::shared_ptr<BufferArena> arena) : InternalPlugin(host_control),
+                                                   _buffer_arena{std::move(arena)},
+                                                   _input_buffer{allocate_buffer(_buffer_arena.get(), buses * 2)},
+                                                   _output_buffer{allocate_buffer(_buffer_arena.get(), buses * 2)},
+                                                   _buses{buses},
+                                                   _type{TrackType::REGULAR},
+                                                   _timer{timer}
 {
     int channels = buses * 2;
     _max_input_channels = channels;
@@ -78,6 +89,15 @@ Track::Track(HostControl host_control, int buses, performance::PerformanceTimer*
     _common_init(PanMode::PAN_AND_GAIN_PER_BUS);
 }
 
+Track::~Track()
+{
+    if (_buffer_arena)
+    {
+        _buffer_arena->release(_input_buffer);
+        _buffer_arena->release(_output_buffer);
+    }
+}
+
 ProcessorReturnCode Track::init(float sample_rate)
 {
     this->configure(sample_rate);
@@ -126,6 +146,7 @@ bool Track::add(Processor* processor, std::optional<ObjectId> before_position)
     {
         processor->set_event_output(this);
         processor->set_active_rt_processing(true);
+        notify_audio_routing_changed();
     }
     return added;
 }
@@ -138,7 +159,9 @@ bool Track::remove(ObjectId processor)
         {
             (*i)->set_event_output(nullptr);
             (*i)->set_active_rt_processing(false);
+            (*i)->set_senders_processed_before(false);
             _processors.erase(i);
+            notify_audio_routing_changed();
             return true;
         }
     }
@@ -147,8 +170,16 @@ bool Track::remove(ObjectId processor)
 
 void Track::render()
 {
-    process_audio(_input_buffer, _output_buffer);
-    _input_buffer.clear();
+    if (_input_alias.channel_count() > 0)
+    {
+        process_audio(_input_alias, _output_buffer);
+        _input_alias = ChunkSampleBuffer();
+    }
+    else
+    {
+        process_audio(_input_buffer, _output_buffer);
+        _input_buffer.clear();
+    }
 }
 
 void Track::process_audio(const ChunkSampleBuffer& in, ChunkSampleBuffer& out)
@@ -161,15 +192,17 @@ void Track::process_audio(const ChunkSampleBuffer& in, ChunkSampleBuffer& out)
     /* Process all the plugins in the chain, to guarantee that memory declared const is never
      * written to, the const cast below is only done if in already points to _input_buffer
      * (which is the case if process_audio() is called from render()), or if there is max 1
-     * plugin in the chain, in which case there will be no ping-pong copying between buffers. */
+     * plugin in the chain, in which case there will be no ping-pong copying between buffers.
+     * Otherwise the first plugin reads from in and writes to _input_buffer, and the rest of
+     * the chain ping-pongs between _input_buffer and out, so in is never copied. */
     if (in.channel(0) == _input_buffer.channel(0) || _processors.size() <= 1)
     {
         _process_plugins(const_cast<ChunkSampleBuffer&>(in), out);
     }
     else
     {
-        _input_buffer.replace(in);
-        _process_plugins(_input_buffer, out);
+        _process_plugin(_processors.front(), in, _input_buffer);
+        _process_plugins(_input_buffer, out, 1);
     }
 
     /* If there are keyboard events not consumed, pass them on upwards so the engine can process them */
@@ -275,37 +308,17 @@ void Track::_common_init(PanMode mode)
     }
 }
 
-void Track::_process_plugins(ChunkSampleBuffer& in, ChunkSampleBuffer& out)
+void Track::_process_plugins(ChunkSampleBuffer& in, ChunkSampleBuffer& out, size_t first_processor)
 {
     /* Alias the buffers, so we can swap them cheaply, without copying the underlying data */
 
     ChunkSampleBuffer aliased_in = ChunkSampleBuffer::create_non_owning_buffer(in);
     ChunkSampleBuffer aliased_out = ChunkSampleBuffer::create_non_owning_buffer(out);
 
-    for (auto &processor : _processors)
+    for (auto i = first_processor; i < _processors.size(); ++i)
     {
-        auto processor_timestamp = _timer->start_timer();
-        /* Note that processors can put events back into this queue, hence we're not draining the queue
-         * but checking the size first to avoid an infinite loop */
-        for (int kb_events = _kb_event_buffer.size(); kb_events > 0; --kb_events)
-        {
-            processor->process_event(_kb_event_buffer.pop());
-        }
-
-        ChunkSampleBuffer proc_in = ChunkSampleBuffer::create_non_owning_buffer(aliased_in, 0, processor->input_channels());
-        ChunkSampleBuffer proc_out = ChunkSampleBuffer::create_non_owning_buffer(aliased_out, 0, processor->output_channels());
-        processor->process_audio(proc_in, proc_out);
-
-        int unused_channels = aliased_out.channel_count() - processor->output_channels();
-        if (unused_channels > 0)
-        {
-            // If processor has fewer channels than the track, zero the rest to avoid passing garbage to the next processor
-            auto unused = ChunkSampleBuffer::create_non_owning_buffer(aliased_out, aliased_out.channel_count() - unused_channels, unused_channels);
-            unused.clear();
-        }
-
+        _process_plugin(_processors[i], aliased_in, aliased_out);
         swap(aliased_in, aliased_out);
-        _timer->stop_timer_rt_safe(processor_timestamp, static_cast<int>(processor->id()));
     }
 
     int output_channels = _processors.empty() ? _current_output_channels : _processors.back()->output_channels();
@@ -325,6 +338,32 @@ void Track::_process_plugins(ChunkSampleBuffer& in, ChunkSampleBuffer& out)
     }
 }
 
+void Track::_process_plugin(Processor* processor, const ChunkSampleBuffer& in, ChunkSampleBuffer& out)
+{
+    auto processor_timestamp = _timer->start_timer();
+    /* Note that processors can put events back into this queue, hence we're not draining the queue
+     * but checking the size first to avoid an infinite loop */
+    for (int kb_events = _kb_event_buffer.size(); kb_events > 0; --kb_events)
+    {
+        processor->process_event(_kb_event_buffer.pop());
+    }
+
+    /* in is only ever read from, the const cast is needed to create a sub-buffer of it */
+    auto& mutable_in = const_cast<ChunkSampleBuffer&>(in);
+    ChunkSampleBuffer proc_in = ChunkSampleBuffer::create_non_owning_buffer(mutable_in, 0, processor->input_channels());
+    ChunkSampleBuffer proc_out = ChunkSampleBuffer::create_non_owning_buffer(out, 0, processor->output_channels());
+    processor->process_audio(proc_in, proc_out);
+
+    int unused_channels = out.channel_count() - processor->output_channels();
+    if (unused_channels > 0)
+    {
+        // If processor has fewer channels than the track, zero the rest to avoid passing garbage to the next processor
+        auto unused = ChunkSampleBuffer::create_non_owning_buffer(out, out.channel_count() - unused_channels, unused_channels);
+        unused.clear();
+    }
+    _timer->stop_timer_rt_safe(processor_timestamp, static_cast<int>(processor->id()));
+}
+
 void Track::_process_output_events()
 {
     while (!_kb_event_buffer.empty())
@@ -32,6 +32,7 @@
 #include "library/internal_plugin.h"
 #include "library/performance_timer.h"
 #include "library/rt_event_fifo.h"
+#include "engine/buffer_arena.h"
 
 #include "dsp_library/value_smoother.h"
 
@@ -40,6 +41,7 @@ namespace sushi::internal::engine {
 /* No real technical limit, just something arbitrarily high enough */
 constexpr int MAX_TRACK_BUSES = MAX_TRACK_CHANNELS / 2;
 constexpr int KEYBOARD_EVENT_QUEUE_SIZE = 256;
+constexpr int MAX_TRACK_OUTPUT_ROUTES = 2 * MAX_TRACK_CHANNELS;
 
 enum class TrackType
 {
@@ -61,8 +63,14 @@ public:
      * @param channels The number of channels in the track
      * @param timer A timer object
      * @param pan_controls If true, create a pan control parameter on the track
+     * @param arena If set, the track's audio buffers are allocated from this arena
      */
-    Track(HostControl host_control, int channels, performance::PerformanceTimer* timer, bool pan_controls, TrackType type = TrackType::REGULAR);
+    Track(HostControl host_control,
+          int channels,
+          performance::PerformanceTimer* timer,
+          bool pan_controls,
+          TrackType type = TrackType::REGULAR,
+          std::shared_ptr<BufferArena> arena = nullptr);
 
     /**
      * @brief Create a track with a given number of stereo input and output buses
@@ -70,10 +78,11 @@ public:
      * @param host_control Host callback object
      * @param timer A timer object
      * @param buses The number of stereo audio buses
+     * @param arena If set, the track's audio buffers are allocated from this arena
      */
-    Track(HostControl host_control, int buses, performance::PerformanceTimer* timer);
+    Track(HostControl host_control, int buses, performance::PerformanceTimer* timer, std::shared_ptr<BufferArena> arena = nullptr);
 
-    ~Track() override = default;
+    ~Track() override;
 
     ProcessorReturnCode init(float sample_rate) override;
 
@@ -97,6 +106,16 @@ public:
      */
     bool remove(ObjectId processor);
 
+    /**
+     * @brief Return the processors in the track's processing chain, in processing order.
+     *        Should be called from the audio thread or when the track is not processing.
+     * @return A std::vector of processor pointers
+     */
+    const std::vector<Processor*>& processors() const
+    {
+        return _processors;
+    }
+
     /**
      * @brief Return a SampleBuffer to an input bus
      * @param bus The index of the bus, must not be greater than the number of buses configured
@@ -141,6 +160,80 @@ public:
         return ChunkSampleBuffer::create_non_owning_buffer(_output_buffer, index, 1);
     }
 
+    /**
+     * @brief Return the number of channels of the track's input buffer, which is the number
+     *        of channels an input alias must have.
+     */
+    int input_buffer_channels() const
+    {
+        return _input_buffer.channel_count();
+    }
+
+    /**
+     * @brief Make the next call to render() read the track's input directly from another
+     *        buffer, i.e. the engine's inputs, instead of from the track's own input buffer.
+     *        The aliased buffer is never written to. Realtime safe.
+     * @param alias A non-owning buffer with input_buffer_channels() channels. Only valid
+     *        for one call to render(), so it needs to be set again before every call.
+     */
+    void set_input_alias(ChunkSampleBuffer&& alias)
+    {
+        assert(alias.channel_count() == _input_buffer.channel_count());
+        _input_alias = std::move(alias);
+    }
+
+    /**
+     * @brief Stop reading input from an alias. Should be called when the track is no
+     *        longer given an input alias every render, as the track's own input buffer
+     *        may have been used as scratch memory while aliased. Realtime safe.
+     */
+    void clear_input_alias()
+    {
+        _input_alias = ChunkSampleBuffer();
+        _input_buffer.clear();
+    }
+
+    /**
+     * @brief Route a channel of the track output to a channel of an engine output buffer
+     *        for mix_to_outputs(). Realtime safe.
+     * @param track_channel The track output channel
+     * @param engine_channel The channel of the engine output buffer
+     * @return true if the route was added, false if the max number of routes is reached
+     */
+    bool add_output_route(int track_channel, int engine_channel)
+    {
+        assert(track_channel < _max_output_channels);
+        if (_output_route_count < MAX_TRACK_OUTPUT_ROUTES)
+        {
+            _output_routes[_output_route_count++] = {track_channel, engine_channel};
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Remove all routes added with add_output_route(). Realtime safe.
+     */
+    void clear_output_routes()
+    {
+        _output_route_count = 0;
+    }
+
+    /**
+     * @brief Add the routed output channels of the track to a mix of the engine outputs.
+     *        Called after render().
+     * @param outputs A buffer with at least as many channels as the highest routed
+     *        engine channel
+     */
+    void mix_to_outputs(ChunkSampleBuffer& outputs) const
+    {
+        for (int i = 0; i < _output_route_count; ++i)
+        {
+            const auto& route = _output_routes[i];
+            outputs.add(route.engine_channel, route.track_channel, _output_buffer);
+        }
+    }
+
     /**
      * @brief Return the number of stereo buses of the track.
      * @return The number of stereo buses on the track.
@@ -191,15 +284,26 @@ private:
     };
 
     void _common_init(PanMode mode);
-    void _process_plugins(ChunkSampleBuffer& in, ChunkSampleBuffer& out);
+    void _process_plugins(ChunkSampleBuffer& in, ChunkSampleBuffer& out, size_t first_processor = 0);
+    void _process_plugin(Processor* processor, const ChunkSampleBuffer& in, ChunkSampleBuffer& out);
     void _process_output_events();
     void _apply_pan_and_gain(ChunkSampleBuffer& buffer, bool muted);
     void _apply_pan_and_gain_per_bus(ChunkSampleBuffer& buffer, bool muted);
     void _apply_gain(ChunkSampleBuffer& buffer, bool muted);
 
     std::vector<Processor*> _processors;
+    std::shared_ptr<BufferArena> _buffer_arena;
     ChunkSampleBuffer _input_buffer;
     ChunkSampleBuffer _output_buffer;
+    ChunkSampleBuffer _input_alias;
+
+    struct OutputRoute
+    {
+        int track_channel;
+        int engine_channel;
+    };
+    std::array<OutputRoute, MAX_TRACK_OUTPUT_ROUTES> _output_routes;
+    int _output_route_count{0};
 
     int _buses;
     PanMode _pan_mode;
@@ -37,6 +37,17 @@ namespace sushi::internal {
 
 ELKLOG_GET_LOGGER_WITH_MODULE_NAME("base-factory");
 
+engine::SchedulingMode to_engine_scheduling(MulticoreScheduling scheduling)
+{
+    switch (scheduling)
+    {
+        case MulticoreScheduling::LOAD_BALANCED:    return engine::SchedulingMode::LOAD_BALANCED;
+        case MulticoreScheduling::WORK_STEALING:    return engine::SchedulingMode::WORK_STEALING;
+        case MulticoreScheduling::ROUND_ROBIN:
+        default:                                    return engine::SchedulingMode::ROUND_ROBIN;
+    }
+}
+
 BaseFactory::BaseFactory() = default;
 
 BaseFactory::~BaseFactory() = default;
@@ -100,19 +111,38 @@ void BaseFactory::_instantiate_subsystems(SushiOptions& options)
                                                     options.rt_cpu_cores,
                                                     options.device_name,
                                                     options.debug_mode_switches,
-                                                    nullptr);
+                                                    nullptr,
+                                                    to_engine_scheduling(options.multicore_scheduling));
 
     if (!options.base_plugin_path.empty())
     {
         _engine->set_base_plugin_path(options.base_plugin_path);
     }
 
+    if (options.async_work_threads > 0)
+    {
+        _engine->enable_async_work_executor(options.async_work_threads);
+    }
+
+    if (!options.plugin_index_file.empty())
+    {
+        _engine->set_plugin_index_file(options.plugin_index_file);
+    }
+
     if (options.enable_timings)
     {
         _engine->performance_timer()->enable(true);
     }
 
-    _midi_dispatcher = std::make_unique<midi_dispatcher::MidiDispatcher>(_engine->event_dispatcher());
+    if (!options.telemetry_file.empty())
+    {
+        if (_engine->enable_telemetry(options.telemetry_file) == false)
+        {
+            ELKLOG_LOG_WARNING("Failed to enable telemetry, continuing without it");
+        }
+    }
+
+    _midi_dispatcher = std::make_unique<midi_dispatcher::MidiDispatcher>(_engine->event_dispatcher(), _engine.get());
 
     if (options.config_source == ConfigurationSource::FILE)
     {
@@ -219,9 +249,7 @@ Status BaseFactory::_configure_engine(SushiOptions& options,
         return status;
     }
 
-    _engine_controller = std::make_unique<engine::Controller>(_engine.get(),
-                                                              _midi_dispatcher.get(),
-                                                              _audio_frontend.get());
+    _engine_controller = std::make_unique<engine::Controller>(_engine.get(), _midi_dispatcher.get());
 
     status = _set_up_control(options, configurator);
     if (status != Status::OK)
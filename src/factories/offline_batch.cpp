@@ -0,0 +1,199 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Rendering of many files with the same configuration in parallel offline instances.
+ * @copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "elklog/static_logger.h"
+
+#include "sushi/offline_batch.h"
+#include "sushi/offline_factory.h"
+
+namespace sushi {
+
+ELKLOG_GET_LOGGER_WITH_MODULE_NAME("offline-batch");
+
+int OfflineBatchReport::failed_jobs() const
+{
+    return static_cast<int>(std::count_if(results.begin(), results.end(), [](const auto& result)
+    {
+        return result.status != Status::OK;
+    }));
+}
+
+std::string OfflineBatchReport::summary() const
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(2);
+    double job_time = 0.0;
+    for (const auto& result : results)
+    {
+        stream << result.job.input_filename << " -> " << result.job.output_filename << ": ";
+        if (result.status == Status::OK)
+        {
+            stream << "OK, " << result.duration.count() << " s\n";
+        }
+        else
+        {
+            stream << "Failed, " << to_string(result.status) << "\n";
+        }
+        job_time += result.duration.count();
+    }
+    stream << "Rendered " << static_cast<int>(results.size()) - failed_jobs() << " of " << results.size() << " files with "
+           << parallel_jobs << " parallel jobs in " << duration.count() << " s";
+    if (duration.count() > 0)
+    {
+        stream << ", " << job_time / duration.count() << "x speedup over sequential rendering";
+    }
+    stream << "\n";
+    return stream.str();
+}
+
+std::optional<std::vector<OfflineBatchJob>> read_offline_batch_file(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file.good())
+    {
+        ELKLOG_LOG_ERROR("Unable to open batch file {}", filename);
+        return std::nullopt;
+    }
+
+    std::vector<OfflineBatchJob> jobs;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line))
+    {
+        line_number++;
+        std::istringstream line_stream(line);
+        OfflineBatchJob job;
+        if (!(line_stream >> std::quoted(job.input_filename)))
+        {
+            continue;
+        }
+        if (job.input_filename.empty())
+        {
+            ELKLOG_LOG_ERROR("Empty input filename on line {} of batch file {}", line_number, filename);
+            return std::nullopt;
+        }
+        if (job.input_filename.front() == '#')
+        {
+            continue;
+        }
+        if (!(line_stream >> std::quoted(job.output_filename)))
+        {
+            job.output_filename = job.input_filename + "_proc.wav";
+        }
+        else if (job.output_filename.empty())
+        {
+            ELKLOG_LOG_ERROR("Empty output filename on line {} of batch file {}", line_number, filename);
+            return std::nullopt;
+        }
+        std::string trailing;
+        if (line_stream >> trailing)
+        {
+            ELKLOG_LOG_ERROR("Unexpected text \"{}\" on line {} of batch file {}", trailing, line_number, filename);
+            return std::nullopt;
+        }
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+namespace {
+
+OfflineBatchJobResult render_job(const SushiOptions& options, const OfflineBatchJob& job)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    OfflineBatchJobResult result{job};
+
+    auto job_options = options;
+    job_options.frontend_type = FrontendType::OFFLINE;
+    job_options.input_filename = job.input_filename;
+    job_options.output_filename = job.output_filename;
+    // Instances can't share network ports, and the parallelism comes from running many of them
+    job_options.use_grpc = false;
+    job_options.use_osc = false;
+    job_options.rt_cpu_cores = 1;
+    // All instances would write timings and telemetry to the same files
+    job_options.enable_timings = false;
+    job_options.telemetry_file.clear();
+
+    OfflineFactory factory;
+    auto [sushi, status] = factory.new_instance(job_options);
+    if (status == Status::OK)
+    {
+        // With the offline frontend, start() returns when the whole file is rendered
+        status = sushi->start();
+        sushi->stop();
+    }
+    result.status = status;
+    result.duration = std::chrono::steady_clock::now() - start_time;
+
+    ELKLOG_LOG_INFO("Rendered {} to {} in {:.2f} s, status: {}", job.input_filename, job.output_filename,
+                    result.duration.count(), to_string(status));
+    return result;
+}
+
+} // end anonymous namespace
+
+OfflineBatchReport render_offline_batch(const SushiOptions& options,
+                                        const std::vector<OfflineBatchJob>& jobs,
+                                        int parallel_jobs)
+{
+    if (parallel_jobs <= 0)
+    {
+        parallel_jobs = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    parallel_jobs = std::min(parallel_jobs, std::max(1, static_cast<int>(jobs.size())));
+
+    OfflineBatchReport report;
+    report.parallel_jobs = parallel_jobs;
+    report.results.resize(jobs.size());
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::atomic<size_t> next_job{0};
+    auto worker = [&]()
+    {
+        for (auto i = next_job.fetch_add(1); i < jobs.size(); i = next_job.fetch_add(1))
+        {
+            report.results[i] = render_job(options, jobs[i]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < parallel_jobs; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    report.duration = std::chrono::steady_clock::now() - start_time;
+    return report;
+}
+
+} // end namespace sushi
@@ -25,6 +25,11 @@
 
 namespace sushi::internal::performance {
 
+/**
+ * @brief Process times of a node, expressed as fractions of the timing period.
+ *        Percentiles are approximate, from a histogram with logarithmically
+ *        spaced buckets.
+ */
 struct ProcessTimings
 {
     ProcessTimings() : avg_case{0.0f}, min_case{100.0f}, max_case{0.0f} {}
@@ -32,6 +37,10 @@ struct ProcessTimings
     float avg_case{1};
     float min_case{1};
     float max_case{0};
+    float p50_case{0};
+    float p99_case{0};
+    float p999_case{0};
+    int   overruns{0}; // Number of records longer than the timing period
 };
 
 class BasePerformanceTimer
@@ -42,6 +42,15 @@ public:
     virtual std::pair<ProcessorReturnCode, std::shared_ptr<Processor>> new_instance(const PluginInfo& plugin_info,
                                                                                     HostControl& host_control,
                                                                                     float sample_rate) = 0;
+
+    /**
+     * @brief Whether new_instance() may be called concurrently from several threads.
+     * @return true if instances can be created in parallel, false otherwise.
+     */
+    virtual bool concurrent_instantiation_supported() const
+    {
+        return false;
+    }
 };
 
 } // end namespace sushi::internal
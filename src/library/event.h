@@ -23,11 +23,14 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "sushi/sushi_time.h"
 #include "sushi/types.h"
 
 #include "id_generator.h"
+#include "event_pool.h"
+#include "mpsc_queue.h"
 #include "library/rt_event.h"
 #include "base_performance_timer.h"
 
@@ -62,9 +65,10 @@ enum EventStatus : int
 typedef void (*EventCompletionCallback)(void *arg, Event* event, int status);
 
 /**
- * @brief Event baseclass
+ * @brief Event baseclass. Events are allocated from the EventPool and can be
+ *        passed between threads through an MpscQueue.
  */
-class Event
+class Event : public MpscQueueHook
 {
     friend class sushi::internal::dispatcher::EventDispatcher;
     friend class sushi::internal::dispatcher::Worker;
@@ -72,6 +76,16 @@ class Event
 public:
     virtual ~Event() = default;
 
+    static void* operator new(size_t size)
+    {
+        return EventPool::instance().allocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size)
+    {
+        EventPool::instance().deallocate(ptr, size);
+    }
+
     /**
      * @brief Creates an Event from its RtEvent counterpart if possible
      * @param rt_event The RtEvent to convert from
@@ -129,6 +143,9 @@ public:
     /* Convertible to PropertyChangeNotification */
     [[nodiscard]] virtual bool is_property_change_notification() const {return false;}
 
+    /* Convertible to ParameterChangeBatchNotification */
+    [[nodiscard]] virtual bool is_parameter_change_batch_notification() const {return false;}
+
     /* Convertible to EngineEvent */
     [[nodiscard]] virtual bool is_engine_event() const {return false;}
 
@@ -598,6 +615,34 @@ private:
     std::string _formatted_value;
 };
 
+/**
+ * @brief Carries all parameter value changes found during one update of the
+ *        ParameterManager. Values are not formatted as strings, that is left to
+ *        the receivers that need it.
+ */
+class ParameterChangeBatchNotificationEvent : public Event
+{
+public:
+    struct ParameterChange
+    {
+        ObjectId processor_id;
+        ObjectId parameter_id;
+        float    normalized_value;
+        float    domain_value;
+    };
+
+    ParameterChangeBatchNotificationEvent(std::vector<ParameterChange> changes,
+                                          Time timestamp) : Event(timestamp),
+                                                            _changes(std::move(changes)) {}
+
+    [[nodiscard]] bool is_parameter_change_batch_notification() const override {return true;}
+
+    [[nodiscard]] const std::vector<ParameterChange>& changes() const {return _changes;}
+
+private:
+    std::vector<ParameterChange> _changes;
+};
+
 class PropertyChangeNotificationEvent : public Event
 {
 public:
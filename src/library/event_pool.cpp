@@ -0,0 +1,104 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Pooled memory allocation for non-rt Events
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#include <mutex>
+#include <new>
+
+#include "event_pool.h"
+
+namespace sushi::internal {
+
+EventPool& EventPool::instance()
+{
+    /* Intentionally never destroyed, as Events owned by other static objects
+     * may be deleted after the pool would otherwise have been destroyed */
+    static auto pool = new EventPool();
+    return *pool;
+}
+
+void* EventPool::allocate(size_t size)
+{
+    if (size > EVENT_POOL_MAX_BLOCK_SIZE)
+    {
+        return ::operator new(size);
+    }
+    auto& size_class = _size_classes[_size_class(size)];
+    {
+        std::scoped_lock lock(size_class.lock);
+        if (auto block = size_class.free_list; block != nullptr)
+        {
+            size_class.free_list = block->next;
+            return block;
+        }
+    }
+
+    // Allocate the slab outside of the lock, then keep the first block and add the rest to the free list
+    size_t block_size = EVENT_POOL_MIN_BLOCK_SIZE << _size_class(size);
+    auto slab = _allocate_slab(block_size);
+    auto last = reinterpret_cast<FreeBlock*>(reinterpret_cast<std::byte*>(slab) + (EVENT_POOL_BLOCKS_PER_SLAB - 1) * block_size);
+
+    std::scoped_lock lock(size_class.lock);
+    last->next = size_class.free_list;
+    size_class.free_list = slab->next;
+    size_class.reserved_size.fetch_add(block_size * EVENT_POOL_BLOCKS_PER_SLAB, std::memory_order_relaxed);
+    return slab;
+}
+
+void EventPool::deallocate(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    if (size > EVENT_POOL_MAX_BLOCK_SIZE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    auto& size_class = _size_classes[_size_class(size)];
+    auto block = static_cast<FreeBlock*>(ptr);
+
+    std::scoped_lock lock(size_class.lock);
+    block->next = size_class.free_list;
+    size_class.free_list = block;
+}
+
+size_t EventPool::reserved_size() const
+{
+    size_t size = 0;
+    for (auto& size_class : _size_classes)
+    {
+        size += size_class.reserved_size.load(std::memory_order_relaxed);
+    }
+    return size;
+}
+
+EventPool::FreeBlock* EventPool::_allocate_slab(size_t block_size)
+{
+    auto slab = static_cast<std::byte*>(::operator new(block_size * EVENT_POOL_BLOCKS_PER_SLAB));
+    for (int i = 0; i < EVENT_POOL_BLOCKS_PER_SLAB - 1; ++i)
+    {
+        auto block = reinterpret_cast<FreeBlock*>(slab + i * block_size);
+        block->next = reinterpret_cast<FreeBlock*>(slab + (i + 1) * block_size);
+    }
+    return reinterpret_cast<FreeBlock*>(slab);
+}
+
+} // end namespace sushi::internal
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Pooled memory allocation for non-rt Events
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_EVENT_POOL_H
+#define SUSHI_EVENT_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "spinlock.h"
+
+namespace sushi::internal {
+
+/* Events are allocated from a fixed number of size classes, each twice the size of the
+ * previous one. Events larger than the largest class fall back to the global allocator */
+constexpr size_t EVENT_POOL_MIN_BLOCK_SIZE = 64;
+constexpr int EVENT_POOL_SIZE_CLASSES = 4;
+constexpr size_t EVENT_POOL_MAX_BLOCK_SIZE = EVENT_POOL_MIN_BLOCK_SIZE << (EVENT_POOL_SIZE_CLASSES - 1);
+constexpr int EVENT_POOL_BLOCKS_PER_SLAB = 64;
+
+/**
+ * @brief Recycling allocator for Events. Freed blocks are kept on a free list per size
+ *        class and handed out again on the next allocation of the same size, so that the
+ *        steady state of the event path does no heap allocations. New blocks are carved
+ *        out of larger slabs that are never returned to the system.
+ *        Allocation and deallocation are thread safe and only hold a spinlock while
+ *        pushing to or popping from the free list.
+ */
+class EventPool
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(EventPool);
+
+    EventPool() = default;
+
+    /**
+     * @brief Return the process wide pool that Events are allocated from
+     */
+    static EventPool& instance();
+
+    /**
+     * @brief Allocate a block of memory
+     * @param size The size of the block in bytes
+     * @return A pointer to at least size bytes, suitably aligned for any object
+     */
+    void* allocate(size_t size);
+
+    /**
+     * @brief Return a block previously allocated with allocate() to the pool
+     * @param ptr Pointer to the block
+     * @param size The size that was passed to allocate()
+     */
+    void deallocate(void* ptr, size_t size);
+
+    /**
+     * @brief Return the number of bytes reserved by the pool, either in use or free
+     */
+    size_t reserved_size() const;
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct alignas(ASSUMED_CACHE_LINE_SIZE) SizeClass
+    {
+        SpinLock   lock;
+        FreeBlock* free_list{nullptr};
+        std::atomic<size_t> reserved_size{0};
+    };
+
+    static int _size_class(size_t size)
+    {
+        int size_class = 0;
+        for (size_t block_size = EVENT_POOL_MIN_BLOCK_SIZE; block_size < size; block_size <<= 1)
+        {
+            ++size_class;
+        }
+        return size_class;
+    }
+
+    static FreeBlock* _allocate_slab(size_t block_size);
+
+    std::array<SizeClass, EVENT_POOL_SIZE_CLASSES> _size_classes;
+};
+
+} // end namespace sushi::internal
+
+#endif // SUSHI_EVENT_POOL_H
@@ -423,7 +423,14 @@ void InternalPlugin::_handle_parameter_event(const ParameterChangeRtEvent* event
                 auto parameter_value = storage->float_parameter_value();
                 if (parameter_value->descriptor()->automatable())
                 {
-                    parameter_value->set(event->value());
+                    if (parameter_value->sample_accurate() && event->sample_offset() > 0)
+                    {
+                        _queue_parameter_change(parameter_value, event->value(), event->sample_offset());
+                    }
+                    else
+                    {
+                        parameter_value->set(event->value());
+                    }
                 }
                 break;
             }
@@ -451,4 +458,33 @@ void InternalPlugin::_handle_parameter_event(const ParameterChangeRtEvent* event
     }
 }
 
+void InternalPlugin::_queue_parameter_change(FloatParameterValue* storage, float value, int sample_offset)
+{
+    if (_queued_change_count == MAX_QUEUED_PARAMETER_CHANGES)
+    {
+        /* Merge the change with the last one queued for this parameter, setting the value
+         * directly would let the queued changes overwrite it later in the chunk */
+        for (int i = _queued_change_count - 1; i >= 0; --i)
+        {
+            if (_queued_changes[i].storage == storage)
+            {
+                if (_queued_changes[i].sample_offset <= sample_offset)
+                {
+                    _queued_changes[i].value = value;
+                }
+                return;
+            }
+        }
+        storage->set(value);
+        return;
+    }
+    // Events normally arrive in order, so this rarely moves more than a few entries
+    int i = _queued_change_count++;
+    for (; i > 0 && _queued_changes[i - 1].sample_offset > sample_offset; --i)
+    {
+        _queued_changes[i] = _queued_changes[i - 1];
+    }
+    _queued_changes[i] = {storage, value, sample_offset};
+}
+
 } // end namespace sushi::internal
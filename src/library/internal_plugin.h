@@ -21,6 +21,8 @@
 #ifndef SUSHI_INTERNAL_PLUGIN_H
 #define SUSHI_INTERNAL_PLUGIN_H
 
+#include <algorithm>
+#include <array>
 #include <deque>
 #include <unordered_map>
 #include <mutex>
@@ -31,6 +33,10 @@
 
 namespace sushi::internal {
 
+/* Max number of sample accurate parameter changes queued per chunk, later changes are
+ * applied at the start of the chunk */
+constexpr int MAX_QUEUED_PARAMETER_CHANGES = 32;
+
 constexpr int DEFAULT_CHANNELS = MAX_TRACK_CHANNELS;
 
 class StringUid
@@ -214,6 +220,68 @@ protected:
      */
     void send_property_to_realtime(ObjectId property_id, const std::string& value);
 
+    /**
+     * @brief Enable sample accurate automation of a parameter. Parameter change events
+     *        with a sample offset within the chunk are then queued instead of applied
+     *        directly. Plugins that enable this must call process_in_segments() or
+     *        apply_queued_parameter_changes() from every call to process_audio().
+     * @param storage The ParameterValue to make sample accurate
+     */
+    void enable_sample_accurate_automation(FloatParameterValue* storage)
+    {
+        storage->set_sample_accurate(true);
+    }
+
+    /**
+     * @brief Process the current chunk in consecutive segments, split at the sample offsets
+     *        of the queued parameter changes, which are applied before the segment they
+     *        fall in. If no changes are queued, render is called once for the whole chunk.
+     * @param render Callable with the signature void(int offset, int samples) that
+     *        processes samples frames from offset in the chunk
+     */
+    template <typename RenderFunction>
+    void process_in_segments(RenderFunction&& render)
+    {
+        if (_queued_change_count == 0)
+        {
+            render(0, AUDIO_CHUNK_SIZE);
+            return;
+        }
+        int start = 0;
+        int i = 0;
+        while (i < _queued_change_count)
+        {
+            int offset = std::min(_queued_changes[i].sample_offset, AUDIO_CHUNK_SIZE);
+            if (offset > start)
+            {
+                render(start, offset - start);
+                start = offset;
+            }
+            for (; i < _queued_change_count && std::min(_queued_changes[i].sample_offset, AUDIO_CHUNK_SIZE) == offset; ++i)
+            {
+                _queued_changes[i].storage->set(_queued_changes[i].value);
+            }
+        }
+        if (start < AUDIO_CHUNK_SIZE)
+        {
+            render(start, AUDIO_CHUNK_SIZE - start);
+        }
+        _queued_change_count = 0;
+    }
+
+    /**
+     * @brief Apply all queued parameter changes directly, for when the chunk is not
+     *        processed with process_in_segments(), i.e. when bypassed.
+     */
+    void apply_queued_parameter_changes()
+    {
+        for (int i = 0; i < _queued_change_count; ++i)
+        {
+            _queued_changes[i].storage->set(_queued_changes[i].value);
+        }
+        _queued_change_count = 0;
+    }
+
 private:
     friend InternalPluginAccessor;
 
@@ -221,11 +289,23 @@ private:
 
     void _handle_parameter_event(const ParameterChangeRtEvent* event);
 
+    void _queue_parameter_change(FloatParameterValue* storage, float value, int sample_offset);
+
     /* TODO: Consider container type to use here. Deque has the very desirable property
      *  that iterators are never invalidated by adding to the containers.
      *  For arrays or std::vectors we need to know the maximum capacity for that to work. */
     std::deque<ParameterStorage> _parameter_values;
 
+    struct QueuedParameterChange
+    {
+        FloatParameterValue* storage;
+        float value;
+        int sample_offset;
+    };
+    // Sorted by sample offset
+    std::array<QueuedParameterChange, MAX_QUEUED_PARAMETER_CHANGES> _queued_changes;
+    int _queued_change_count{0};
+
     mutable std::mutex _property_lock;
     std::unordered_map<ObjectId, std::string> _property_values;
 };
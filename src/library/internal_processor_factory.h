@@ -37,6 +37,12 @@ public:
     std::pair<ProcessorReturnCode, std::shared_ptr<Processor>> new_instance(const PluginInfo &plugin_info,
                                                                             HostControl& host_control,
                                                                             float sample_rate) override;
+
+    bool concurrent_instantiation_supported() const override
+    {
+        return true;
+    }
+
 private:
     /**
      * @brief Instantiate a plugin instance of a given type
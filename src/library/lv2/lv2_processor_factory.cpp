@@ -41,7 +41,7 @@ std::pair<ProcessorReturnCode, std::shared_ptr<Processor>> Lv2ProcessorFactory::
     if (!world)
     {
         world = std::make_shared<LilvWorldWrapper>();
-        world->create_world();
+        world->create_world(_index);
         if (world->world() == nullptr)
         {
             ELKLOG_LOG_ERROR("Failed to initialize Lilv World");
@@ -49,6 +49,8 @@ std::pair<ProcessorReturnCode, std::shared_ptr<Processor>> Lv2ProcessorFactory::
         }
         _world = world;
     }
+    // If the plugin can not be found, this is reported by init() below
+    world->load_plugin(plugin_info.path);
     auto processor = std::make_shared<lv2::LV2_Wrapper>(host_control, plugin_info.path, world);
     auto processor_status = processor->init(sample_rate);
     return {processor_status, processor};
@@ -21,6 +21,7 @@
 #define SUSHI_LV2_PROCESSOR_FACTORY_H
 
 #include "library/base_processor_factory.h"
+#include "library/plugin_index.h"
 
 namespace sushi::internal::lv2 {
 
@@ -29,6 +30,12 @@ class LilvWorldWrapper;
 class Lv2ProcessorFactory : public BaseProcessorFactory
 {
 public:
+    /**
+     * @param index If not null, plugin bundles are looked up in this index instead of
+     *              loading all installed plugins when the first instance is created.
+     */
+    explicit Lv2ProcessorFactory(std::shared_ptr<PluginIndex> index = nullptr) : _index(std::move(index)) {}
+
     ~Lv2ProcessorFactory() override;
 
     std::pair<ProcessorReturnCode, std::shared_ptr<Processor>> new_instance(const PluginInfo& plugin_info,
@@ -37,6 +44,7 @@ public:
 
 private:
     std::weak_ptr<LilvWorldWrapper> _world;
+    std::shared_ptr<PluginIndex> _index;
 };
 
 } // end namespace sushi::internal::lv2
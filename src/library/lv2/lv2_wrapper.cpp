@@ -45,23 +45,111 @@ LilvWorldWrapper::~LilvWorldWrapper()
     }
 }
 
-bool LilvWorldWrapper::create_world()
+bool LilvWorldWrapper::create_world(std::shared_ptr<PluginIndex> index)
 {
     assert(_world == nullptr);
 
     _world = lilv_world_new();
+    _index = std::move(index);
     if (_world)
     {
-        lilv_world_load_all(_world);
+        if (_index)
+        {
+            // Specifications and plugin classes are needed to inspect plugins, even when
+            // only a few plugin bundles are loaded
+            lilv_world_load_specifications(_world);
+            lilv_world_load_plugin_classes(_world);
+        }
+        else
+        {
+            _load_all();
+        }
     }
     return _world;
 }
 
+bool LilvWorldWrapper::load_plugin(const std::string& uri)
+{
+    if (_has_plugin(uri))
+    {
+        return true;
+    }
+    if (_all_loaded || !_index)
+    {
+        return false;
+    }
+
+    if (auto entry = _index->lookup(PluginType::LV2, uri); entry.has_value())
+    {
+        _load_bundle(entry->path);
+        if (_has_plugin(uri))
+        {
+            return true;
+        }
+    }
+
+    ELKLOG_LOG_INFO("Plugin {} not found in index, scanning all plugins", uri);
+    _load_all();
+
+    auto plugins = lilv_world_get_all_plugins(_world);
+    LILV_FOREACH(plugins, i, plugins)
+    {
+        auto plugin = lilv_plugins_get(plugins, i);
+        auto path = lilv_file_uri_parse(lilv_node_as_uri(lilv_plugin_get_bundle_uri(plugin)), nullptr);
+        if (path)
+        {
+            _index->update(PluginType::LV2, lilv_node_as_uri(lilv_plugin_get_uri(plugin)), path);
+            lilv_free(path);
+        }
+    }
+    _index->save();
+    return _has_plugin(uri);
+}
+
 LilvWorld* LilvWorldWrapper::world()
 {
     return _world;
 }
 
+bool LilvWorldWrapper::_has_plugin(const std::string& uri)
+{
+    auto uri_node = lilv_new_uri(_world, uri.c_str());
+    if (uri_node == nullptr)
+    {
+        return false;
+    }
+    auto plugin = lilv_plugins_get_by_uri(lilv_world_get_all_plugins(_world), uri_node);
+    lilv_node_free(uri_node);
+    return plugin != nullptr;
+}
+
+void LilvWorldWrapper::_load_bundle(const std::string& bundle_path)
+{
+    if (_loaded_bundles.count(bundle_path) > 0)
+    {
+        return;
+    }
+    // Bundle uris must end with a slash
+    auto path = bundle_path.back() == '/' ? bundle_path : bundle_path + "/";
+    auto bundle_uri = lilv_new_file_uri(_world, nullptr, path.c_str());
+    if (bundle_uri)
+    {
+        ELKLOG_LOG_DEBUG("Loading LV2 bundle {}", bundle_path);
+        lilv_world_load_bundle(_world, bundle_uri);
+        lilv_node_free(bundle_uri);
+        _loaded_bundles.insert(bundle_path);
+    }
+}
+
+void LilvWorldWrapper::_load_all()
+{
+    if (_all_loaded == false)
+    {
+        lilv_world_load_all(_world);
+        _all_loaded = true;
+    }
+}
+
 LV2_Wrapper::LV2_Wrapper(HostControl host_control,
                          const std::string& lv2_plugin_uri,
                          std::shared_ptr<LilvWorldWrapper> world):
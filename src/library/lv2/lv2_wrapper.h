@@ -40,6 +40,8 @@
 #define SUSHI_LV2_PLUGIN_H
 
 #include <map>
+#include <memory>
+#include <set>
 
 #include "sushi/constants.h"
 
@@ -48,6 +50,7 @@
 #include "library/rt_event_fifo.h"
 #include "library/midi_encoder.h"
 #include "library/midi_decoder.h"
+#include "library/plugin_index.h"
 
 
 #include "lv2_model.h"
@@ -68,12 +71,35 @@ class LilvWorldWrapper
 public:
     ~LilvWorldWrapper();
 
-    bool create_world();
+    /**
+     * @brief Create the world. Without an index, all installed plugins are loaded.
+     *        With an index, only the LV2 specifications are loaded and plugins are
+     *        loaded on demand with load_plugin().
+     * @param index An optional plugin index to look up plugin bundles in
+     * @return true if the world was created
+     */
+    bool create_world(std::shared_ptr<PluginIndex> index = nullptr);
+
+    /**
+     * @brief Make sure that the plugin with the given uri is loaded into the world.
+     *        If the plugin's bundle is found in the index, only that bundle is loaded.
+     *        Otherwise all installed plugins are loaded and the index is updated.
+     * @param uri The uri of the plugin
+     * @return true if the plugin is loaded
+     */
+    bool load_plugin(const std::string& uri);
 
     LilvWorld* world();
 
 private:
+    bool _has_plugin(const std::string& uri);
+    void _load_bundle(const std::string& bundle_path);
+    void _load_all();
+
     LilvWorld* _world{nullptr};
+    std::shared_ptr<PluginIndex> _index;
+    std::set<std::string> _loaded_bundles;
+    bool _all_loaded{false};
 };
 
 /**
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Lock-free, multiple producer, single consumer queue for use in non-rt threads
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_MPSC_QUEUE_H
+#define SUSHI_MPSC_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "sushi/constants.h"
+
+#include "spinlock.h"
+
+namespace sushi::internal {
+
+template <class T> class MpscQueue;
+
+/**
+ * @brief Intrusive link that objects must inherit from in order to be queued in an MpscQueue.
+ *        An object can only be in one queue at a time.
+ */
+class MpscQueueHook
+{
+public:
+    MpscQueueHook() = default;
+
+    // Copies are never linked into any queue
+    MpscQueueHook(const MpscQueueHook& /*other*/) {}
+
+    MpscQueueHook& operator=(const MpscQueueHook& /*other*/)
+    {
+        return *this;
+    }
+
+private:
+    template <class T> friend class MpscQueue;
+
+    std::atomic<MpscQueueHook*> _next_in_queue{nullptr};
+};
+
+/**
+ * @brief Intrusive queue of std::unique_ptr<T>, where T inherits from MpscQueueHook.
+ *        Any number of threads may push to the queue concurrently, without locking and
+ *        without allocating memory. pop() and wait_for_data() must only be called from
+ *        one consumer thread. Based on Dmitry Vyukov's intrusive MPSC node-based queue.
+ */
+template <class T> class MpscQueue
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(MpscQueue);
+
+    MpscQueue() = default;
+
+    ~MpscQueue()
+    {
+        while (pop() != nullptr)
+        {}
+    }
+
+    void push(std::unique_ptr<T> message)
+    {
+        _push(message.release());
+        /* Dekker style handshake with wait_for_data(), both sides store and then load
+         * with sequential consistency, so at least one of them sees the other's store */
+        if (_consumer_waiting.load())
+        {
+            std::lock_guard<std::mutex> lock(_wait_mutex);
+            _notifier.notify_one();
+        }
+    }
+
+    /**
+     * @brief Take the oldest element from the queue. Must only be called from the consumer thread.
+     * @return The oldest element in the queue, or nullptr if the queue is empty.
+     */
+    std::unique_ptr<T> pop()
+    {
+        MpscQueueHook* tail = _tail;
+        MpscQueueHook* next = tail->_next_in_queue.load(std::memory_order_acquire);
+        if (tail == &_stub)
+        {
+            if (next == nullptr)
+            {
+                if (_head.load(std::memory_order_acquire) == &_stub)
+                {
+                    return nullptr;
+                }
+                next = _wait_for_link(tail);
+            }
+            _tail = next;
+            tail = next;
+            next = next->_next_in_queue.load(std::memory_order_acquire);
+        }
+        if (next == nullptr)
+        {
+            if (tail != _head.load(std::memory_order_acquire))
+            {
+                // A producer has swapped the head but not yet linked it, which is only a few instructions away
+                next = _wait_for_link(tail);
+            }
+            else
+            {
+                // tail is the last element, push the stub behind it so tail can be unlinked
+                _push(&_stub);
+                next = _wait_for_link(tail);
+            }
+        }
+        _tail = next;
+        return std::unique_ptr<T>(static_cast<T*>(tail));
+    }
+
+    /**
+     * @brief Block until there is data in the queue, the timeout expires or
+     *        wake_up() is called. Must only be called from the consumer thread.
+     * @param timeout Max time to wait
+     */
+    template <class Rep, class Period>
+    void wait_for_data(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        std::unique_lock<std::mutex> lock(_wait_mutex);
+        _consumer_waiting.store(true);
+        _notifier.wait_for(lock, timeout, [&] {return !empty() || _woken_up;});
+        _consumer_waiting.store(false, std::memory_order_relaxed);
+        _woken_up = false;
+    }
+
+    /**
+     * @brief Wake up a thread waiting in wait_for_data(), even if the queue is empty
+     */
+    void wake_up()
+    {
+        std::lock_guard<std::mutex> lock(_wait_mutex);
+        _woken_up = true;
+        _notifier.notify_one();
+    }
+
+    bool empty() const
+    {
+        // The stub is always pushed last when the last element is popped
+        return _head.load() == &_stub;
+    }
+
+private:
+    void _push(MpscQueueHook* node)
+    {
+        node->_next_in_queue.store(nullptr, std::memory_order_relaxed);
+        MpscQueueHook* previous = _head.exchange(node);
+        previous->_next_in_queue.store(node, std::memory_order_release);
+    }
+
+    static MpscQueueHook* _wait_for_link(MpscQueueHook* node)
+    {
+        MpscQueueHook* next;
+        while ((next = node->_next_in_queue.load(std::memory_order_acquire)) == nullptr)
+        {
+            std::this_thread::yield();
+        }
+        return next;
+    }
+
+    MpscQueueHook _stub;
+    alignas(ASSUMED_CACHE_LINE_SIZE) std::atomic<MpscQueueHook*> _head{&_stub};
+    alignas(ASSUMED_CACHE_LINE_SIZE) MpscQueueHook* _tail{&_stub};
+
+    std::atomic<bool>       _consumer_waiting{false};
+    std::mutex              _wait_mutex;
+    std::condition_variable _notifier;
+    bool                    _woken_up{false};
+};
+
+} // end namespace sushi::internal
+
+#endif // SUSHI_MPSC_QUEUE_H
@@ -18,6 +18,7 @@
  * @Copyright 2017-2023 Elk Audio AB, Stockholm
  */
 
+#include <cmath>
 #include <vector>
 
 #include "elklog/static_logger.h"
@@ -29,6 +30,46 @@ namespace sushi::internal::performance {
 constexpr auto EVALUATION_INTERVAL = std::chrono::seconds(1);
 constexpr double SEC_TO_NANOSEC = 1'000'000'000.0;
 constexpr float AVERAGING_FACTOR = 0.5f;
+constexpr float OVERRUN_LIMIT = 1.0f;
+
+void TimingHistogram::add(float process_time)
+{
+    int bucket = 0;
+    if (process_time > HISTOGRAM_MIN_VALUE)
+    {
+        // Clamped before converting, as process_time is infinite if no timing period is set
+        auto position = std::log2(process_time / HISTOGRAM_MIN_VALUE) * HISTOGRAM_BUCKETS_PER_OCTAVE;
+        bucket = static_cast<int>(std::min(position, static_cast<float>(HISTOGRAM_BUCKETS - 1)));
+    }
+    _buckets[bucket]++;
+    _count++;
+}
+
+float TimingHistogram::percentile(float percentile) const
+{
+    if (_count == 0)
+    {
+        return 0.0f;
+    }
+    auto target = static_cast<uint64_t>(std::ceil(percentile * static_cast<float>(_count)));
+    uint64_t accumulated = 0;
+    int bucket = 0;
+    for (; bucket < HISTOGRAM_BUCKETS - 1; ++bucket)
+    {
+        accumulated += _buckets[bucket];
+        if (accumulated >= target)
+        {
+            break;
+        }
+    }
+    return HISTOGRAM_MIN_VALUE * std::exp2(static_cast<float>(bucket + 1) / HISTOGRAM_BUCKETS_PER_OCTAVE);
+}
+
+void TimingHistogram::clear()
+{
+    _buckets.fill(0);
+    _count = 0;
+}
 
 PerformanceTimer::~PerformanceTimer()
 {
@@ -36,6 +77,13 @@ PerformanceTimer::~PerformanceTimer()
     {
         this->enable(false);
     }
+    /* Threads that logged to this timer keep a reference to _thread_logs until they exit or
+     * log to another timer, which may happen on an audio thread. So the queues are freed
+     * here and not when the last reference is dropped */
+    for (auto& thread_log : _thread_logs->logs)
+    {
+        thread_log.reset();
+    }
 }
 
 void PerformanceTimer::set_timing_period(TimePoint timing_period)
@@ -64,6 +112,13 @@ void PerformanceTimer::enable(bool enabled)
 {
     if (enabled && _enabled == false)
     {
+        for (auto& thread_log : _thread_logs->logs)
+        {
+            if (thread_log == nullptr)
+            {
+                thread_log = std::make_unique<TimingLog>();
+            }
+        }
         _enabled = true;
         _process_thread = std::thread(&PerformanceTimer::_worker, this);
     }
@@ -104,13 +159,29 @@ void PerformanceTimer::_update_timings()
         sorted_data[log_point.id].push_back(log_point);
     }
 
+    for (auto& thread_log : _thread_logs->logs)
+    {
+        while (thread_log && thread_log->pop(log_point))
+        {
+            sorted_data[log_point.id].push_back(log_point);
+        }
+    }
+
     for (const auto& node : sorted_data)
     {
         int id = node.first;
         std::lock_guard<std::mutex> lock(_timing_lock);
-        const auto& timings = _timings[id];
+        auto& timing_node = _timings[id];
         auto new_timings = _calculate_timings(node.second);
-        _timings[id].timings = _merge_timings(timings.timings, new_timings);
+        timing_node.timings = _merge_timings(timing_node.timings, new_timings);
+
+        for (const auto& entry : node.second)
+        {
+            timing_node.histogram.add(static_cast<float>(entry.delta_time.count()) / _period);
+        }
+        timing_node.timings.p50_case = timing_node.histogram.percentile(0.5f);
+        timing_node.timings.p99_case = timing_node.histogram.percentile(0.99f);
+        timing_node.timings.p999_case = timing_node.histogram.percentile(0.999f);
     }
 }
 
@@ -119,6 +190,7 @@ ProcessTimings PerformanceTimer::_calculate_timings(const std::vector<TimingLogP
     float min_value{100};
     float max_value{0};
     float sum{0.0f};
+    int overruns{0};
 
     for (const auto& entry : entries)
     {
@@ -126,9 +198,15 @@ ProcessTimings PerformanceTimer::_calculate_timings(const std::vector<TimingLogP
         sum += process_time;
         min_value = std::min(min_value, process_time);
         max_value = std::max(max_value, process_time);
+        if (process_time > OVERRUN_LIMIT)
+        {
+            overruns++;
+        }
     }
 
-    return {sum / entries.size(), min_value, max_value};
+    ProcessTimings timings(sum / entries.size(), min_value, max_value);
+    timings.overruns = overruns;
+    return timings;
 }
 
 ProcessTimings PerformanceTimer::_merge_timings(ProcessTimings prev_timings, ProcessTimings new_timings)
@@ -144,6 +222,7 @@ ProcessTimings PerformanceTimer::_merge_timings(ProcessTimings prev_timings, Pro
 
     prev_timings.min_case = std::min(prev_timings.min_case, new_timings.min_case);
     prev_timings.max_case = std::max(prev_timings.max_case, new_timings.max_case);
+    prev_timings.overruns += new_timings.overruns;
 
     return prev_timings;
 }
@@ -155,6 +234,7 @@ bool PerformanceTimer::clear_timings_for_node(int id)
     if (node != _timings.end())
     {
         new (&node->second.timings) (ProcessTimings);
+        node->second.histogram.clear();
         return true;
     }
 
@@ -167,6 +247,7 @@ void PerformanceTimer::clear_all_timings()
     for (auto& node : _timings)
     {
         new (&node.second.timings) (ProcessTimings);
+        node.second.histogram.clear();
     }
 }
 
@@ -21,8 +21,11 @@
 #ifndef SUSHI_PERFORMANCE_TIMER_H
 #define SUSHI_PERFORMANCE_TIMER_H
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <atomic>
+#include <memory>
 #include <thread>
 #include <map>
 #include <mutex>
@@ -34,12 +37,55 @@
 #include "sushi/constants.h"
 
 #include "base_performance_timer.h"
+#include "id_generator.h"
 #include "spinlock.h"
 
 namespace sushi::internal::performance {
 
 using TimePoint = std::chrono::nanoseconds;
 constexpr int MAX_LOG_ENTRIES = 20000;
+constexpr int MAX_TIMER_THREADS = 8;
+
+/* Histogram buckets are spaced 1/8 octave apart, i.e. ~9% relative resolution,
+ * and cover process times from 0.01% to ~2600% of the timing period */
+constexpr float HISTOGRAM_MIN_VALUE = 0.0001f;
+constexpr int HISTOGRAM_BUCKETS_PER_OCTAVE = 8;
+constexpr int HISTOGRAM_BUCKETS = 18 * HISTOGRAM_BUCKETS_PER_OCTAVE;
+
+/**
+ * @brief Fixed size histogram of process times with logarithmically spaced
+ *        buckets, for approximating percentiles without storing all records.
+ */
+class TimingHistogram
+{
+public:
+    /**
+     * @brief Add a record to the histogram
+     * @param process_time The process time as a fraction of the timing period
+     */
+    void add(float process_time);
+
+    /**
+     * @brief Get an approximate percentile of all records
+     * @param percentile The percentile to get, in the range 0 to 1
+     * @return The upper limit of the bucket containing the percentile, 0 if empty
+     */
+    float percentile(float percentile) const;
+
+    /**
+     * @brief Get the number of records in the histogram
+     */
+    uint64_t count() const {return _count;}
+
+    /**
+     * @brief Remove all records from the histogram
+     */
+    void clear();
+
+private:
+    std::array<uint32_t, HISTOGRAM_BUCKETS> _buckets{};
+    uint64_t _count{0};
+};
 
 class Accessor;
 
@@ -94,7 +140,10 @@ public:
 
     /**
      * @brief Exit point for timing section. Safe to call concurrently from
-     *       several threads.
+     *       several threads. Every calling thread gets a log queue of its own,
+     *       so threads don't contend with each other. If more than
+     *       MAX_TIMER_THREADS threads call this at the same time, the remaining
+     *       threads share a queue protected by a spinlock.
      * @param start_time A timestamp from a previous call to start_timer()
      * @param node_id An integer id to identify timings from this node
      */
@@ -103,9 +152,17 @@ public:
         if (_enabled)
         {
             TimingLogPoint tp{node_id, twine::current_rt_time() - start_time};
-            _queue_lock.lock();
-            _entry_queue.push(tp);
-            _queue_lock.unlock();
+            auto thread_log = _thread_log();
+            if (thread_log)
+            {
+                thread_log->push(tp);
+            }
+            else
+            {
+                _queue_lock.lock();
+                _entry_queue.push(tp);
+                _queue_lock.unlock();
+            }
             // if queue is full, drop entries silently.
         }
     }
@@ -152,8 +209,86 @@ protected:
     {
         int id {0};
         ProcessTimings timings;
+        TimingHistogram histogram;
+    };
+
+    using TimingLog = memory_relaxed_aquire_release::CircularFifo<TimingLogPoint, MAX_LOG_ENTRIES>;
+
+    /* The per-thread log queues are shared with the threads using them, so that a
+     * thread can return its queue when it exits, even if the timer is gone by then.
+     * The queues themselves are freed by the timer's destructor */
+    struct ThreadLogs
+    {
+        std::array<std::unique_ptr<TimingLog>, MAX_TIMER_THREADS> logs;
+        std::array<std::atomic<bool>, MAX_TIMER_THREADS> claimed{};
     };
 
+    /* Held by every thread in a thread_local, returns the claimed queue when the
+     * thread exits or starts logging to another timer */
+    struct ThreadLogClaim
+    {
+        ~ThreadLogClaim()
+        {
+            release();
+        }
+
+        void release()
+        {
+            if (index >= 0)
+            {
+                thread_logs->claimed[index].store(false, std::memory_order_release);
+            }
+            thread_logs.reset();
+            index = -1;
+        }
+
+        std::shared_ptr<ThreadLogs> thread_logs;
+        int instance_id{-1};
+        int index{-1};
+    };
+
+    /**
+     * @brief Get the log queue of the calling thread. The first call from a thread
+     *        claims a free queue, which is returned when the thread exits.
+     * @return A pointer to a single producer queue, or nullptr if all are claimed.
+     */
+    TimingLog* _thread_log()
+    {
+        // Timer instances are identified by id, as an address could be reused by a new instance
+        thread_local ThreadLogClaim claim;
+        if (claim.instance_id != _instance_id)
+        {
+            claim.release();
+            claim.instance_id = _instance_id;
+        }
+        if (claim.index < 0)
+        {
+            // Threads that didn't get a queue retry, as queues are returned when threads exit
+            claim.index = _claim_thread_log();
+            if (claim.index < 0)
+            {
+                return nullptr;
+            }
+            claim.thread_logs = _thread_logs;
+        }
+        return claim.thread_logs->logs[claim.index].get();
+    }
+
+    int _claim_thread_log()
+    {
+        for (int i = 0; i < MAX_TIMER_THREADS; ++i)
+        {
+            auto& claimed = _thread_logs->claimed[i];
+            bool expected = false;
+            if (claimed.load(std::memory_order_relaxed) == false &&
+                claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
     void _worker();
     void _update_timings();
 
@@ -167,7 +302,11 @@ protected:
     std::map<int, TimingNode> _timings;
     std::mutex _timing_lock;
     SpinLock _queue_lock;
-    alignas(ASSUMED_CACHE_LINE_SIZE) memory_relaxed_aquire_release::CircularFifo<TimingLogPoint, MAX_LOG_ENTRIES> _entry_queue;
+    alignas(ASSUMED_CACHE_LINE_SIZE) TimingLog _entry_queue;
+
+    // The queues are allocated when the timer is first enabled
+    std::shared_ptr<ThreadLogs> _thread_logs{std::make_shared<ThreadLogs>()};
+    int _instance_id{BaseIdGenerator<int>::new_id()};
 
 private:
     friend Accessor;
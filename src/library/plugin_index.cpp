@@ -0,0 +1,229 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Persistent index of installed plugins, used to avoid scanning all plugins at startup
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "elk-warning-suppressor/warning_suppressor.hpp"
+
+ELK_PUSH_WARNING
+ELK_DISABLE_TYPE_LIMITS
+#include "rapidjson/document.h"
+#include "rapidjson/istreamwrapper.h"
+#include "rapidjson/ostreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+ELK_POP_WARNING
+
+#include "elklog/static_logger.h"
+
+#include "plugin_index.h"
+
+namespace sushi::internal {
+
+ELKLOG_GET_LOGGER_WITH_MODULE_NAME("plugin index");
+
+constexpr int INDEX_VERSION = 1;
+
+namespace {
+
+const char* to_string(PluginType type)
+{
+    switch (type)
+    {
+        case PluginType::INTERNAL:  return "internal";
+        case PluginType::VST2X:     return "vst2x";
+        case PluginType::VST3X:     return "vst3x";
+        case PluginType::LV2:       return "lv2";
+        default:                    return "";
+    }
+}
+
+std::optional<PluginType> to_plugin_type(const std::string& type)
+{
+    for (auto t : {PluginType::INTERNAL, PluginType::VST2X, PluginType::VST3X, PluginType::LV2})
+    {
+        if (type == to_string(t))
+        {
+            return t;
+        }
+    }
+    return std::nullopt;
+}
+
+} // anonymous namespace
+
+bool PluginIndex::load()
+{
+    std::scoped_lock lock(_lock);
+    _entries.clear();
+    _modified = false;
+
+    std::ifstream file(_index_file);
+    if (!file.good())
+    {
+        ELKLOG_LOG_INFO("No plugin index found at {}", _index_file);
+        return false;
+    }
+
+    rapidjson::IStreamWrapper isw(file);
+    rapidjson::Document document;
+    document.ParseStream(isw);
+    if (document.HasParseError() || !document.IsObject() ||
+        !document.HasMember("version") || !document["version"].IsInt() ||
+        document["version"].GetInt() != INDEX_VERSION ||
+        !document.HasMember("plugins") || !document["plugins"].IsArray())
+    {
+        ELKLOG_LOG_WARNING("Plugin index {} is invalid or from another version, ignoring it", _index_file);
+        return false;
+    }
+
+    for (const auto& plugin : document["plugins"].GetArray())
+    {
+        if (!plugin.IsObject() || !plugin.HasMember("type") || !plugin["type"].IsString() ||
+            !plugin.HasMember("uid") || !plugin["uid"].IsString() ||
+            !plugin.HasMember("path") || !plugin["path"].IsString() ||
+            !plugin.HasMember("modified") || !plugin["modified"].IsInt64())
+        {
+            continue;
+        }
+        auto type = to_plugin_type(plugin["type"].GetString());
+        if (type.has_value())
+        {
+            _entries.push_back({type.value(),
+                                plugin["uid"].GetString(),
+                                plugin["path"].GetString(),
+                                plugin["modified"].GetInt64()});
+        }
+    }
+    ELKLOG_LOG_INFO("Loaded {} entries from plugin index {}", _entries.size(), _index_file);
+    return true;
+}
+
+bool PluginIndex::save()
+{
+    std::scoped_lock lock(_lock);
+    if (_modified == false)
+    {
+        return true;
+    }
+
+    rapidjson::Document document;
+    document.SetObject();
+    auto& allocator = document.GetAllocator();
+    rapidjson::Value plugins(rapidjson::kArrayType);
+    for (const auto& entry : _entries)
+    {
+        rapidjson::Value plugin(rapidjson::kObjectType);
+        plugin.AddMember("type", rapidjson::Value(to_string(entry.type), allocator).Move(), allocator);
+        plugin.AddMember("uid", rapidjson::Value(entry.uid.c_str(), allocator).Move(), allocator);
+        plugin.AddMember("path", rapidjson::Value(entry.path.c_str(), allocator).Move(), allocator);
+        plugin.AddMember("modified", rapidjson::Value(entry.modified).Move(), allocator);
+        plugins.PushBack(plugin, allocator);
+    }
+    document.AddMember("version", rapidjson::Value(INDEX_VERSION).Move(), allocator);
+    document.AddMember("plugins", plugins, allocator);
+
+    // Write to a temporary file first, so a reader never sees a partially written index
+    auto tmp_file = _index_file + ".tmp";
+    {
+        std::ofstream file(tmp_file);
+        if (!file.good())
+        {
+            ELKLOG_LOG_ERROR("Failed to open plugin index {} for writing", tmp_file);
+            return false;
+        }
+        rapidjson::OStreamWrapper osw(file);
+        rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(osw);
+        document.Accept(writer);
+    }
+    std::error_code error;
+    std::filesystem::rename(tmp_file, _index_file, error);
+    if (error)
+    {
+        ELKLOG_LOG_ERROR("Failed to write plugin index {}: {}", _index_file, error.message());
+        return false;
+    }
+    _modified = false;
+    return true;
+}
+
+std::optional<PluginIndexEntry> PluginIndex::lookup(PluginType type, const std::string& uid) const
+{
+    std::scoped_lock lock(_lock);
+    auto entry = _find(type, uid);
+    if (entry == _entries.end() || entry->modified != modification_time(entry->path))
+    {
+        return std::nullopt;
+    }
+    return *entry;
+}
+
+void PluginIndex::update(PluginType type, const std::string& uid, const std::string& path)
+{
+    auto modified = modification_time(path);
+    std::scoped_lock lock(_lock);
+    auto entry = _entries.begin() + std::distance(_entries.cbegin(), _find(type, uid));
+    if (entry == _entries.end())
+    {
+        _entries.push_back({type, uid, path, modified});
+        _modified = true;
+    }
+    else if (entry->path != path || entry->modified != modified)
+    {
+        entry->path = path;
+        entry->modified = modified;
+        _modified = true;
+    }
+}
+
+int PluginIndex::size() const
+{
+    std::scoped_lock lock(_lock);
+    return static_cast<int>(_entries.size());
+}
+
+int64_t PluginIndex::modification_time(const std::string& path)
+{
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error)
+    {
+        return 0;
+    }
+    if (std::filesystem::is_directory(path, error))
+    {
+        for (const auto& file : std::filesystem::directory_iterator(path, error))
+        {
+            time = std::max(time, file.last_write_time(error));
+        }
+    }
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+std::vector<PluginIndexEntry>::const_iterator PluginIndex::_find(PluginType type, const std::string& uid) const
+{
+    return std::find_if(_entries.cbegin(), _entries.cend(), [&](const auto& entry)
+    {
+        return entry.type == type && entry.uid == uid;
+    });
+}
+
+} // end namespace sushi::internal
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Persistent index of installed plugins, used to avoid scanning all plugins at startup
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_PLUGIN_INDEX_H
+#define SUSHI_PLUGIN_INDEX_H
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "sushi/constants.h"
+
+#include "library/processor.h"
+
+namespace sushi::internal {
+
+struct PluginIndexEntry
+{
+    PluginType type;
+    std::string uid;
+    std::string path;
+    int64_t modified;
+};
+
+/**
+ * @brief An index of plugin uids and the files or bundles they are installed in, stored
+ *        as a json file on disk. Every entry also stores the modification time of its
+ *        files, so that entries for plugins that were updated or removed since they were
+ *        indexed can be detected and rescanned individually.
+ */
+class PluginIndex
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(PluginIndex);
+
+    explicit PluginIndex(const std::string& index_file) : _index_file(index_file) {}
+
+    /**
+     * @brief Read the index from its file, replacing any entries in memory.
+     * @return true if the file was read, false if it did not exist or was not a valid index,
+     *         in which case the index is empty.
+     */
+    bool load();
+
+    /**
+     * @brief Write the index to its file, if it has changed since it was loaded or saved.
+     * @return true if the file was written or no write was needed, false on error.
+     */
+    bool save();
+
+    /**
+     * @brief Find the entry of a plugin. Entries whose files have been modified or
+     *        removed since they were indexed are treated as missing.
+     * @param type The plugin type
+     * @param uid The uid of the plugin, i.e. the URI for LV2 plugins
+     * @return The entry if found and still valid, otherwise nullopt.
+     */
+    std::optional<PluginIndexEntry> lookup(PluginType type, const std::string& uid) const;
+
+    /**
+     * @brief Add or replace the entry of a plugin. The modification time of path is
+     *        read and stored with the entry.
+     * @param type The plugin type
+     * @param uid The uid of the plugin
+     * @param path The file or bundle directory the plugin is installed in
+     */
+    void update(PluginType type, const std::string& uid, const std::string& path);
+
+    /**
+     * @return The number of entries in the index, including invalid ones.
+     */
+    int size() const;
+
+    /**
+     * @brief Get the modification time of a file, or for a directory, the latest
+     *        modification time of the directory itself and the files in it.
+     * @param path Path to a file or directory
+     * @return The modification time as a count of the filesystem clock, or 0 if
+     *         path does not exist.
+     */
+    static int64_t modification_time(const std::string& path);
+
+private:
+    std::vector<PluginIndexEntry>::const_iterator _find(PluginType type, const std::string& uid) const;
+
+    std::string _index_file;
+    std::vector<PluginIndexEntry> _entries;
+    bool _modified{false};
+    mutable std::mutex _lock;
+};
+
+} // end namespace sushi::internal
+
+#endif // SUSHI_PLUGIN_INDEX_H
@@ -380,12 +380,19 @@ public:
         _normalized_value = _pre_processor->to_normalized(_pre_processor->process_from_plugin(static_cast<T>(value_processed)));
     }
 
+    /* Changes to sample accurate parameters that have a sample offset within the chunk are
+     * queued by the plugin and applied when that part of the chunk is processed */
+    [[nodiscard]] bool sample_accurate() const {return _sample_accurate;}
+
+    void set_sample_accurate(bool sample_accurate) {_sample_accurate = sample_accurate;}
+
 private:
     ParameterType _type {enumerated_type};
     ParameterDescriptor* _descriptor {nullptr};
     ParameterPreProcessor<T>* _pre_processor {nullptr};
     T _processed_value;
     float _normalized_value; // Always not processed, but raw as set from the outside.
+    bool _sample_accurate {false};
 };
 
 /* Specialization for bool values, lack a pre_processor */
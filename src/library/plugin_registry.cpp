@@ -22,45 +22,69 @@
 
 namespace sushi::internal {
 
+std::mutex PluginRegistry::_serial_instantiation_lock;
+
 std::pair<ProcessorReturnCode, std::shared_ptr<Processor>>
 PluginRegistry::new_instance(const PluginInfo& plugin_info,
                              HostControl& host_control,
                              float sample_rate)
 {
-    if (_factories.count(plugin_info.type) == 0)
+    auto factory = _factory(plugin_info.type);
+    if (factory == nullptr)
+    {
+        return {ProcessorReturnCode::PLUGIN_LOAD_ERROR, nullptr};
+    }
+    if (factory->concurrent_instantiation_supported())
+    {
+        return factory->new_instance(plugin_info, host_control, sample_rate);
+    }
+    // Serializes with instances created from other threads, also through other registries
+    std::scoped_lock lock(_serial_instantiation_lock);
+    return factory->new_instance(plugin_info, host_control, sample_rate);
+}
+
+void PluginRegistry::set_plugin_index_file(const std::string& index_file)
+{
+    _plugin_index = std::make_shared<PluginIndex>(index_file);
+    _plugin_index->load();
+}
+
+BaseProcessorFactory* PluginRegistry::_factory(PluginType type)
+{
+    std::scoped_lock lock(_factories_lock);
+    if (_factories.count(type) == 0)
     {
-        switch (plugin_info.type)
+        switch (type)
         {
             case PluginType::INTERNAL:
             {
                 std::unique_ptr<BaseProcessorFactory> new_factory = std::make_unique<InternalProcessorFactory>();
-                _factories[plugin_info.type] = std::move(new_factory);
+                _factories[type] = std::move(new_factory);
                 break;
             }
             case PluginType::VST2X:
             {
                 std::unique_ptr<BaseProcessorFactory> new_factory = std::make_unique<vst2::Vst2xProcessorFactory>();
-                _factories[plugin_info.type] = std::move(new_factory);
+                _factories[type] = std::move(new_factory);
                 break;
             }
             case PluginType::VST3X:
             {
                 std::unique_ptr<BaseProcessorFactory> new_factory = std::make_unique<vst3::Vst3xProcessorFactory>();
-                _factories[plugin_info.type] = std::move(new_factory);
+                _factories[type] = std::move(new_factory);
                 break;
             }
             case PluginType::LV2:
             {
-                std::unique_ptr<BaseProcessorFactory> new_factory = std::make_unique<lv2::Lv2ProcessorFactory>();
-                _factories[plugin_info.type] = std::move(new_factory);
+                std::unique_ptr<BaseProcessorFactory> new_factory = std::make_unique<lv2::Lv2ProcessorFactory>(_plugin_index);
+                _factories[type] = std::move(new_factory);
                 break;
             }
             default:
-                return {ProcessorReturnCode::PLUGIN_LOAD_ERROR, nullptr};
+                return nullptr;
         }
     }
-
-    return _factories[plugin_info.type]->new_instance(plugin_info, host_control, sample_rate);
+    return _factories[type].get();
 }
 
 } // end namespace sushi::internal
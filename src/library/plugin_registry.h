@@ -22,10 +22,12 @@
 #ifndef SUSHI_PLUGIN_REGISTRY_H
 #define SUSHI_PLUGIN_REGISTRY_H
 
+#include <mutex>
 #include <unordered_map>
 
 #include "library/processor.h"
 #include "library/base_processor_factory.h"
+#include "library/plugin_index.h"
 #include "engine/base_engine.h"
 
 namespace sushi::internal {
@@ -45,8 +47,25 @@ public:
                                                                             HostControl& host_control,
                                                                             float sample_rate);
 
+    /**
+     * @brief Use a persistent plugin index to speed up plugin loading. The index is read
+     *        from index_file if it exists, and written back when new plugins are indexed.
+     *        Currently only used for LV2 plugins. Must be called before any plugins are
+     *        instantiated.
+     * @param index_file Path to the index file
+     */
+    void set_plugin_index_file(const std::string& index_file);
+
 private:
+    BaseProcessorFactory* _factory(PluginType type);
+
+    std::mutex _factories_lock;
     std::unordered_map<PluginType, std::unique_ptr<BaseProcessorFactory>, Hash> _factories;
+    std::shared_ptr<PluginIndex> _plugin_index;
+
+    /* Held while creating instances with factories that do not support concurrent instantiation.
+     * Shared by all registries, as several engines may live in the same process */
+    static std::mutex _serial_instantiation_lock;
 };
 
 } // end namespace sushi::internal
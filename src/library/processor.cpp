@@ -179,17 +179,34 @@ void Processor::output_midi_event_as_internal(MidiDataByte midi_data, int sample
     }
 }
 
-EventId Processor::request_non_rt_task(AsyncWorkCallback callback)
+EventId Processor::request_non_rt_task(AsyncWorkCallback callback, AsyncWorkPriority priority)
 {
-    auto event = RtEvent::make_async_work_event(callback, this->id(), this);
+    auto event = RtEvent::make_async_work_event(callback, this->id(), this, priority);
     output_event(event);
     return event.async_work_event()->event_id();
 }
 
 void Processor::async_delete(RtDeletable* object)
 {
-    auto rt_event = RtEvent::make_delete_data_event(object);
-    output_event(rt_event);
+    if (auto reclaimer = _host_control.reclaimer(); reclaimer)
+    {
+        reclaimer->retire(object);
+    }
+    else
+    {
+        auto rt_event = RtEvent::make_delete_data_event(object);
+        output_event(rt_event);
+    }
+}
+
+void Processor::async_delete(BlobData blob)
+{
+    auto reclaimer = _host_control.reclaimer();
+    if (reclaimer == nullptr || reclaimer->retire(blob) == false)
+    {
+        auto rt_event = RtEvent::make_delete_blob_event(blob);
+        output_event(rt_event);
+    }
 }
 
 void Processor::notify_state_change_rt()
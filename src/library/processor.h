@@ -22,6 +22,7 @@
 #ifndef SUSHI_PROCESSOR_H
 #define SUSHI_PROCESSOR_H
 
+#include <atomic>
 #include <map>
 #include <unordered_map>
 #include <vector>
@@ -381,6 +382,26 @@ public:
         return _on_track;
     }
 
+    /**
+     * @brief If the processor sends audio directly to another processor, outside of the
+     *        signal chain of its track, return the receiving processor. Used by the audio
+     *        graph to process the track of the receiver after the track of the sender.
+     * @return A pointer to the receiving processor, or nullptr if there is none.
+     */
+    virtual Processor* audio_send_destination() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * @brief Called from the audio thread to tell a processor that receives audio from
+     *        other processors whether all of its senders are processed before it within
+     *        the same audio chunk. If not, received audio needs to be delayed one chunk.
+     * @param processed_before true if all senders are guaranteed to be processed before
+     *        this processor, false otherwise.
+     */
+    virtual void set_senders_processed_before(bool /*processed_before*/) {}
+
     /**
      * @brief  Set the complete state of the Processor (bypass state, program, parameters)
      *         according to the supplied state object.
@@ -425,6 +446,15 @@ protected:
      */
     bool register_parameter(ParameterDescriptor* parameter, ObjectId id);
 
+    /**
+     * @brief Signal that audio connections between processors or the signal chain
+     *        of a track have changed. Safe to call from any thread.
+     */
+    void notify_audio_routing_changed()
+    {
+        _host_control.notify_audio_routing_changed();
+    }
+
     /**
      * @brief Convert midi data and output as an internal event, taking account any gate
      *        routing configurations active on the processor.
@@ -471,9 +501,11 @@ protected:
      * @param callback The callback to call in the non realtime thread. The return
      *        value from the callback will be communicated back to the plugin in the
      *        form of an AsyncWorkRtCompletionEvent RtEvent.
+     * @param priority Relative priority of the work, compared to work requested by
+     *        other processors. Work from the same processor is always done in order.
      * @return An EventId that can be used to identify the particular request.
      */
-    EventId request_non_rt_task(AsyncWorkCallback callback);
+    EventId request_non_rt_task(AsyncWorkCallback callback, AsyncWorkPriority priority = AsyncWorkPriority::NORMAL);
 
     /**
      * @brief Called from a realtime thread to asynchronously delete an object outside the rt tread
@@ -481,6 +513,13 @@ protected:
      */
     void async_delete(RtDeletable* object);
 
+    /**
+     * @brief Called from a realtime thread to asynchronously delete the data of a blob
+     *        outside the rt thread
+     * @param blob The blob whose data to delete.
+     */
+    void async_delete(BlobData blob);
+
     /**
      * @brief Called from a realtime thread to notify that all parameter values have changed and
      *        should be reloaded.
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2017-2023 Elk Audio AB
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI. If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Immutable snapshot of some data that can be read without locking while it is replaced
+ * @Copyright 2017-2023 Elk Audio AB, Stockholm
+ */
+
+#ifndef SUSHI_RCU_SNAPSHOT_H
+#define SUSHI_RCU_SNAPSHOT_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "sushi/constants.h"
+
+#include "spinlock.h"
+
+namespace sushi::internal {
+
+/**
+ * @brief Holds a read-only snapshot of T that is replaced as a whole when updated, in the
+ *        style of read-copy-update. Reading is wait free, readers only increment a counter
+ *        and load a pointer, so it is suitable for threads that must not block. publish()
+ *        swaps in a new snapshot and then waits until all readers that could have seen the
+ *        previous one are done before deleting it, so it must not be called from a thread
+ *        that holds a ReadLock.
+ *
+ *        Readers are counted in one of two counters selected by the current epoch. When
+ *        publishing, the epoch is flipped so that new readers use the other counter, which
+ *        means the old counter is guaranteed to reach zero even with continuous reading.
+ * @tparam T The type of the snapshot
+ */
+template <typename T>
+class RcuSnapshot
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(RcuSnapshot);
+
+    RcuSnapshot() = default;
+
+    explicit RcuSnapshot(std::unique_ptr<const T> snapshot) : _snapshot(snapshot.release()) {}
+
+    ~RcuSnapshot()
+    {
+        delete _snapshot.load();
+    }
+
+    /**
+     * @brief Scoped access to the current snapshot. The snapshot is guaranteed to stay
+     *        valid for the lifetime of the ReadLock, but is not updated while it is held.
+     */
+    class ReadLock
+    {
+    public:
+        SUSHI_DECLARE_NON_COPYABLE(ReadLock);
+
+        explicit ReadLock(const RcuSnapshot& parent) : _parent(parent)
+        {
+            _epoch = _parent._epoch.load();
+            _parent._readers[_epoch].count.fetch_add(1);
+            _snapshot = _parent._snapshot.load();
+        }
+
+        ~ReadLock()
+        {
+            _parent._readers[_epoch].count.fetch_sub(1);
+        }
+
+        /**
+         * @brief The snapshot, nullptr if nothing has been published yet
+         */
+        const T* get() const {return _snapshot;}
+
+        const T* operator->() const {return _snapshot;}
+
+    private:
+        const RcuSnapshot& _parent;
+        const T* _snapshot;
+        int _epoch;
+    };
+
+    /**
+     * @brief Replace the current snapshot. Blocks until all readers of the previous
+     *        snapshot are done with it. Not realtime safe.
+     * @param snapshot The new snapshot
+     */
+    void publish(std::unique_ptr<const T> snapshot)
+    {
+        std::scoped_lock lock(_publish_lock);
+        const T* previous = _snapshot.exchange(snapshot.release());
+
+        /* Readers increment a counter before loading the pointer, so a reader that could
+         * have seen the previous snapshot is always counted in one of them. Flipping twice
+         * also catches readers that loaded the epoch just before the first flip, but had
+         * not yet incremented the counter when it was checked. */
+        for (int i = 0; i < 2; ++i)
+        {
+            int old_epoch = _epoch.load();
+            _epoch.store(1 - old_epoch);
+            while (_readers[old_epoch].count.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        delete previous;
+    }
+
+private:
+    struct alignas(ASSUMED_CACHE_LINE_SIZE) ReaderCount
+    {
+        std::atomic<int> count{0};
+    };
+
+    alignas(ASSUMED_CACHE_LINE_SIZE) std::atomic<const T*> _snapshot{nullptr};
+    std::atomic<int> _epoch{0};
+    mutable ReaderCount _readers[2];
+    std::mutex _publish_lock;
+};
+
+} // end namespace sushi::internal
+
+#endif // SUSHI_RCU_SNAPSHOT_H
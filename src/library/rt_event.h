@@ -42,6 +42,7 @@ namespace sushi::internal {
 #endif
 
 class RtEvent;
+namespace engine {struct GraphTransaction;}
 inline bool is_keyboard_event(const RtEvent& event);
 inline bool is_engine_control_event(const RtEvent& event);
 inline bool is_returnable_event(const RtEvent& event);
@@ -83,6 +84,7 @@ enum class RtEventType
     REMOVE_PROCESSOR_FROM_TRACK,
     ADD_TRACK,
     REMOVE_TRACK,
+    GRAPH_TRANSACTION,
     ASYNC_WORK,
     ASYNC_WORK_NOTIFICATION,
     /* Routing events */
@@ -123,6 +125,8 @@ public:
      */
     int sample_offset() const {return _sample_offset;}
 
+    void set_sample_offset(int offset) {_sample_offset = offset;}
+
 protected:
     BaseRtEvent(RtEventType type, ObjectId target, int offset) : _type(type),
                                                                  _processor_id(target),
@@ -400,6 +404,17 @@ protected:
 };
 
 
+/* Order in which asynchronous work from different processors is started, if there is
+ * more work than threads to run it on. Only used by the AsyncWorkExecutor. */
+enum class AsyncWorkPriority : uint8_t
+{
+    HIGH,
+    NORMAL,
+    LOW
+};
+
+constexpr int ASYNC_WORK_PRIORITIES = 3;
+
 /**
  * @brief Baseclass for events that can be returned with a status code.
  */
@@ -422,6 +437,7 @@ public:
 
 protected:
     EventStatus _status;
+    AsyncWorkPriority _priority{AsyncWorkPriority::NORMAL};
     uint16_t _event_id;
 };
 
@@ -459,17 +475,41 @@ private:
     std::optional<ObjectId> _before_processor;
 };
 
+/**
+ * @brief Carries a batch of graph change events that are all applied in the same audio
+ *        period. The events are owned by the sender and must be kept alive until this
+ *        event has been returned.
+ */
+class GraphTransactionRtEvent : public ReturnableRtEvent
+{
+public:
+    explicit GraphTransactionRtEvent(engine::GraphTransaction* transaction) : ReturnableRtEvent(RtEventType::GRAPH_TRANSACTION, 0),
+                                                                               _transaction{transaction} {}
+
+    engine::GraphTransaction* transaction() const {return _transaction;}
+
+private:
+    engine::GraphTransaction* _transaction;
+};
+
 typedef int (*AsyncWorkCallback)(void* data, EventId id);
 
 class AsyncWorkRtEvent: public ReturnableRtEvent
 {
 public:
-    AsyncWorkRtEvent(AsyncWorkCallback callback, ObjectId processor, void* data) : ReturnableRtEvent(RtEventType::ASYNC_WORK,
-                                                                                                     processor),
-                                                                                   _callback{callback},
-                                                                                   _data{data} {}
+    AsyncWorkRtEvent(AsyncWorkCallback callback,
+                     ObjectId processor,
+                     void* data,
+                     AsyncWorkPriority priority) : ReturnableRtEvent(RtEventType::ASYNC_WORK, processor),
+                                                   _callback{callback},
+                                                   _data{data}
+    {
+        // Stored in the padding of ReturnableRtEvent to keep the size of the event down
+        _priority = priority;
+    }
     AsyncWorkCallback callback() const {return _callback;}
     void*             callback_data() const {return _data;}
+    AsyncWorkPriority priority() const {return _priority;}
 private:
     AsyncWorkCallback _callback;
     void*             _data;
@@ -669,6 +709,8 @@ public:
 
     int sample_offset() const {return _base_event.sample_offset();}
 
+    void set_sample_offset(int offset) {_base_event.set_sample_offset(offset);}
+
     /* Access functions protected by asserts */
     const KeyboardRtEvent* keyboard_event() const
     {
@@ -787,6 +829,18 @@ public:
         return &_processor_reorder_event;
     }
 
+    const GraphTransactionRtEvent* graph_transaction_event() const
+    {
+        assert(_graph_transaction_event.type() == RtEventType::GRAPH_TRANSACTION);
+        return &_graph_transaction_event;
+    }
+
+    GraphTransactionRtEvent* graph_transaction_event()
+    {
+        assert(_graph_transaction_event.type() == RtEventType::GRAPH_TRANSACTION);
+        return &_graph_transaction_event;
+    }
+
     const AsyncWorkRtEvent* async_work_event() const
     {
         assert(_async_work_event.type() == RtEventType::ASYNC_WORK);
@@ -1052,9 +1106,18 @@ public:
         return RtEvent(typed_event);
     }
 
-    static RtEvent make_async_work_event(AsyncWorkCallback callback, ObjectId processor, void* data)
+    static RtEvent make_graph_transaction_event(engine::GraphTransaction* transaction)
+    {
+        GraphTransactionRtEvent typed_event(transaction);
+        return RtEvent(typed_event);
+    }
+
+    static RtEvent make_async_work_event(AsyncWorkCallback callback,
+                                         ObjectId processor,
+                                         void* data,
+                                         AsyncWorkPriority priority = AsyncWorkPriority::NORMAL)
     {
-        AsyncWorkRtEvent typed_event(callback, processor, data);
+        AsyncWorkRtEvent typed_event(callback, processor, data, priority);
         return typed_event;
     }
 
@@ -1206,6 +1269,7 @@ private:
     RtEvent(const ReturnableRtEvent& e)                 : _returnable_event(e) {}
     RtEvent(const ProcessorOperationRtEvent& e)         : _processor_operation_event(e) {}
     RtEvent(const ProcessorReorderRtEvent& e)           : _processor_reorder_event(e) {}
+    RtEvent(const GraphTransactionRtEvent& e)           : _graph_transaction_event(e) {}
     RtEvent(const AsyncWorkRtEvent& e)                  : _async_work_event(e) {}
     RtEvent(const AsyncWorkRtCompletionEvent& e)        : _async_work_completion_event(e) {}
     RtEvent(const AudioConnectionRtEvent& e)            : _audio_connection_event(e) {}
@@ -1238,6 +1302,7 @@ private:
         ReturnableRtEvent             _returnable_event;
         ProcessorOperationRtEvent     _processor_operation_event;
         ProcessorReorderRtEvent       _processor_reorder_event;
+        GraphTransactionRtEvent       _graph_transaction_event;
         AsyncWorkRtEvent              _async_work_event;
         AsyncWorkRtCompletionEvent    _async_work_completion_event;
         AudioConnectionRtEvent        _audio_connection_event;
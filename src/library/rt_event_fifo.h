@@ -21,10 +21,17 @@
 #ifndef SUSHI_REALTIME_FIFO_H
 #define SUSHI_REALTIME_FIFO_H
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+
 #include "elk-warning-suppressor/warning_suppressor.hpp"
 
+#include "sushi/sushi_time.h"
+
 #include "fifo/circularfifo_memory_relaxed_aquire_release.h"
 #include "library/simple_fifo.h"
+#include "library/spinlock.h"
 #include "library/rt_event.h"
 #include "library/rt_event_pipe.h"
 
@@ -44,6 +51,7 @@ class RtSafeRtEventFifo : public RtEventPipe
 public:
     inline bool push(const RtEvent& event)
     {
+        _events_pushed |= event.type() != RtEventType::SYNC;
         return _fifo.push(event);
     }
 
@@ -57,6 +65,18 @@ public:
         return _fifo.wasEmpty();
     }
 
+    /**
+     * @brief Check if any events other than synchronisation events were pushed since the
+     *        last call. Must only be called from the thread pushing events.
+     * @return true if events other than synchronisation events were pushed
+     */
+    inline bool take_events_pushed()
+    {
+        bool pushed = _events_pushed;
+        _events_pushed = false;
+        return pushed;
+    }
+
     void send_event(const RtEvent &event) override
     {
         push(event);
@@ -64,6 +84,7 @@ public:
 
 private:
     memory_relaxed_aquire_release::CircularFifo<RtEvent, MAX_EVENTS_IN_QUEUE> _fifo;
+    bool _events_pushed{false};
 };
 
 /**
@@ -81,6 +102,102 @@ public:
     void send_event(const RtEvent &event) override {SimpleFifo<RtEvent, size>::push(event);}
 };
 
+/**
+ * @brief An RtEvent together with the real time at which it should take effect
+ */
+struct TimedRtEvent
+{
+    RtEvent event;
+    Time timestamp;
+};
+
+/**
+ * @brief Lock free fifo queue of timestamped RtEvents that several threads can push to
+ *        concurrently, while only a single thread may pop from it. Pushing and popping are
+ *        both wait free as long as no other thread is preempted in the middle of a push,
+ *        in which case events pushed after that appear to be missing until it is resumed.
+ *        Uses a fixed array of slots with a sequence number each, after Dmitry Vyukov's
+ *        bounded queue.
+ * @tparam size Number of events to store in the queue, must be a power of 2
+ */
+template <size_t size = MAX_EVENTS_IN_QUEUE>
+class TimedRtEventFifo
+{
+    static_assert((size & (size - 1)) == 0, "Size must be a power of 2");
+
+public:
+    TimedRtEventFifo()
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Push an event to the queue. Safe to call from several threads concurrently.
+     * @return true if the event was queued, false if the queue is full
+     */
+    bool push(const RtEvent& event, Time timestamp)
+    {
+        size_t pos = _write_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& slot = _slots[pos & MASK];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (_write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.data = {event, timestamp};
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = _write_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Pop the oldest event from the queue. Must only be called from one thread.
+     * @return true if an event was popped, false if the queue is empty
+     */
+    bool pop(TimedRtEvent& event)
+    {
+        auto& slot = _slots[_read_pos & MASK];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != _read_pos + 1)
+        {
+            return false;
+        }
+        event = slot.data;
+        slot.sequence.store(_read_pos + size, std::memory_order_release);
+        _read_pos++;
+        return true;
+    }
+
+private:
+    static constexpr size_t MASK = size - 1;
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        TimedRtEvent data;
+    };
+
+    std::array<Slot, size> _slots;
+    alignas(ASSUMED_CACHE_LINE_SIZE) std::atomic<size_t> _write_pos{0};
+    alignas(ASSUMED_CACHE_LINE_SIZE) size_t _read_pos{0};
+};
+
 } //end namespace sushi::internal
 
 ELK_POP_WARNING
@@ -24,6 +24,7 @@
 #include <condition_variable>
 #include <chrono>
 #include <deque>
+#include <mutex>
 
 template <class T> class SynchronizedQueue
 {
@@ -50,13 +51,27 @@ public:
         return message;
     }
 
-    void wait_for_data(const std::chrono::milliseconds& timeout)
+    /**
+     * @brief Block until there is data in the queue, the timeout expires or
+     *        wake_up() is called.
+     * @param timeout Max time to wait
+     */
+    template <class Rep, class Period>
+    void wait_for_data(const std::chrono::duration<Rep, Period>& timeout)
     {
-        if (_queue.empty())
-        {
-            std::unique_lock<std::mutex> lock(_wait_mutex);
-            _notifier.wait_for(lock, timeout);
-        }
+        std::unique_lock<std::mutex> lock(_queue_mutex);
+        _notifier.wait_for(lock, timeout, [&] {return !_queue.empty() || _woken_up;});
+        _woken_up = false;
+    }
+
+    /**
+     * @brief Wake up a thread waiting in wait_for_data(), even if the queue is empty
+     */
+    void wake_up()
+    {
+        std::lock_guard<std::mutex> lock(_queue_mutex);
+        _woken_up = true;
+        _notifier.notify_one();
     }
 
     bool empty()
@@ -66,8 +81,8 @@ public:
 private:
     std::deque<T>           _queue;
     std::mutex              _queue_mutex;
-    std::mutex              _wait_mutex;
     std::condition_variable _notifier;
+    bool                    _woken_up{false};
 };
 
 #endif // SUSHI_SYNCHRONISED_FIFO_H
@@ -64,9 +64,53 @@ namespace sushi::internal::vst2 {
 
 ELKLOG_GET_LOGGER_WITH_MODULE_NAME("vst2");
 
-#if defined(__linux__)
+std::mutex PluginLoader::_library_lock;
+std::unordered_map<std::string, PluginLoader::CachedLibrary> PluginLoader::_libraries;
 
 LibraryHandle PluginLoader::get_library_handle_for_plugin(const std::string& plugin_absolute_path)
+{
+    std::scoped_lock lock(_library_lock);
+    if (auto entry = _libraries.find(plugin_absolute_path); entry != _libraries.end())
+    {
+        entry->second.ref_count++;
+        return entry->second.handle;
+    }
+
+    auto handle = _open_library(plugin_absolute_path);
+    if (handle != nullptr)
+    {
+        _libraries[plugin_absolute_path] = {handle, 1};
+    }
+    return handle;
+}
+
+void PluginLoader::close_library_handle(LibraryHandle library_handle)
+{
+    std::scoped_lock lock(_library_lock);
+    for (auto entry = _libraries.begin(); entry != _libraries.end(); ++entry)
+    {
+        if (entry->second.handle == library_handle)
+        {
+            if (--entry->second.ref_count > 0)
+            {
+                return;
+            }
+            _libraries.erase(entry);
+            break;
+        }
+    }
+    _close_library(library_handle);
+}
+
+int PluginLoader::open_libraries()
+{
+    std::scoped_lock lock(_library_lock);
+    return static_cast<int>(_libraries.size());
+}
+
+#if defined(__linux__)
+
+LibraryHandle PluginLoader::_open_library(const std::string& plugin_absolute_path)
 {
     if (! std::filesystem::exists(plugin_absolute_path))
     {
@@ -115,7 +159,7 @@ AEffect* PluginLoader::load_plugin(LibraryHandle library_handle)
     return plugin;
 }
 
-void PluginLoader::close_library_handle(LibraryHandle library_handle)
+void PluginLoader::_close_library(LibraryHandle library_handle)
 {
     if (dlclose(library_handle) != 0)
     {
@@ -124,7 +168,7 @@ void PluginLoader::close_library_handle(LibraryHandle library_handle)
 }
 
 #elif defined(__APPLE__)
-LibraryHandle PluginLoader::get_library_handle_for_plugin(const std::string& plugin_absolute_path)
+LibraryHandle PluginLoader::_open_library(const std::string& plugin_absolute_path)
 {
     CFURLRef bundle_url;
     CFBundleRef bundle_handle;
@@ -183,7 +227,7 @@ AEffect* PluginLoader::load_plugin(LibraryHandle library_handle)
     return plugin;
 }
 
-void PluginLoader::close_library_handle(LibraryHandle library_handle)
+void PluginLoader::_close_library(LibraryHandle library_handle)
 {
     // Not sure if we should really need to unload the executable manually.
     // Apples docs say that as long you match the number of "CFBundleCreate..." with
@@ -204,7 +248,7 @@ void PluginLoader::close_library_handle(LibraryHandle library_handle)
     }
 }
 #elif defined(_MSC_VER)
-LibraryHandle PluginLoader::get_library_handle_for_plugin(const std::string& plugin_absolute_path)
+LibraryHandle PluginLoader::_open_library(const std::string& plugin_absolute_path)
 {
     if (!std::filesystem::exists(plugin_absolute_path))
     {
@@ -253,7 +297,7 @@ AEffect* PluginLoader::load_plugin(LibraryHandle library_handle)
     return plugin;
 }
 
-void PluginLoader::close_library_handle(LibraryHandle library_handle)
+void PluginLoader::_close_library(LibraryHandle library_handle)
 {
     if (library_handle != nullptr)
     {
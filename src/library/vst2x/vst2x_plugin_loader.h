@@ -48,7 +48,9 @@
 #ifndef SUSHI_VST2X_PLUGIN_LOADER_H
 #define SUSHI_VST2X_PLUGIN_LOADER_H
 
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "elk-warning-suppressor/warning_suppressor.hpp"
 
@@ -67,11 +69,15 @@ namespace sushi::internal::vst2 {
 using LibraryHandle = void*;
 
 // TODO:
-//      this class is stateless atm (basically a namespace),
-//      but it should probably grow into the access point to plugins stored in the
-//      system, with features like directory scanning, caching, easier handling
-//      of library handles, etc.
+//      this class should probably grow into the access point to plugins stored in the
+//      system, with features like directory scanning, etc.
 
+/**
+ * @brief Static access point for loading plugin libraries. Library handles are cached
+ *        and reference counted per path, so that all instances of a plugin share one
+ *        opened library. Every call to get_library_handle_for_plugin() must be matched
+ *        by a call to close_library_handle(), the library is closed by the last one.
+ */
 class PluginLoader
 {
 public:
@@ -80,6 +86,25 @@ public:
     static AEffect* load_plugin(LibraryHandle library_handle);
 
     static void close_library_handle(LibraryHandle library_handle);
+
+    /**
+     * @return The number of libraries currently held open by the loader
+     */
+    static int open_libraries();
+
+private:
+    struct CachedLibrary
+    {
+        LibraryHandle handle;
+        int ref_count;
+    };
+
+    static LibraryHandle _open_library(const std::string& plugin_absolute_path);
+
+    static void _close_library(LibraryHandle library_handle);
+
+    static std::mutex _library_lock;
+    static std::unordered_map<std::string, CachedLibrary> _libraries;
 };
 
 } // end namespace sushi::internal::vst2
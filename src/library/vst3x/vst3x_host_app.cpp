@@ -156,6 +156,51 @@ bool ConnectionProxy::disconnect()
     return  status == Steinberg::kResultTrue;
 }
 
+ModuleCache& ModuleCache::_instance()
+{
+    static ModuleCache cache;
+    return cache;
+}
+
+std::shared_ptr<VST3::Hosting::Module> ModuleCache::get_module(const std::string& path, std::string& error_msg)
+{
+    auto& cache = _instance();
+    // The lock is held while loading so that concurrent instantiations of the same
+    // plugin wait for the first one instead of loading the module twice
+    std::scoped_lock lock(cache._lock);
+    if (auto entry = cache._modules.find(path); entry != cache._modules.end())
+    {
+        if (auto module = entry->second.lock(); module)
+        {
+            return module;
+        }
+        cache._modules.erase(entry);
+    }
+
+    auto module = VST3::Hosting::Module::create(path, error_msg);
+    if (module)
+    {
+        ELKLOG_LOG_DEBUG("Loaded VST3 module {}", path);
+        cache._modules[path] = module;
+    }
+    return module;
+}
+
+int ModuleCache::loaded_modules()
+{
+    auto& cache = _instance();
+    std::scoped_lock lock(cache._lock);
+    int count = 0;
+    for (const auto& [path, module] : cache._modules)
+    {
+        if (module.expired() == false)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
 PluginInstance::PluginInstance(SushiHostApplication* host_app): _host_app(host_app)
 {}
 
@@ -174,7 +219,7 @@ PluginInstance::~PluginInstance()
 bool PluginInstance::load_plugin(const std::string& plugin_path, const std::string& plugin_name)
 {
     std::string error_msg;
-    _module = VST3::Hosting::Module::create(plugin_path, error_msg);
+    _module = ModuleCache::get_module(plugin_path, error_msg);
     if (!_module)
     {
         ELKLOG_LOG_ERROR("Failed to load VST3 Module: {}", error_msg);
@@ -21,6 +21,11 @@
 #ifndef SUSHI_VST3X_HOST_CONTEXT_H
 #define SUSHI_VST3X_HOST_CONTEXT_H
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include "sushi/constants.h"
 
 #include "library/id_generator.h"
@@ -78,6 +83,39 @@ private:
     HostControl*  _host_control;
 };
 
+/**
+ * @brief Process wide cache of loaded plugin modules, keyed on their path. All plugin
+ *        instances loaded from the same path share one module and its factory. Modules
+ *        are only held weakly by the cache, so they are unloaded when the last plugin
+ *        instance using them is deleted.
+ */
+class ModuleCache
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(ModuleCache);
+
+    /**
+     * @brief Get the module loaded from path, loading it if it is not already loaded.
+     *        Safe to call from several threads concurrently.
+     * @param path Absolute path to the module
+     * @param error_msg Set to an error message if loading fails
+     * @return A shared module, or an empty pointer if loading failed
+     */
+    static std::shared_ptr<VST3::Hosting::Module> get_module(const std::string& path, std::string& error_msg);
+
+    /**
+     * @return The number of modules currently loaded
+     */
+    static int loaded_modules();
+
+private:
+    ModuleCache() = default;
+    static ModuleCache& _instance();
+
+    std::mutex _lock;
+    std::unordered_map<std::string, std::weak_ptr<VST3::Hosting::Module>> _modules;
+};
+
 /**
  * @brief Container to hold plugin modules and manage their lifetimes
  */
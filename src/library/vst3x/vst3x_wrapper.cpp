@@ -248,7 +248,7 @@ void Vst3xWrapper::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSample
 
     if (_notify_parameter_change)
     {
-        request_non_rt_task(parameter_update_callback);
+        request_non_rt_task(parameter_update_callback, AsyncWorkPriority::LOW);
         _notify_parameter_change = false;
     }
 
@@ -41,6 +41,7 @@ HighPassPlugin::HighPassPlugin(HostControl host_control) : InternalPlugin(host_c
                                           new CubicWarpPreProcessor(20.0f, 20'000.0f));
 
     assert(_frequency);
+    enable_sample_accurate_automation(_frequency);
 }
 
 ProcessorReturnCode HighPassPlugin::init(float sample_rate)
@@ -91,9 +92,6 @@ void HighPassPlugin::process_event(const RtEvent& event)
 
 void HighPassPlugin::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer)
 {
-    /* Update parameter values */
-    bw_hp1_set_cutoff(&_hp1_coeffs, _frequency->processed_value());
-
     if (!_bypassed)
     {
         std::array<const float *, MAX_TRACK_CHANNELS> in_channel_ptrs {};
@@ -105,19 +103,27 @@ void HighPassPlugin::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSamp
             out_channel_ptrs[i] = out_buffer.channel(i);
         }
 
-        bw_hp1_update_coeffs_ctrl(&_hp1_coeffs);
-        for (int n = 0; n < AUDIO_CHUNK_SIZE; n++)
+        // The channel pointers are advanced across segments, so the offset is not needed
+        process_in_segments([&](int /*offset*/, int samples)
         {
-            bw_hp1_update_coeffs_audio(&_hp1_coeffs);
-            for (int i = 0; i < _current_input_channels; i++)
+            /* Update parameter values */
+            bw_hp1_set_cutoff(&_hp1_coeffs, _frequency->processed_value());
+            bw_hp1_update_coeffs_ctrl(&_hp1_coeffs);
+            for (int n = 0; n < samples; n++)
             {
-                *out_channel_ptrs[i]++ = bw_hp1_process1(&_hp1_coeffs, &_hp1_states[i],
-                                                         *in_channel_ptrs[i]++);
+                bw_hp1_update_coeffs_audio(&_hp1_coeffs);
+                for (int i = 0; i < _current_input_channels; i++)
+                {
+                    *out_channel_ptrs[i]++ = bw_hp1_process1(&_hp1_coeffs, &_hp1_states[i],
+                                                             *in_channel_ptrs[i]++);
+                }
             }
-        }
+        });
     }
     else
     {
+        apply_queued_parameter_changes();
+        bw_hp1_set_cutoff(&_hp1_coeffs, _frequency->processed_value());
         bypass_process(in_buffer, out_buffer);
     }
 }
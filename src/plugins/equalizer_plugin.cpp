@@ -51,6 +51,9 @@ EqualizerPlugin::EqualizerPlugin(HostControl host_control) : InternalPlugin(host
     assert(_frequency);
     assert(_gain);
     assert(_q);
+    enable_sample_accurate_automation(_frequency);
+    enable_sample_accurate_automation(_gain);
+    enable_sample_accurate_automation(_q);
 }
 
 ProcessorReturnCode EqualizerPlugin::init(float sample_rate)
@@ -75,25 +78,31 @@ void EqualizerPlugin::set_enabled(bool enabled)
 
 void EqualizerPlugin::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer)
 {
-    /* Update parameter values */
-    float frequency = _frequency->processed_value();
-    float gain = _gain->processed_value();
-    float q = _q->processed_value();
-
     if (!_bypassed)
     {
         /* Recalculate the coefficients once per audio chunk, this makes for
-         * predictable cpu load for every chunk */
-        dsp::biquad::Coefficients coefficients;
-        dsp::biquad::calc_biquad_peak(coefficients, _sample_rate, frequency, q, gain);
-        for (int i = 0; i < _current_input_channels; ++i)
+         * predictable cpu load for every chunk. With sample accurate automation,
+         * they are also recalculated where parameter changes fall in the chunk */
+        process_in_segments([&](int offset, int samples)
         {
-            _filters[i].set_coefficients(coefficients);
-            _filters[i].process(in_buffer.channel(i), out_buffer.channel(i), AUDIO_CHUNK_SIZE);
-        }
+            dsp::biquad::Coefficients coefficients;
+            dsp::biquad::calc_biquad_peak(coefficients, _sample_rate, _frequency->processed_value(),
+                                          _q->processed_value(), _gain->processed_value());
+            std::array<const float*, MAX_CHANNELS_SUPPORTED> in_channels;
+            std::array<float*, MAX_CHANNELS_SUPPORTED> out_channels;
+            for (int i = 0; i < _current_input_channels; ++i)
+            {
+                in_channels[i] = in_buffer.channel(i) + offset;
+                out_channels[i] = out_buffer.channel(i) + offset;
+            }
+            // All channels are filtered together with the same coefficients
+            _filter.set_coefficients(coefficients);
+            _filter.process(in_channels.data(), out_channels.data(), _current_input_channels, samples);
+        });
     }
     else
     {
+        apply_queued_parameter_changes();
         bypass_process(in_buffer, out_buffer);
     }
 }
@@ -105,11 +114,8 @@ std::string_view EqualizerPlugin::static_uid()
 
 void EqualizerPlugin::_reset_filters()
 {
-    for (auto& filter : _filters)
-    {
-        filter.set_smoothing(AUDIO_CHUNK_SIZE);
-        filter.reset();
-    }
+    _filter.set_smoothing(AUDIO_CHUNK_SIZE);
+    _filter.reset();
 }
 
 } // end namespace sushi::internal::equalizer_plugin
\ No newline at end of file
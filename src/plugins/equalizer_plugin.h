@@ -29,7 +29,7 @@ ELK_DISABLE_DOMINANCE_INHERITANCE
 
 namespace sushi::internal::equalizer_plugin {
 
-constexpr int MAX_CHANNELS_SUPPORTED = 2;
+constexpr int MAX_CHANNELS_SUPPORTED = dsp::biquad::MAX_BIQUAD_CHANNELS;
 
 class Accessor;
 
@@ -56,7 +56,7 @@ private:
     void _reset_filters();
 
     float _sample_rate;
-    std::array<dsp::biquad::BiquadFilter, MAX_CHANNELS_SUPPORTED> _filters;
+    dsp::biquad::MultichannelBiquadFilter _filter;
 
     FloatParameterValue* _frequency;
     FloatParameterValue* _gain;
@@ -36,19 +36,38 @@ GainPlugin::GainPlugin(HostControl host_control) : InternalPlugin(host_control)
                                                Direction::AUTOMATABLE,
                                                new dBToLinPreProcessor(-120.0f, 24.0f));
     assert(_gain_parameter);
+    enable_sample_accurate_automation(_gain_parameter);
 }
 
 GainPlugin::~GainPlugin() = default;
 
 void GainPlugin::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer)
 {
-    float gain = _gain_parameter->processed_value();
     if (!_bypassed)
     {
         out_buffer.clear();
-        out_buffer.add_with_gain(in_buffer, gain);
+        process_in_segments([&](int offset, int samples)
+        {
+            float gain = _gain_parameter->processed_value();
+            if (samples == AUDIO_CHUNK_SIZE)
+            {
+                out_buffer.add_with_gain(in_buffer, gain);
+                return;
+            }
+            // Same channel rules as SampleBuffer::add_with_gain()
+            if (in_buffer.channel_count() != 1 && in_buffer.channel_count() != out_buffer.channel_count())
+            {
+                return;
+            }
+            for (int c = 0; c < out_buffer.channel_count(); ++c)
+            {
+                int in_channel = in_buffer.channel_count() == 1 ? 0 : c;
+                kernels::add_with_gain(out_buffer.channel(c) + offset, in_buffer.channel(in_channel) + offset, gain, samples);
+            }
+        });
     } else
     {
+        apply_queued_parameter_changes();
         bypass_process(in_buffer, out_buffer);
     }
 }
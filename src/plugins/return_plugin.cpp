@@ -50,7 +50,10 @@ void ReturnPlugin::send_audio(const ChunkSampleBuffer& buffer, int start_channel
 {
     std::scoped_lock<SpinLock> lock(_buffer_lock);
 
-    _maybe_swap_buffers(_host_control.transport()->current_process_time());
+    if (_senders_processed_before == false)
+    {
+        _maybe_swap_buffers(_host_control.transport()->current_process_time());
+    }
 
     int max_channels = std::max(0, std::min(buffer.channel_count(), _current_output_channels - start_channel));
 
@@ -65,7 +68,10 @@ void ReturnPlugin::send_audio_with_ramp(const ChunkSampleBuffer& buffer, int sta
 {
     std::scoped_lock<SpinLock> lock(_buffer_lock);
 
-    _maybe_swap_buffers(_host_control.transport()->current_process_time());
+    if (_senders_processed_before == false)
+    {
+        _maybe_swap_buffers(_host_control.transport()->current_process_time());
+    }
 
     int max_channels = std::max(0, std::min(buffer.channel_count(), _current_output_channels - start_channel));
 
@@ -141,24 +147,25 @@ void ReturnPlugin::process_event(const RtEvent& event)
 
 void ReturnPlugin::process_audio(const ChunkSampleBuffer& /*in_buffer*/, ChunkSampleBuffer& out_buffer)
 {
+    auto current_time = _host_control.transport()->current_process_time();
+
+    if (_senders_processed_before)
     {
+        /* All senders have already sent their audio for this chunk, so it can be output
+         * directly. Buffers are swapped after output, so that audio from senders not
+         * processed before this plugin is output in the next chunk instead. */
         std::scoped_lock<SpinLock> lock(_buffer_lock);
-        _maybe_swap_buffers(_host_control.transport()->current_process_time());
+        _last_process_time.store(current_time, std::memory_order_release);
+        _output_audio(*_active_in, out_buffer);
+        _swap_buffers();
     }
-
-    if (_bypass_manager.should_process())
+    else
     {
-        auto buffer = ChunkSampleBuffer::create_non_owning_buffer(*_active_out, 0, out_buffer.channel_count());
-        out_buffer.replace(buffer);
-
-        if (_bypass_manager.should_ramp())
         {
-            _bypass_manager.ramp_output(out_buffer);
+            std::scoped_lock<SpinLock> lock(_buffer_lock);
+            _maybe_swap_buffers(current_time);
         }
-    }
-    else
-    {
-        out_buffer.clear();
+        _output_audio(*_active_out, out_buffer);
     }
 }
 
@@ -172,11 +179,34 @@ void ReturnPlugin::set_bypassed(bool bypassed)
     _host_control.post_event(std::make_unique<SetProcessorBypassEvent>(this->id(), bypassed, IMMEDIATE_PROCESS));
 }
 
+void ReturnPlugin::set_senders_processed_before(bool processed_before)
+{
+    _senders_processed_before = processed_before;
+}
+
 std::string_view ReturnPlugin::static_uid()
 {
     return PLUGIN_UID;
 }
 
+void inline ReturnPlugin::_output_audio(ChunkSampleBuffer& source, ChunkSampleBuffer& out_buffer)
+{
+    if (_bypass_manager.should_process())
+    {
+        auto buffer = ChunkSampleBuffer::create_non_owning_buffer(source, 0, out_buffer.channel_count());
+        out_buffer.replace(buffer);
+
+        if (_bypass_manager.should_ramp())
+        {
+            _bypass_manager.ramp_output(out_buffer);
+        }
+    }
+    else
+    {
+        out_buffer.clear();
+    }
+}
+
 void inline ReturnPlugin::_swap_buffers()
 {
     std::swap(_active_in, _active_out);
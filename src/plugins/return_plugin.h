@@ -75,11 +75,15 @@ public:
 
     void set_bypassed(bool bypassed) override;
 
+    void set_senders_processed_before(bool processed_before) override;
+
     static std::string_view static_uid();
 
 private:
     friend Accessor;
 
+    void inline _output_audio(ChunkSampleBuffer& source, ChunkSampleBuffer& out_buffer);
+
     void inline _swap_buffers();
 
     void inline _maybe_swap_buffers(Time current_time);
@@ -101,6 +105,9 @@ private:
 
     std::atomic<Time>                     _last_process_time{Time(0)};
 
+    // If true, audio sent during the current chunk is output without delay
+    bool                                  _senders_processed_before{false};
+
     static_assert(decltype(_last_process_time)::is_always_lock_free);
 };
 
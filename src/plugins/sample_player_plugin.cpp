@@ -232,9 +232,7 @@ void SamplePlayerPlugin::process_event(const RtEvent& event)
             _sample.set_sample(_sample_buffer, static_cast<int>(new_sample.size / sizeof(float)));
 
             // Delete the old sample data outside the rt thread
-            BlobData data{0, reinterpret_cast<uint8_t*>(old_sample)};
-            auto delete_event = RtEvent::make_delete_blob_event(data);
-            output_event(delete_event);
+            async_delete(BlobData{0, reinterpret_cast<uint8_t*>(old_sample)});
             break;
         }
 
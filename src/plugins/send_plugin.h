@@ -67,6 +67,8 @@ public:
 
     ProcessorReturnCode set_property_value(ObjectId property_id, const std::string& value) override;
 
+    Processor* audio_send_destination() const override;
+
     static std::string_view static_uid();
 
 private:
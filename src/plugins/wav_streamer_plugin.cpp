@@ -503,7 +503,7 @@ bool WavStreamerPlugin::_load_new_block()
     if (_block_queue.wasEmpty())
     {
         // Schedule a task to load more blocks.
-        request_non_rt_task(read_data_callback);
+        request_non_rt_task(read_data_callback, AsyncWorkPriority::HIGH);
     }
 
     return _current_block;
@@ -108,6 +108,47 @@ TEST_F(TestOfflineFrontend, TestWavProcessing)
     sf_close(output_file);
 }
 
+TEST_F(TestOfflineFrontend, TestMultichannelWavProcessing)
+{
+    char const* test_data_dir = GetEnv("SUSHI_TEST_DATA_DIR");
+    if (test_data_dir == nullptr)
+    {
+        EXPECT_TRUE(false) << "Can't access Test Data environment variable";
+    }
+
+    // Initialize with a file containing 300 frames of 0.5 on 4 channels
+    constexpr int FILE_CHANNELS = 4;
+    constexpr int FILE_FRAMES = 300;
+    std::string test_data_file(test_data_dir);
+    test_data_file.append("/test_sndfile_4ch_05.wav");
+    std::string output_file_name("./test_out_4ch.wav");
+    OfflineFrontendConfiguration config(test_data_file, output_file_name, false, CV_CHANNELS, CV_CHANNELS);
+    auto ret_code = _module_under_test->init(&config);
+    ASSERT_EQ(AudioFrontendStatus::OK, ret_code);
+
+    _module_under_test->run();
+
+    auto stats = _module_under_test->render_stats();
+    EXPECT_EQ(FILE_FRAMES, stats.frames);
+    EXPECT_GT(stats.audio_duration.count(), 0.0);
+
+    SF_INFO soundfile_info;
+    memset(&soundfile_info, 0, sizeof(soundfile_info));
+    SNDFILE* output_file = sf_open(output_file_name.c_str(), SFM_READ, &soundfile_info);
+    ASSERT_NE(nullptr, output_file);
+    ASSERT_EQ(FILE_CHANNELS, soundfile_info.channels);
+    ASSERT_EQ(FILE_FRAMES, soundfile_info.frames);
+
+    float file_buffer[FILE_CHANNELS * FILE_FRAMES];
+    auto readcount = sf_readf_float(output_file, file_buffer, static_cast<sf_count_t>(FILE_FRAMES));
+    ASSERT_EQ(FILE_FRAMES, readcount);
+    for (auto sample : file_buffer)
+    {
+        ASSERT_FLOAT_EQ(0.5f, sample);
+    }
+    sf_close(output_file);
+}
+
 TEST_F(TestOfflineFrontend, TestInvalidInputFile)
 {
     OfflineFrontendConfiguration config("this_is_not_a_valid_file.extension", "./test_out.wav", false, CV_CHANNELS, CV_CHANNELS);
@@ -343,6 +343,23 @@ TEST_F(TestOSCFrontend, TestParamChangeNotification)
     _module_under_test->process(event.get()); // But this should - the one expected.
 }
 
+TEST_F(TestOSCFrontend, TestParamChangeBatchNotification)
+{
+    EXPECT_CALL(*_mock_osc_interface, send(StrEq("/parameter/proc/param_1"), testing::Matcher<float>(0.5f))).Times(1);
+    EXPECT_CALL(*_mock_osc_interface, send(StrEq("/parameter/proc/gain"), testing::Matcher<float>(0.25f))).Times(1);
+
+    ObjectId processor_id = _test_processor->id();
+    ObjectId param_1_id = _test_processor->parameter_from_name("param 1")->id();
+    ObjectId gain_id = _test_processor->parameter_from_name("gain")->id();
+
+    _module_under_test->connect_from_all_parameters();
+
+    std::vector<ParameterChangeBatchNotificationEvent::ParameterChange> changes = {{processor_id, param_1_id, 0.5f, 0.0f},
+                                                                                   {processor_id, gain_id, 0.25f, 0.0f}};
+    auto event = std::make_unique<ParameterChangeBatchNotificationEvent>(changes, IMMEDIATE_PROCESS);
+    _module_under_test->process(event.get());
+}
+
 /*TEST_F(TestOSCFrontend, TestPropertyChangeNotification)
 {
     EXPECT_CALL(*_mock_osc_interface, send(StrEq("/parameter/proc/property_1"), testing::Matcher<float>(0.5f))).Times(1);
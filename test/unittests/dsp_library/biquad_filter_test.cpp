@@ -0,0 +1,150 @@
+#include <array>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "dsp_library/biquad_filter.cpp"
+
+using namespace sushi;
+using namespace sushi::dsp::biquad;
+
+constexpr float TEST_SAMPLE_RATE = 48000;
+constexpr int TEST_SAMPLES = 200;
+
+class MultichannelBiquadFilterTest : public ::testing::TestWithParam<int>
+{
+protected:
+    MultichannelBiquadFilterTest() = default;
+
+    void SetUp() override
+    {
+        std::mt19937 generator(4711);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        for (auto& channel : _input)
+        {
+            channel.resize(TEST_SAMPLES);
+            for (auto& sample : channel)
+            {
+                sample = distribution(generator);
+            }
+        }
+        for (auto& channel : _output)
+        {
+            channel.resize(TEST_SAMPLES);
+        }
+        for (auto& channel : _expected)
+        {
+            channel.resize(TEST_SAMPLES);
+        }
+        _module_under_test.set_smoothing(AUDIO_CHUNK_SIZE);
+        _module_under_test.reset();
+        for (auto& filter : _reference_filters)
+        {
+            filter.set_smoothing(AUDIO_CHUNK_SIZE);
+            filter.reset();
+        }
+    }
+
+    /* Process a range of samples with the filter under test and with one
+     * BiquadFilter per channel */
+    void process(int channels, int offset, int samples)
+    {
+        std::array<const float*, MAX_BIQUAD_CHANNELS> in;
+        std::array<float*, MAX_BIQUAD_CHANNELS> out;
+        for (int i = 0; i < channels; ++i)
+        {
+            in[i] = _input[i].data() + offset;
+            out[i] = _output[i].data() + offset;
+            _reference_filters[i].process(_input[i].data() + offset, _expected[i].data() + offset, samples);
+        }
+        _module_under_test.process(in.data(), out.data(), channels, samples);
+    }
+
+    void set_coefficients(const Coefficients& coefficients)
+    {
+        _module_under_test.set_coefficients(coefficients);
+        for (auto& filter : _reference_filters)
+        {
+            filter.set_coefficients(coefficients);
+        }
+    }
+
+    void compare(int channels)
+    {
+        for (int i = 0; i < channels; ++i)
+        {
+            for (int n = 0; n < TEST_SAMPLES; ++n)
+            {
+                ASSERT_NEAR(_expected[i][n], _output[i][n], 1.0e-4f) << "channel " << i << ", sample " << n;
+            }
+        }
+    }
+
+    MultichannelBiquadFilter _module_under_test;
+    std::array<BiquadFilter, MAX_BIQUAD_CHANNELS> _reference_filters;
+    std::array<std::vector<float>, MAX_BIQUAD_CHANNELS> _input;
+    std::array<std::vector<float>, MAX_BIQUAD_CHANNELS> _output;
+    std::array<std::vector<float>, MAX_BIQUAD_CHANNELS> _expected;
+};
+
+TEST_P(MultichannelBiquadFilterTest, TestSameOutputAsBiquadFilter)
+{
+    int channels = GetParam();
+    Coefficients coefficients;
+    calc_biquad_peak(coefficients, TEST_SAMPLE_RATE, 1000.0f, 2.0f, 4.0f);
+    set_coefficients(coefficients);
+
+    // Process in uneven parts and change the coefficients in between
+    process(channels, 0, 37);
+    process(channels, 37, 64);
+    calc_biquad_peak(coefficients, TEST_SAMPLE_RATE, 200.0f, 0.5f, 0.25f);
+    set_coefficients(coefficients);
+    process(channels, 101, TEST_SAMPLES - 101);
+
+    compare(channels);
+}
+
+TEST_P(MultichannelBiquadFilterTest, TestInPlaceProcessing)
+{
+    int channels = GetParam();
+    Coefficients coefficients;
+    calc_biquad_peak(coefficients, TEST_SAMPLE_RATE, 2000.0f, 0.7f, 0.5f);
+    set_coefficients(coefficients);
+
+    _output = _input;
+    std::array<float*, MAX_BIQUAD_CHANNELS> buffers;
+    for (int i = 0; i < channels; ++i)
+    {
+        buffers[i] = _output[i].data();
+        _reference_filters[i].process(_input[i].data(), _expected[i].data(), TEST_SAMPLES);
+    }
+    _module_under_test.process(buffers.data(), buffers.data(), channels, TEST_SAMPLES);
+
+    compare(channels);
+}
+
+INSTANTIATE_TEST_SUITE_P(ChannelCounts, MultichannelBiquadFilterTest, ::testing::Values(1, 2, 3, 5, 8, 11, MAX_BIQUAD_CHANNELS));
+
+TEST(MultichannelBiquadFilterResetTest, TestReset)
+{
+    MultichannelBiquadFilter module_under_test;
+    module_under_test.set_smoothing(AUDIO_CHUNK_SIZE);
+    module_under_test.reset();
+    Coefficients coefficients;
+    calc_biquad_peak(coefficients, TEST_SAMPLE_RATE, 1000.0f, 0.7f, 2.0f);
+    module_under_test.set_coefficients(coefficients);
+
+    std::vector<float> buffer(AUDIO_CHUNK_SIZE, 1.0f);
+    std::array<float*, 1> channel = {buffer.data()};
+    module_under_test.process(channel.data(), channel.data(), 1, AUDIO_CHUNK_SIZE);
+    EXPECT_NE(0.0f, buffer.back());
+
+    module_under_test.reset();
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    module_under_test.process(channel.data(), channel.data(), 1, AUDIO_CHUNK_SIZE);
+    for (auto sample : buffer)
+    {
+        EXPECT_FLOAT_EQ(0.0f, sample);
+    }
+}
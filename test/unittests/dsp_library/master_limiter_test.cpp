@@ -1,4 +1,5 @@
 #include <array>
+#include <chrono>
 
 #include "gtest/gtest.h"
 
@@ -29,6 +30,98 @@ TEST_F(TestUpSampler, UpSampling)
     }
 }
 
+TEST_F(TestUpSampler, TruePeak)
+{
+    std::array<float, UPSAMPLING_TEST_DATA_SIZE> peaks;
+    _module_under_test.process_true_peak(UPSAMPLING_TEST_DATA, peaks.data());
+    for (int i = 0; i < UPSAMPLING_TEST_DATA_SIZE; i++)
+    {
+        float expected = std::abs(UPSAMPLING_TEST_DATA[i]);
+        for (int j = 0; j < UPSAMPLING_FACTOR; j++)
+        {
+            expected = std::max(expected, std::abs(UPSAMPLING_TEST_DATA4X[UPSAMPLING_FACTOR * i + j]));
+        }
+        EXPECT_NEAR(expected, peaks[i], 1e-6);
+    }
+}
+
+TEST_F(TestUpSampler, ContinuityBetweenChunks)
+{
+    // Interpolating in 2 halves must give the same result as all at once
+    constexpr int HALF_SIZE = UPSAMPLING_TEST_DATA_SIZE / 2;
+    UpSampler<HALF_SIZE> half_size_upsampler;
+    half_size_upsampler.reset();
+    std::array<float, UPSAMPLING_TEST_DATA4X_SIZE> out;
+    half_size_upsampler.process(UPSAMPLING_TEST_DATA, out.data());
+    half_size_upsampler.process(UPSAMPLING_TEST_DATA + HALF_SIZE, out.data() + UPSAMPLING_FACTOR * HALF_SIZE);
+    for (size_t i = 0; i < UPSAMPLING_TEST_DATA4X_SIZE; i++)
+    {
+        EXPECT_FLOAT_EQ(UPSAMPLING_TEST_DATA4X[i], out[i]);
+    }
+}
+
+TEST_F(TestUpSampler, TruePeakTiming)
+{
+    // 16 output channels in chunks of 64 samples, like a large engine setup
+    constexpr int CHUNK_SIZE = 64;
+    constexpr int CHANNELS = 16;
+    constexpr int ITERATIONS = 500;
+    constexpr int CHUNKS = LIMITER_INPUT_DATA_SIZE / CHUNK_SIZE;
+
+    std::array<UpSampler<CHUNK_SIZE>, CHANNELS> scalar_upsamplers;
+    std::array<UpSampler<CHUNK_SIZE>, CHANNELS> upsamplers;
+    std::array<float, UPSAMPLING_FACTOR * CHUNK_SIZE> upsampled;
+    std::array<float, CHUNK_SIZE> peaks;
+    // Keep the highest peak so that the results are used and can be compared
+    float scalar_max_peak = 0.0f;
+    float max_peak = 0.0f;
+
+    // Interpolating the whole signal and taking the peaks after, as the limiter used to
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS * CHUNKS; i++)
+    {
+        const float* input = LIMITER_INPUT_DATA + (i % CHUNKS) * CHUNK_SIZE;
+        for (auto& upsampler : scalar_upsamplers)
+        {
+            upsampler.process(input, upsampled.data());
+            for (int sample_idx = 0; sample_idx < CHUNK_SIZE; sample_idx++)
+            {
+                float peak = std::abs(input[sample_idx]);
+                for (int j = 0; j < UPSAMPLING_FACTOR; j++)
+                {
+                    peak = std::max(peak, std::abs(upsampled[UPSAMPLING_FACTOR * sample_idx + j]));
+                }
+                scalar_max_peak = std::max(scalar_max_peak, peak);
+            }
+        }
+    }
+    auto scalar_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS * CHUNKS; i++)
+    {
+        const float* input = LIMITER_INPUT_DATA + (i % CHUNKS) * CHUNK_SIZE;
+        for (auto& upsampler : upsamplers)
+        {
+            upsampler.process_true_peak(input, peaks.data());
+            for (auto peak : peaks)
+            {
+                max_peak = std::max(max_peak, peak);
+            }
+        }
+    }
+    auto time = std::chrono::steady_clock::now() - start;
+
+    EXPECT_FLOAT_EQ(scalar_max_peak, max_peak);
+
+    auto per_chunk = [](auto duration)
+    {
+        return static_cast<int>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / (ITERATIONS * CHUNKS));
+    };
+    RecordProperty("scalar_ns_per_chunk", per_chunk(scalar_time));
+    RecordProperty("true_peak_ns_per_chunk", per_chunk(time));
+}
+
 constexpr float TEST_SAMPLERATE = 48000.0f;
 constexpr float TEST_RELEASE_TIME_MS = 100.0f;
 constexpr float TEST_ATTACK_TIME_MS = 50.0f;
@@ -53,4 +146,21 @@ TEST_F(TestMasterLimiter, Limit)
     {
         EXPECT_NEAR(1.0, out[i] / LIMITER_OUTPUT_DATA[i], 1e-6);
     }
-}
\ No newline at end of file
+}
+TEST_F(TestMasterLimiter, ChunkedInPlaceProcessing)
+{
+    // Same as the engine, in place and in chunks of 64 samples
+    constexpr int CHUNK_SIZE = 64;
+    MasterLimiter<CHUNK_SIZE> limiter{TEST_RELEASE_TIME_MS, TEST_ATTACK_TIME_MS};
+    limiter.init(TEST_SAMPLERATE);
+    std::array<float, LIMITER_INPUT_DATA_SIZE> buffer;
+    std::copy(LIMITER_INPUT_DATA, LIMITER_INPUT_DATA + LIMITER_INPUT_DATA_SIZE, buffer.begin());
+    for (int i = 0; i < LIMITER_INPUT_DATA_SIZE; i += CHUNK_SIZE)
+    {
+        limiter.process(buffer.data() + i, buffer.data() + i);
+    }
+    for (int i = 0; i < LIMITER_OUTPUT_DATA_SIZE; i++)
+    {
+        EXPECT_NEAR(1.0, buffer[i] / LIMITER_OUTPUT_DATA[i], 1e-6);
+    }
+}
@@ -0,0 +1,258 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "engine/async_work_executor.cpp"
+#include "test_utils/engine_mockup.h"
+
+using namespace sushi;
+using namespace sushi::internal;
+using namespace sushi::internal::engine;
+
+constexpr float TEST_SAMPLE_RATE = 44100.0;
+constexpr auto TIMEOUT = std::chrono::seconds(2);
+
+namespace sushi::internal::engine {
+
+class AsyncWorkExecutorAccessor
+{
+public:
+    explicit AsyncWorkExecutorAccessor(AsyncWorkExecutor& f) : _friend(f) {}
+
+    int queued_tasks()
+    {
+        std::scoped_lock lock(_friend._lock);
+        int count = 0;
+        for (const auto& [id, strand] : _friend._strands)
+        {
+            count += static_cast<int>(strand.tasks.size());
+        }
+        return count;
+    }
+
+private:
+    AsyncWorkExecutor& _friend;
+};
+
+}
+
+class CompletionEngineMockup : public EngineMockup
+{
+public:
+    CompletionEngineMockup() : EngineMockup(TEST_SAMPLE_RATE) {}
+
+    EngineReturnStatus send_timed_rt_event(const RtEvent& event, Time /*timestamp*/) override
+    {
+        std::scoped_lock lock(_lock);
+        _events.push_back(event);
+        return EngineReturnStatus::OK;
+    }
+
+    bool wait_for_events(size_t count)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < TIMEOUT)
+        {
+            {
+                std::scoped_lock lock(_lock);
+                if (_events.size() >= count)
+                {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    std::vector<RtEvent> events()
+    {
+        std::scoped_lock lock(_lock);
+        return _events;
+    }
+
+private:
+    std::mutex _lock;
+    std::vector<RtEvent> _events;
+};
+
+struct TaskLog
+{
+    std::mutex lock;
+    std::vector<int> order;
+    std::atomic<int> active{0};
+    std::atomic<int> max_active{0};
+    std::atomic<bool> blocked{false};
+    std::atomic<bool> blocking{false};
+};
+
+TaskLog task_log;
+
+int logging_callback(void* data, EventId /*id*/)
+{
+    int active = ++task_log.active;
+    int max_active = task_log.max_active;
+    while (active > max_active && !task_log.max_active.compare_exchange_weak(max_active, active)) {}
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    {
+        std::scoped_lock lock(task_log.lock);
+        task_log.order.push_back(static_cast<int>(reinterpret_cast<intptr_t>(data)));
+    }
+    task_log.active--;
+    return 5;
+}
+
+int blocking_callback(void* /*data*/, EventId /*id*/)
+{
+    task_log.blocking = true;
+    while (task_log.blocked)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return 0;
+}
+
+void* as_data(int value)
+{
+    return reinterpret_cast<void*>(static_cast<intptr_t>(value));
+}
+
+class TestAsyncWorkExecutor : public ::testing::Test
+{
+protected:
+    TestAsyncWorkExecutor() = default;
+
+    void SetUp() override
+    {
+        task_log.order.clear();
+        task_log.active = 0;
+        task_log.max_active = 0;
+        task_log.blocked = false;
+        task_log.blocking = false;
+    }
+
+    void TearDown() override
+    {
+        task_log.blocked = false;
+        _module_under_test->stop();
+    }
+
+    void create(int threads)
+    {
+        _module_under_test = std::make_unique<AsyncWorkExecutor>(&_engine, threads);
+        _accessor = std::make_unique<AsyncWorkExecutorAccessor>(*_module_under_test);
+        _module_under_test->run();
+    }
+
+    CompletionEngineMockup _engine;
+    std::unique_ptr<AsyncWorkExecutor> _module_under_test;
+    std::unique_ptr<AsyncWorkExecutorAccessor> _accessor;
+};
+
+TEST_F(TestAsyncWorkExecutor, TestCompletion)
+{
+    create(2);
+    auto event = RtEvent::make_async_work_event(logging_callback, 123, as_data(1));
+    auto event_id = event.async_work_event()->event_id();
+    ASSERT_TRUE(_module_under_test->push_rt(event));
+    _module_under_test->notify_rt();
+
+    ASSERT_TRUE(_engine.wait_for_events(1));
+    auto completion = _engine.events().front();
+    ASSERT_EQ(RtEventType::ASYNC_WORK_NOTIFICATION, completion.type());
+    EXPECT_EQ(123u, completion.processor_id());
+    EXPECT_EQ(event_id, completion.async_work_completion_event()->sending_event_id());
+    EXPECT_EQ(5, completion.async_work_completion_event()->return_status());
+}
+
+TEST_F(TestAsyncWorkExecutor, TestOrderWithinProcessor)
+{
+    constexpr int TASKS = 50;
+    create(4);
+    for (int i = 0; i < TASKS; ++i)
+    {
+        ASSERT_TRUE(_module_under_test->push_rt(RtEvent::make_async_work_event(logging_callback, 7, as_data(i))));
+    }
+    _module_under_test->notify_rt();
+
+    ASSERT_TRUE(_engine.wait_for_events(TASKS));
+    EXPECT_EQ(1, task_log.max_active);
+    ASSERT_EQ(TASKS, static_cast<int>(task_log.order.size()));
+    for (int i = 0; i < TASKS; ++i)
+    {
+        EXPECT_EQ(i, task_log.order[i]);
+    }
+}
+
+TEST_F(TestAsyncWorkExecutor, TestOverflowKeepsOrder)
+{
+    create(1);
+    // Without notify_rt() nothing is taken from the queue, so it will fill up
+    int tasks = 0;
+    while (_module_under_test->push_rt(RtEvent::make_async_work_event(logging_callback, 7, as_data(tasks))))
+    {
+        tasks++;
+    }
+    ASSERT_GT(tasks, MAX_PENDING_RT_WORK);
+
+    // Pending work is retried every time notify_rt() is called, as it would be every chunk
+    auto start = std::chrono::steady_clock::now();
+    while (static_cast<int>(_engine.events().size()) < tasks && std::chrono::steady_clock::now() - start < TIMEOUT)
+    {
+        _module_under_test->notify_rt();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(tasks, static_cast<int>(task_log.order.size()));
+    for (int i = 0; i < tasks; ++i)
+    {
+        ASSERT_EQ(i, task_log.order[i]);
+    }
+}
+
+TEST_F(TestAsyncWorkExecutor, TestParallelProcessors)
+{
+    constexpr int PROCESSORS = 4;
+    create(PROCESSORS);
+    for (int i = 0; i < PROCESSORS * 10; ++i)
+    {
+        auto processor = static_cast<ObjectId>(i % PROCESSORS);
+        ASSERT_TRUE(_module_under_test->push_rt(RtEvent::make_async_work_event(logging_callback, processor, as_data(i))));
+    }
+    _module_under_test->notify_rt();
+
+    ASSERT_TRUE(_engine.wait_for_events(PROCESSORS * 10));
+    EXPECT_LE(task_log.max_active, PROCESSORS);
+}
+
+TEST_F(TestAsyncWorkExecutor, TestPriority)
+{
+    create(1);
+    // Occupy the only thread so that the other tasks are queued up behind it
+    task_log.blocked = true;
+    _module_under_test->push_rt(RtEvent::make_async_work_event(blocking_callback, 1, nullptr));
+    _module_under_test->notify_rt();
+    auto start = std::chrono::steady_clock::now();
+    while (task_log.blocking == false && std::chrono::steady_clock::now() - start < TIMEOUT)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(task_log.blocking);
+
+    _module_under_test->push_rt(RtEvent::make_async_work_event(logging_callback, 2, as_data(2), AsyncWorkPriority::LOW));
+    _module_under_test->push_rt(RtEvent::make_async_work_event(logging_callback, 3, as_data(3), AsyncWorkPriority::NORMAL));
+    _module_under_test->push_rt(RtEvent::make_async_work_event(logging_callback, 4, as_data(4), AsyncWorkPriority::HIGH));
+    _module_under_test->notify_rt();
+
+    start = std::chrono::steady_clock::now();
+    while (_accessor->queued_tasks() < 3 && std::chrono::steady_clock::now() - start < TIMEOUT)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    task_log.blocked = false;
+
+    ASSERT_TRUE(_engine.wait_for_events(4));
+    ASSERT_EQ(3u, task_log.order.size());
+    EXPECT_EQ(4, task_log.order[0]);
+    EXPECT_EQ(3, task_log.order[1]);
+    EXPECT_EQ(2, task_log.order[2]);
+}
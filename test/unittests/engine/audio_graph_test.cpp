@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <thread>
 
 #include "gtest/gtest.h"
@@ -7,6 +8,8 @@
 #include "engine/audio_graph.cpp"
 #include "test_utils/host_control_mockup.h"
 #include "test_utils/audio_graph_accessor.h"
+#include "test_utils/dummy_processor.h"
+#include "test_utils/test_utils.h"
 
 constexpr float SAMPLE_RATE = 44000;
 constexpr int TEST_MAX_TRACKS = 2;
@@ -20,15 +23,67 @@ using namespace sushi::internal::engine;
 #endif
 
 
+class DummySendProcessor : public DummyProcessor
+{
+public:
+    explicit DummySendProcessor(HostControl host_control) : DummyProcessor(host_control) {}
+
+    Processor* audio_send_destination() const override
+    {
+        return _destination;
+    }
+
+    void set_destination(Processor* destination)
+    {
+        _destination = destination;
+        notify_audio_routing_changed();
+    }
+
+private:
+    Processor* _destination{nullptr};
+};
+
+class DummyReturnProcessor : public DummyProcessor
+{
+public:
+    explicit DummyReturnProcessor(HostControl host_control) : DummyProcessor(host_control) {}
+
+    void set_senders_processed_before(bool processed_before) override
+    {
+        senders_processed_before = processed_before;
+    }
+
+    bool senders_processed_before{false};
+};
+
+// Takes a fixed time to process, to simulate tracks with uneven cpu load
+class BusyProcessor : public DummyProcessor
+{
+public:
+    BusyProcessor(HostControl host_control, std::chrono::microseconds cost) : DummyProcessor(host_control),
+                                                                               _cost(cost) {}
+
+    void process_audio(const sushi::ChunkSampleBuffer& in_buffer, sushi::ChunkSampleBuffer& out_buffer) override
+    {
+        auto end = std::chrono::steady_clock::now() + _cost;
+        while (std::chrono::steady_clock::now() < end) {}
+        out_buffer = in_buffer;
+    }
+
+private:
+    std::chrono::microseconds _cost;
+};
+
 class TestAudioGraph : public ::testing::Test
 {
 protected:
     using ::testing::Test::SetUp; // Hide error of hidden overload of virtual function in clang when signatures differ but the name is the same
     TestAudioGraph() = default;
 
-    void SetUp(int cores)
+    void SetUp(int cores, SchedulingMode scheduling = SchedulingMode::ROUND_ROBIN)
     {
-        _module_under_test = std::make_unique<AudioGraph>(cores, TEST_MAX_TRACKS, SAMPLE_RATE, "");
+        _module_under_test = std::make_unique<AudioGraph>(cores, TEST_MAX_TRACKS, SAMPLE_RATE, "", false, scheduling,
+                                                          &_hc._audio_routing_generation);
         _accessor = std::make_unique<AudioGraphAccessor>(*_module_under_test);
     }
 
@@ -41,6 +96,7 @@ protected:
 
     Track _track_1 {_hc.make_host_control_mockup(SAMPLE_RATE), 2, &_timer};
     Track _track_2 {_hc.make_host_control_mockup(SAMPLE_RATE), 2, &_timer};
+    Track _track_3 {_hc.make_host_control_mockup(SAMPLE_RATE), 2, &_timer};
 };
 
 TEST_F(TestAudioGraph, TestSingleCoreOperation)
@@ -95,6 +151,269 @@ TEST_F(TestAudioGraph, TestMultiCoreOperation)
 }
 #endif
 
+TEST_F(TestAudioGraph, TestMixToOutputs)
+{
+    SetUp(1);
+    ASSERT_TRUE(_module_under_test->add(&_track_1));
+    ASSERT_TRUE(_module_under_test->add(&_track_2));
+    _module_under_test->set_output_channels(2);
+    _track_1.add_output_route(0, 0);
+    _track_2.add_output_route(0, 0);
+    _track_2.add_output_route(1, 1);
+
+    ChunkSampleBuffer output(2);
+    test_utils::fill_sample_buffer(output, 5.0f);
+    auto in_1 = _track_1.input_bus(0);
+    auto in_2 = _track_2.input_bus(0);
+    test_utils::fill_sample_buffer(in_1, 1.0f);
+    test_utils::fill_sample_buffer(in_2, 1.0f);
+    _module_under_test->render(&output);
+
+    auto left = ChunkSampleBuffer::create_non_owning_buffer(output, 0, 1);
+    auto right = ChunkSampleBuffer::create_non_owning_buffer(output, 1, 1);
+    test_utils::assert_buffer_value(2.0f, left, test_utils::DECIBEL_ERROR);
+    test_utils::assert_buffer_value(1.0f, right, test_utils::DECIBEL_ERROR);
+}
+
+#ifndef DISABLE_MULTICORE_UNIT_TESTS
+TEST_F(TestAudioGraph, TestMultiCoreMixToOutputs)
+{
+    SetUp(2);
+    ASSERT_TRUE(_module_under_test->add(&_track_1));
+    ASSERT_TRUE(_module_under_test->add(&_track_2));
+    _module_under_test->set_output_channels(2);
+    _track_1.add_output_route(0, 0);
+    _track_2.add_output_route(0, 0);
+    _track_2.add_output_route(1, 1);
+
+    // Every core makes a partial mix, these are summed to the output
+    ChunkSampleBuffer output(3);
+    for (int i = 0; i < 2; ++i)
+    {
+        test_utils::fill_sample_buffer(output, 5.0f);
+        auto in_1 = _track_1.input_bus(0);
+        auto in_2 = _track_2.input_bus(0);
+        test_utils::fill_sample_buffer(in_1, 1.0f);
+        test_utils::fill_sample_buffer(in_2, 1.0f);
+        _module_under_test->render(&output);
+
+        auto left = ChunkSampleBuffer::create_non_owning_buffer(output, 0, 1);
+        auto right = ChunkSampleBuffer::create_non_owning_buffer(output, 1, 1);
+        auto unused = ChunkSampleBuffer::create_non_owning_buffer(output, 2, 1);
+        test_utils::assert_buffer_value(2.0f, left, test_utils::DECIBEL_ERROR);
+        test_utils::assert_buffer_value(1.0f, right, test_utils::DECIBEL_ERROR);
+        test_utils::assert_buffer_value(0.0f, unused);
+    }
+}
+#endif
+
+TEST_F(TestAudioGraph, TestRunOnAllCores)
+{
+    for (int cores : {1, 3})
+    {
+#ifdef DISABLE_MULTICORE_UNIT_TESTS
+        if (cores > 1)
+        {
+            continue;
+        }
+#endif
+        SetUp(cores);
+        std::array<std::atomic<int>, 3> calls{};
+        _module_under_test->run_on_all_cores([](void* data, int core, int cores)
+        {
+            auto calls = reinterpret_cast<std::array<std::atomic<int>, 3>*>(data);
+            (*calls)[core] += cores;
+        }, &calls);
+
+        for (int core = 0; core < 3; ++core)
+        {
+            EXPECT_EQ(core < cores ? cores : 0, calls[core].load());
+        }
+        // Rendering must not be affected
+        ASSERT_TRUE(_module_under_test->add(&_track_1));
+        _module_under_test->render();
+    }
+}
+
+TEST_F(TestAudioGraph, TestSingleCoreIgnoresScheduling)
+{
+    SetUp(1, SchedulingMode::WORK_STEALING);
+    EXPECT_EQ(SchedulingMode::ROUND_ROBIN, _module_under_test->scheduling_mode());
+    ASSERT_TRUE(_module_under_test->add(&_track_1));
+    _module_under_test->render();
+    ASSERT_TRUE(_module_under_test->remove(&_track_1));
+}
+
+#ifndef DISABLE_MULTICORE_UNIT_TESTS
+TEST_F(TestAudioGraph, TestRebalancing)
+{
+    SetUp(2, SchedulingMode::LOAD_BALANCED);
+    ASSERT_TRUE(_module_under_test->add(&_track_1));
+    ASSERT_TRUE(_module_under_test->add(&_track_2));
+    ASSERT_TRUE(_module_under_test->add(&_track_3));
+
+    // Round robin assignment puts track 1 and 3 on core 0
+    auto& graph = _accessor->audio_graph();
+    ASSERT_EQ(2u, graph[0].size());
+    ASSERT_EQ(1u, graph[1].size());
+
+    // Make track 1 as expensive as the other 2 combined, it should end up alone on a core
+    _accessor->render_times()[0] = {200.0f, 100.0f};
+    _accessor->render_times()[1] = {100.0f};
+    _accessor->rebalance();
+
+    ASSERT_EQ(1u, graph[0].size());
+    ASSERT_EQ(2u, graph[1].size());
+    EXPECT_EQ(&_track_1, graph[0][0]);
+    EXPECT_EQ(200.0f, _accessor->render_times()[0][0]);
+
+    // Tracks with no measurements should be evenly distributed
+    _accessor->render_times()[0] = {0.0f};
+    _accessor->render_times()[1] = {0.0f, 0.0f};
+    _accessor->rebalance();
+    EXPECT_EQ(2u, graph[0].size());
+    EXPECT_EQ(1u, graph[1].size());
+
+    ASSERT_TRUE(_module_under_test->remove(&_track_2));
+    ASSERT_EQ(_accessor->audio_graph()[0].size(), _accessor->render_times()[0].size());
+    ASSERT_EQ(_accessor->audio_graph()[1].size(), _accessor->render_times()[1].size());
+}
+
+TEST_F(TestAudioGraph, TestWorkStealingOperation)
+{
+    SetUp(3, SchedulingMode::WORK_STEALING);
+    ASSERT_TRUE(_module_under_test->add(&_track_1));
+    ASSERT_TRUE(_module_under_test->add(&_track_2));
+
+    auto event = RtEvent::make_note_on_event(_track_1.id(), 0, 0, 48, 1.0f);
+    _track_1.process_event(event);
+    _track_2.process_event(event);
+    _module_under_test->render();
+
+    // All events should be passed through, regardless of which core rendered the tracks
+    int event_count = 0;
+    for (auto& queue : _module_under_test->event_outputs())
+    {
+        event_count += queue.size();
+    }
+    EXPECT_EQ(2, event_count);
+
+    // Render times should have been recorded for both tracks
+    for (int core = 0; core < 3; ++core)
+    {
+        for (auto time : _accessor->render_times()[core])
+        {
+            EXPECT_GT(time, 0.0f);
+        }
+    }
+}
+#endif
+
+TEST_F(TestAudioGraph, TestSendReturnOrdering)
+{
+    SetUp(1);
+    DummySendProcessor send_1(_hc.make_host_control_mockup(SAMPLE_RATE));
+    DummySendProcessor send_2(_hc.make_host_control_mockup(SAMPLE_RATE));
+    DummyReturnProcessor return_1(_hc.make_host_control_mockup(SAMPLE_RATE));
+    DummyReturnProcessor return_2(_hc.make_host_control_mockup(SAMPLE_RATE));
+    ASSERT_TRUE(_track_1.add(&return_1));
+    ASSERT_TRUE(_track_1.add(&send_1));
+    ASSERT_TRUE(_track_2.add(&send_2));
+    ASSERT_TRUE(_track_2.add(&return_2));
+
+    ASSERT_TRUE(_module_under_test->add(&_track_1));
+    ASSERT_TRUE(_module_under_test->add(&_track_2));
+    _module_under_test->render();
+    EXPECT_EQ(1, _module_under_test->levels());
+
+    // Track 2 sends to track 1, so it should be rendered first
+    send_2.set_destination(&return_1);
+    _module_under_test->render();
+    EXPECT_EQ(2, _module_under_test->levels());
+    EXPECT_EQ(&_track_2, _accessor->audio_graph()[0][0]);
+    EXPECT_EQ(&_track_1, _accessor->audio_graph()[0][1]);
+    EXPECT_TRUE(return_1.senders_processed_before);
+    EXPECT_FALSE(return_2.senders_processed_before);
+
+    // A feedback loop can not be ordered, both tracks end up on the same level
+    send_1.set_destination(&return_2);
+    _module_under_test->render();
+    EXPECT_EQ(1, _module_under_test->levels());
+    EXPECT_FALSE(return_1.senders_processed_before);
+    EXPECT_FALSE(return_2.senders_processed_before);
+
+    // Breaking the loop should restore the order
+    send_1.set_destination(nullptr);
+    _module_under_test->render();
+    EXPECT_EQ(2, _module_under_test->levels());
+    EXPECT_TRUE(return_1.senders_processed_before);
+
+    ASSERT_TRUE(_module_under_test->remove(&_track_1));
+    EXPECT_FALSE(return_1.senders_processed_before);
+    _module_under_test->render();
+    EXPECT_EQ(1, _module_under_test->levels());
+
+    ASSERT_TRUE(_module_under_test->remove(&_track_2));
+    _module_under_test->render();
+    EXPECT_EQ(0, _module_under_test->levels());
+}
+
+#ifndef DISABLE_MULTICORE_UNIT_TESTS
+TEST_F(TestAudioGraph, TestMultiCoreSendReturnOrdering)
+{
+    SetUp(2, SchedulingMode::LOAD_BALANCED);
+    DummySendProcessor send_1(_hc.make_host_control_mockup(SAMPLE_RATE));
+    DummySendProcessor send_2(_hc.make_host_control_mockup(SAMPLE_RATE));
+    DummyReturnProcessor return_processor(_hc.make_host_control_mockup(SAMPLE_RATE));
+    ASSERT_TRUE(_track_1.add(&return_processor));
+    ASSERT_TRUE(_track_2.add(&send_1));
+    ASSERT_TRUE(_track_3.add(&send_2));
+    send_1.set_destination(&return_processor);
+    send_2.set_destination(&return_processor);
+
+    ASSERT_TRUE(_module_under_test->add(&_track_1));
+    ASSERT_TRUE(_module_under_test->add(&_track_2));
+    ASSERT_TRUE(_module_under_test->add(&_track_3));
+    _module_under_test->render();
+    EXPECT_EQ(2, _module_under_test->levels());
+    EXPECT_TRUE(return_processor.senders_processed_before);
+
+    // The sending tracks should be spread over both cores and the receiving track rendered last
+    auto& graph = _accessor->audio_graph();
+    int receiving_core = graph[0].back() == &_track_1 ? 0 : 1;
+    EXPECT_EQ(&_track_1, graph[receiving_core].back());
+    EXPECT_EQ(2u, graph[receiving_core].size());
+    EXPECT_EQ(1u, graph[1 - receiving_core].size());
+}
+#endif
+
+TEST_F(TestAudioGraph, TestRoutingChangesAreLocalToEngine)
+{
+    SetUp(1);
+    // Processors created by another engine report routing changes to that engine only
+    HostControlMockup other_hc;
+    DummySendProcessor send(other_hc.make_host_control_mockup(SAMPLE_RATE));
+    DummyReturnProcessor return_processor(_hc.make_host_control_mockup(SAMPLE_RATE));
+    ASSERT_TRUE(_track_1.add(&return_processor));
+    ASSERT_TRUE(_track_2.add(&send));
+
+    ASSERT_TRUE(_module_under_test->add(&_track_1));
+    ASSERT_TRUE(_module_under_test->add(&_track_2));
+    _module_under_test->render();
+    EXPECT_EQ(1, _module_under_test->levels());
+
+    send.set_destination(&return_processor);
+    _module_under_test->render();
+    EXPECT_EQ(1, _module_under_test->levels());
+    EXPECT_FALSE(return_processor.senders_processed_before);
+
+    // A routing change in this engine updates the rendering order
+    _hc._audio_routing_generation++;
+    _module_under_test->render();
+    EXPECT_EQ(2, _module_under_test->levels());
+    EXPECT_TRUE(return_processor.senders_processed_before);
+}
+
 TEST_F(TestAudioGraph, TestMaxNumberOfTracks)
 {
     SetUp(1);
@@ -105,3 +424,95 @@ TEST_F(TestAudioGraph, TestMaxNumberOfTracks)
     ASSERT_EQ(1u, _accessor->audio_graph().size());
     ASSERT_EQ(2u, _accessor->audio_graph()[0].size());
 }
+
+#ifndef DISABLE_MULTICORE_UNIT_TESTS
+TEST_F(TestAudioGraph, TestSchedulingPeriodTimes)
+{
+    // 2 heavy and 6 light tracks, round robin puts both heavy tracks on the first core
+    constexpr int CORES = 4;
+    constexpr int TRACKS = 8;
+    constexpr int PERIODS = 200;
+    constexpr auto HEAVY_COST = std::chrono::microseconds(200);
+    constexpr auto LIGHT_COST = std::chrono::microseconds(20);
+
+    struct Result
+    {
+        std::chrono::microseconds p50_period;
+        std::chrono::microseconds max_period;
+        std::chrono::microseconds max_core_load;
+    };
+
+    auto run = [&](SchedulingMode scheduling)
+    {
+        AudioGraph graph(CORES, TRACKS, SAMPLE_RATE, "", false, scheduling);
+        AudioGraphAccessor accessor(graph);
+        std::vector<std::unique_ptr<Track>> tracks;
+        std::vector<std::unique_ptr<BusyProcessor>> processors;
+        for (int i = 0; i < TRACKS; ++i)
+        {
+            auto cost = i % 4 == 0 ? HEAVY_COST : LIGHT_COST;
+            processors.push_back(std::make_unique<BusyProcessor>(_hc.make_host_control_mockup(SAMPLE_RATE), cost));
+            tracks.push_back(std::make_unique<Track>(_hc.make_host_control_mockup(SAMPLE_RATE), 2, &_timer));
+            EXPECT_TRUE(tracks.back()->add(processors.back().get()));
+            EXPECT_TRUE(graph.add(tracks.back().get()));
+        }
+
+        // The first periods are used for measuring and redistributing the tracks
+        std::vector<std::chrono::microseconds> period_times;
+        for (int i = 0; i < PERIODS; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            graph.render();
+            auto period_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            if (i >= PERIODS / 2)
+            {
+                period_times.push_back(period_time);
+            }
+        }
+        std::sort(period_times.begin(), period_times.end());
+
+        /* The period time if all cores run in parallel, from the cost of the tracks on every
+         * core, as measured render times also depend on how many cpus the test runs on */
+        std::chrono::microseconds max_core_load(0);
+        for (const auto& core_tracks : accessor.audio_graph())
+        {
+            std::chrono::microseconds core_load(0);
+            for (auto track : core_tracks)
+            {
+                auto index = std::find_if(tracks.begin(), tracks.end(), [&](const auto& t) {return t.get() == track;}) - tracks.begin();
+                core_load += index % 4 == 0 ? HEAVY_COST : LIGHT_COST;
+            }
+            max_core_load = std::max(max_core_load, core_load);
+        }
+
+        for (auto& track : tracks)
+        {
+            graph.remove(track.get());
+        }
+        return Result{period_times[period_times.size() / 2], period_times.back(), max_core_load};
+    };
+
+    auto round_robin = run(SchedulingMode::ROUND_ROBIN);
+    auto load_balanced = run(SchedulingMode::LOAD_BALANCED);
+    auto work_stealing = run(SchedulingMode::WORK_STEALING);
+    RecordProperty("round_robin_p50_us", static_cast<int>(round_robin.p50_period.count()));
+    RecordProperty("round_robin_max_us", static_cast<int>(round_robin.max_period.count()));
+    RecordProperty("round_robin_max_core_load_us", static_cast<int>(round_robin.max_core_load.count()));
+    RecordProperty("load_balanced_p50_us", static_cast<int>(load_balanced.p50_period.count()));
+    RecordProperty("load_balanced_max_us", static_cast<int>(load_balanced.max_period.count()));
+    RecordProperty("load_balanced_max_core_load_us", static_cast<int>(load_balanced.max_core_load.count()));
+    RecordProperty("work_stealing_p50_us", static_cast<int>(work_stealing.p50_period.count()));
+    RecordProperty("work_stealing_max_us", static_cast<int>(work_stealing.max_period.count()));
+
+    // Both heavy tracks on one core versus one heavy track per core
+    EXPECT_EQ(2 * HEAVY_COST, round_robin.max_core_load);
+    EXPECT_LT(load_balanced.max_core_load, round_robin.max_core_load);
+
+    // Measured period times are only comparable if the cores actually run in parallel
+    if (std::thread::hardware_concurrency() >= CORES)
+    {
+        EXPECT_LT(load_balanced.p50_period, round_robin.p50_period);
+        EXPECT_LT(work_stealing.p50_period, round_robin.p50_period);
+    }
+}
+#endif
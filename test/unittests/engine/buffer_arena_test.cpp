@@ -0,0 +1,79 @@
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "engine/buffer_arena.cpp"
+
+using namespace sushi;
+using namespace sushi::internal;
+using namespace sushi::internal::engine;
+
+constexpr int TEST_BLOCK_CHANNELS = 8;
+
+bool is_aligned(const float* data)
+{
+    return reinterpret_cast<std::uintptr_t>(data) % SAMPLE_BUFFER_ALIGNMENT == 0;
+}
+
+class TestBufferArena : public ::testing::Test
+{
+protected:
+    TestBufferArena() = default;
+
+    BufferArena _module_under_test{TEST_BLOCK_CHANNELS};
+};
+
+TEST_F(TestBufferArena, TestAllocation)
+{
+    auto buffer_1 = _module_under_test.allocate(2);
+    auto buffer_2 = _module_under_test.allocate(3);
+    ASSERT_EQ(2, buffer_1.channel_count());
+    ASSERT_EQ(3, buffer_2.channel_count());
+    EXPECT_TRUE(is_aligned(buffer_1.channel(0)));
+    EXPECT_TRUE(is_aligned(buffer_2.channel(0)));
+
+    // Regions should be handed out contiguously from the same block
+    EXPECT_EQ(buffer_1.channel(0) + 2 * AUDIO_CHUNK_SIZE, buffer_2.channel(0));
+    EXPECT_EQ(TEST_BLOCK_CHANNELS * AUDIO_CHUNK_SIZE, static_cast<int>(_module_under_test.reserved_size()));
+
+    for (int c = 0; c < buffer_2.channel_count(); ++c)
+    {
+        for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+        {
+            ASSERT_FLOAT_EQ(0.0f, buffer_2.channel(c)[i]);
+        }
+    }
+
+    auto empty = _module_under_test.allocate(0);
+    EXPECT_EQ(0, empty.channel_count());
+}
+
+TEST_F(TestBufferArena, TestBlockOverflow)
+{
+    auto buffer_1 = _module_under_test.allocate(TEST_BLOCK_CHANNELS - 1);
+    auto buffer_2 = _module_under_test.allocate(2);
+    EXPECT_TRUE(is_aligned(buffer_2.channel(0)));
+    EXPECT_EQ(2 * TEST_BLOCK_CHANNELS * AUDIO_CHUNK_SIZE, static_cast<int>(_module_under_test.reserved_size()));
+
+    // Larger than a block, should get a block of its own
+    auto buffer_3 = _module_under_test.allocate(TEST_BLOCK_CHANNELS * 2);
+    EXPECT_EQ(16, buffer_3.channel_count());
+    EXPECT_TRUE(is_aligned(buffer_3.channel(0)));
+    EXPECT_EQ(4 * TEST_BLOCK_CHANNELS * AUDIO_CHUNK_SIZE, static_cast<int>(_module_under_test.reserved_size()));
+}
+
+TEST_F(TestBufferArena, TestReleaseAndReuse)
+{
+    auto buffer_1 = _module_under_test.allocate(2);
+    buffer_1.channel(1)[3] = 1.0f;
+    const float* region = buffer_1.channel(0);
+    _module_under_test.release(buffer_1);
+
+    // A request with a different channel count should not reuse the region
+    auto buffer_2 = _module_under_test.allocate(1);
+    EXPECT_NE(region, buffer_2.channel(0));
+
+    auto buffer_3 = _module_under_test.allocate(2);
+    EXPECT_EQ(region, buffer_3.channel(0));
+    EXPECT_FLOAT_EQ(0.0f, buffer_3.channel(1)[3]);
+}
@@ -4,7 +4,6 @@
 #include "engine/json_configurator.h"
 #include "engine/controller/controller.cpp"
 #include "test_utils/test_utils.h"
-#include "test_utils/audio_frontend_mockup.h"
 
 #include "sushi/utils.h"
 
@@ -39,7 +38,7 @@ protected:
         ASSERT_EQ(jsonconfig::JsonConfigReturnStatus::OK, _configurator.load_host_config());
         ASSERT_EQ(jsonconfig::JsonConfigReturnStatus::OK, _configurator.load_tracks());
 
-        _module_under_test = std::make_unique<Controller>(&_engine, &_midi_dispatcher, &_audio_frontend);
+        _module_under_test = std::make_unique<Controller>(&_engine, &_midi_dispatcher);
         ChunkSampleBuffer buffer(8);
         ControlBuffer ctrl_buffer;
         // Run once so that pending changes are executed
@@ -51,7 +50,6 @@ protected:
     std::string _json_data{ sushi::read_file(_path).value()};
     AudioEngine _engine{TEST_SAMPLE_RATE};
     midi_dispatcher::MidiDispatcher _midi_dispatcher{_engine.event_dispatcher()};
-    AudioFrontendMockup  _audio_frontend;
     jsonconfig::JsonConfigurator _configurator{&_engine,
                                                &_midi_dispatcher,
                                                _engine.processor_container(),
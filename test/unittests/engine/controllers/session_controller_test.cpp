@@ -7,7 +7,6 @@
 #include "engine/audio_engine.h"
 #include "control_frontends/base_control_frontend.h"
 #include "test_utils/engine_mockup.h"
-#include "test_utils/audio_frontend_mockup.h"
 #include "plugins/equalizer_plugin.h"
 #include "control_frontends/osc_frontend.h"
 #include "test_utils/mock_osc_interface.h"
@@ -75,7 +74,7 @@ protected:
         _osc_frontend = std::make_unique<OSCFrontend>(_audio_engine.get(), &_mock_controller, _mock_osc_interface);
         _event_dispatcher_mockup = static_cast<EventDispatcherMockup*>(_audio_engine->event_dispatcher());
         _midi_dispatcher = std::make_unique<MidiDispatcher>(_event_dispatcher_mockup);
-        _module_under_test = std::make_unique<SessionController>(_audio_engine.get(), _midi_dispatcher.get(), &_audio_frontend);
+        _module_under_test = std::make_unique<SessionController>(_audio_engine.get(), _midi_dispatcher.get());
         _module_under_test->set_osc_frontend(_osc_frontend.get());
 
         _accessor = std::make_unique<sushi::internal::engine::controller_impl::Accessor>(*_module_under_test);
@@ -87,7 +86,6 @@ protected:
     sushi::control::ControlMockup         _mock_controller;
     EventDispatcherMockup*                _event_dispatcher_mockup;
 
-    AudioFrontendMockup                   _audio_frontend;
     std::unique_ptr<AudioEngine>          _audio_engine;
     std::unique_ptr<MidiDispatcher>       _midi_dispatcher;
     std::unique_ptr<SessionController>    _module_under_test;
@@ -384,4 +382,60 @@ TEST_F(SessionControllerTest, TestSaveAndRestore)
     ASSERT_EQ(1u, pc_routes.size());
     EXPECT_EQ(MIDI_PORT, pc_routes.front().port);
     EXPECT_EQ(MIDI_CH, pc_routes.front().channel);
-}
\ No newline at end of file
+}
+TEST_F(SessionControllerTest, TestRestoreWhileRunning)
+{
+    const std::vector<std::string> PROCESSOR_NAMES = {"processor_1", "processor_2"};
+
+    auto [track_status, track_id] = _audio_engine->create_track("track_1", 2);
+    ASSERT_EQ(EngineReturnStatus::OK, track_status);
+    for (const auto& name : PROCESSOR_NAMES)
+    {
+        auto [status, proc_id] = _audio_engine->create_processor({.uid = std::string(equalizer_plugin::EqualizerPlugin::static_uid()),
+                                                                         .path = "",
+                                                                         .type = PluginType::INTERNAL},
+                                                                 name);
+        ASSERT_EQ(EngineReturnStatus::OK, status);
+        ASSERT_EQ(EngineReturnStatus::OK, _audio_engine->add_plugin_to_track(proc_id, track_id));
+    }
+    auto session_state = _module_under_test->save_session();
+    _accessor->clear_all_tracks();
+
+    // Restore with the engine running and record after every period which processors are processed
+    _audio_engine->enable_realtime(true);
+    std::atomic<bool> running = true;
+    std::atomic<bool> partially_restored = false;
+    auto processors = _audio_engine->processor_container();
+    auto rt_thread = std::thread([&]()
+    {
+        ChunkSampleBuffer buffer(8);
+        ControlBuffer control_buffer;
+        while (running)
+        {
+            _audio_engine->process_chunk(&buffer, &buffer, &control_buffer, &control_buffer, Time(0), 0);
+            int active = 0;
+            for (const auto& name : PROCESSOR_NAMES)
+            {
+                auto processor = processors->processor(name);
+                active += processor && processor->active_rt_processing() ? 1 : 0;
+            }
+            partially_restored = partially_restored || (active != 0 && active != static_cast<int>(PROCESSOR_NAMES.size()));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    ASSERT_EQ(control::ControlStatus::OK, _module_under_test->restore_session(session_state));
+    _event_dispatcher_mockup->execute_engine_event(_audio_engine.get());
+    running = false;
+    rt_thread.join();
+
+    // Both processors should have started processing in the same period
+    EXPECT_FALSE(partially_restored);
+    for (const auto& name : PROCESSOR_NAMES)
+    {
+        auto processor = processors->processor(name);
+        ASSERT_TRUE(processor);
+        EXPECT_TRUE(processor->active_rt_processing());
+    }
+    _audio_engine->enable_realtime(false);
+}
@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+
+#include "engine/deferred_reclaimer.cpp"
+
+using namespace sushi;
+using namespace sushi::internal;
+using namespace sushi::internal::engine;
+
+class DeletionCounter : public RtDeletable
+{
+public:
+    explicit DeletionCounter(int& counter) : _counter(counter) {}
+
+    ~DeletionCounter() override
+    {
+        _counter++;
+    }
+
+private:
+    int& _counter;
+};
+
+class TestDeferredReclaimer : public ::testing::Test
+{
+protected:
+    TestDeferredReclaimer() = default;
+
+    DeferredReclaimer _module_under_test;
+};
+
+TEST_F(TestDeferredReclaimer, TestDeletionAfterEpoch)
+{
+    int deleted = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        _module_under_test.retire(new DeletionCounter(deleted));
+    }
+
+    // The period the objects were retired in has not finished yet
+    _module_under_test.collect();
+    EXPECT_EQ(0, deleted);
+    _module_under_test.collect();
+    EXPECT_EQ(0, deleted);
+
+    _module_under_test.advance_epoch();
+    _module_under_test.collect();
+    EXPECT_EQ(10, deleted);
+}
+
+TEST_F(TestDeferredReclaimer, TestRetireDuringCollection)
+{
+    int deleted = 0;
+    _module_under_test.retire(new DeletionCounter(deleted));
+    _module_under_test.collect();
+
+    _module_under_test.advance_epoch();
+    _module_under_test.retire(new DeletionCounter(deleted));
+    _module_under_test.collect();
+    // Only the object from the finished period should be deleted
+    EXPECT_EQ(1, deleted);
+
+    _module_under_test.advance_epoch();
+    _module_under_test.collect();
+    EXPECT_EQ(2, deleted);
+}
+
+TEST_F(TestDeferredReclaimer, TestBlobs)
+{
+    for (int i = 0; i < MAX_RETIRED_BLOBS; ++i)
+    {
+        EXPECT_TRUE(_module_under_test.retire(BlobData{4, new uint8_t[4]}));
+    }
+    auto extra_blob = BlobData{4, new uint8_t[4]};
+    EXPECT_FALSE(_module_under_test.retire(extra_blob));
+
+    // Once the blobs are collected their slots are available again
+    _module_under_test.collect();
+    EXPECT_TRUE(_module_under_test.retire(extra_blob));
+    _module_under_test.advance_epoch();
+    _module_under_test.collect();
+    _module_under_test.flush();
+}
+
+TEST_F(TestDeferredReclaimer, TestFlush)
+{
+    int deleted = 0;
+    _module_under_test.retire(new DeletionCounter(deleted));
+    _module_under_test.collect();
+    _module_under_test.retire(new DeletionCounter(deleted));
+    _module_under_test.flush();
+    EXPECT_EQ(2, deleted);
+}
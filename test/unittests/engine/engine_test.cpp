@@ -33,11 +33,21 @@ public:
         return _friend._processors;
     }
 
-    [[nodiscard]] std::vector<Processor*>& realtime_processors()
+    [[nodiscard]] RtProcessorTable& realtime_processors()
     {
         return _friend._realtime_processors;
     }
 
+    [[nodiscard]] size_t input_aliases() const
+    {
+        return _friend._input_aliases.size();
+    }
+
+    [[nodiscard]] size_t input_copies() const
+    {
+        return _friend._input_copies.size();
+    }
+
     void remove_connections_from_track(ObjectId track_id)
     {
         _friend._remove_connections_from_track(track_id);
@@ -182,6 +192,55 @@ TEST_F(TestEngine, TestProcess)
     test_utils::assert_buffer_value(1.0f, main_bus, test_utils::DECIBEL_ERROR);
 }
 
+TEST_F(TestEngine, TestInputRouting)
+{
+    auto [status_1, track_1_id] = _module_under_test->create_track("1", 2);
+    auto [status_2, track_2_id] = _module_under_test->create_track("2", 2);
+    ASSERT_EQ(EngineReturnStatus::OK, status_1);
+    ASSERT_EQ(EngineReturnStatus::OK, status_2);
+
+    // Track 1 is connected 1:1 to inputs 2 and 3 and can read them directly
+    _module_under_test->connect_audio_input_bus(1, 0, track_1_id);
+    _module_under_test->connect_audio_output_bus(0, 0, track_1_id);
+
+    // Track 2 has its inputs swapped, so they need to be copied
+    _module_under_test->connect_audio_input_channel(0, 1, track_2_id);
+    _module_under_test->connect_audio_input_channel(1, 0, track_2_id);
+    _module_under_test->connect_audio_output_bus(1, 0, track_2_id);
+
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(TEST_CHANNEL_COUNT);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(TEST_CHANNEL_COUNT);
+    ControlBuffer control_buffer;
+    for (int c = 0; c < TEST_CHANNEL_COUNT; ++c)
+    {
+        auto channel = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(in_buffer, c, 1);
+        test_utils::fill_sample_buffer(channel, static_cast<float>(c + 1) * 0.1f);
+    }
+
+    _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+    EXPECT_EQ(1u, _accessor->input_aliases());
+    EXPECT_EQ(2u, _accessor->input_copies());
+
+    for (int c = 0; c < TEST_CHANNEL_COUNT; ++c)
+    {
+        // Output 0 and 1 are inputs 2 and 3, output 2 and 3 are inputs 1 and 0
+        float expected[] = {0.3f, 0.4f, 0.2f, 0.1f};
+        auto channel = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, c, 1);
+        test_utils::assert_buffer_value(expected[c], channel, test_utils::DECIBEL_ERROR);
+    }
+
+    // Disconnecting one channel means track 1 can no longer read directly from the inputs
+    _module_under_test->disconnect_audio_input_channel(3, 1, track_1_id);
+    _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+    EXPECT_EQ(0u, _accessor->input_aliases());
+    EXPECT_EQ(3u, _accessor->input_copies());
+
+    auto left = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 0, 1);
+    auto right = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 1, 1);
+    test_utils::assert_buffer_value(0.3f, left, test_utils::DECIBEL_ERROR);
+    test_utils::assert_buffer_value(0.0f, right, test_utils::DECIBEL_ERROR);
+}
+
 TEST_F(TestEngine, TestOutputMixing)
 {
     auto [status_1, track_1_id] = _module_under_test->create_track("1", 2);
@@ -207,6 +266,34 @@ TEST_F(TestEngine, TestOutputMixing)
     test_utils::assert_buffer_value(2.0f, main_bus, test_utils::DECIBEL_ERROR);
 }
 
+/*
+ * Test processing with the same buffer as input and output, as the offline frontend does
+ */
+TEST_F(TestEngine, TestInPlaceProcessing)
+{
+    auto [status_1, track_1_id] = _module_under_test->create_track("1", 2);
+    auto [status_2, track_2_id] = _module_under_test->create_track("2", 2);
+    ASSERT_EQ(EngineReturnStatus::OK, status_1);
+    ASSERT_EQ(EngineReturnStatus::OK, status_2);
+    _module_under_test->connect_audio_input_bus(0, 0, track_1_id);
+    _module_under_test->connect_audio_input_bus(1, 0, track_2_id);
+    _module_under_test->connect_audio_output_bus(1, 0, track_1_id);
+    _module_under_test->connect_audio_output_bus(0, 0, track_2_id);
+
+    SampleBuffer<AUDIO_CHUNK_SIZE> buffer(TEST_CHANNEL_COUNT);
+    ControlBuffer control_buffer;
+    auto bus_0 = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(buffer, 0, 2);
+    auto bus_1 = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(buffer, 2, 2);
+    test_utils::fill_sample_buffer(bus_0, 1.0f);
+    test_utils::fill_sample_buffer(bus_1, 2.0f);
+
+    _module_under_test->process_chunk(&buffer, &buffer, &control_buffer, &control_buffer, Time(0), 0);
+
+    /* The tracks swap the buses, so both inputs must be read before any output is written */
+    test_utils::assert_buffer_value(2.0f, bus_0, test_utils::DECIBEL_ERROR);
+    test_utils::assert_buffer_value(1.0f, bus_1, test_utils::DECIBEL_ERROR);
+}
+
 TEST_F(TestEngine, TestCreateEmptyTrack)
 {
     auto [status, track_id] = _module_under_test->create_track("left", 2);
@@ -463,8 +550,129 @@ TEST_F(TestEngine, TestRealtimeConfiguration)
     ASSERT_FALSE(_processors->processor_exists("gain_0_r"));
     ASSERT_FALSE(_processors->processor_exists(plugin_id));
     ASSERT_FALSE(_processors->processor_exists(track_id));
-    ASSERT_FALSE(_accessor->realtime_processors()[track_id]);
-    ASSERT_FALSE(_accessor->realtime_processors()[plugin_id]);
+    ASSERT_FALSE(_accessor->realtime_processors().find(track_id));
+    ASSERT_FALSE(_accessor->realtime_processors().find(plugin_id));
+}
+
+TEST_F(TestEngine, TestGraphTransaction)
+{
+    auto faux_rt_thread = [](AudioEngine* e)
+    {
+        SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(2);
+        SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(2);
+        ControlBuffer control_buffer;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        e->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+    };
+
+    PluginInfo gain_plugin_info;
+    gain_plugin_info.uid = "sushi.testing.gain";
+    gain_plugin_info.path = "";
+    gain_plugin_info.type = PluginType::INTERNAL;
+
+    // Build a track with 2 plugins while the engine is running, without the audio thread processing
+    _module_under_test->enable_realtime(true);
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->begin_graph_transaction());
+    EXPECT_EQ(EngineReturnStatus::ERROR, _module_under_test->begin_graph_transaction());
+
+    auto [track_status, track_id] = _module_under_test->create_track("main", 2);
+    ASSERT_EQ(EngineReturnStatus::OK, track_status);
+    auto [load_status, plugin_id] = _module_under_test->create_processor(gain_plugin_info, "gain_0");
+    ASSERT_EQ(EngineReturnStatus::OK, load_status);
+    auto [load_status_2, plugin_id_2] = _module_under_test->create_processor(gain_plugin_info, "gain_1");
+    ASSERT_EQ(EngineReturnStatus::OK, load_status_2);
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->add_plugin_to_track(plugin_id, track_id));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->add_plugin_to_track(plugin_id_2, track_id));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->connect_audio_input_channel(0, 0, track_id));
+
+    // Nothing should have been applied to the realtime part yet
+    EXPECT_FALSE(_accessor->realtime_processors().find(track_id));
+    EXPECT_FALSE(_accessor->realtime_processors().find(plugin_id));
+
+    // All changes should be applied in a single audio period
+    auto rt = std::thread(faux_rt_thread, _module_under_test.get());
+    auto status = _module_under_test->commit_graph_transaction();
+    rt.join();
+    ASSERT_EQ(EngineReturnStatus::OK, status);
+    EXPECT_EQ(EngineReturnStatus::ERROR, _module_under_test->commit_graph_transaction());
+
+    AudioGraph& audio_graph = _accessor->audio_graph();
+    AudioGraphAccessor _ag_accessor {audio_graph};
+    TrackAccessor _track_accessor_0 {*(_ag_accessor.audio_graph()[0][0])};
+    ASSERT_EQ(2u, _track_accessor_0.processors().size());
+    EXPECT_TRUE(_accessor->realtime_processors().find(track_id));
+    EXPECT_TRUE(_accessor->realtime_processors().find(plugin_id));
+    EXPECT_TRUE(_accessor->realtime_processors().find(plugin_id_2));
+
+    // Tear everything down in a second transaction
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->begin_graph_transaction());
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->remove_plugin_from_track(plugin_id, track_id));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->remove_plugin_from_track(plugin_id_2, track_id));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->delete_plugin(plugin_id));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->delete_plugin(plugin_id_2));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->delete_track(track_id));
+    EXPECT_FALSE(_processors->processor_exists(track_id));
+    EXPECT_TRUE(_accessor->realtime_processors().find(track_id));
+
+    rt = std::thread(faux_rt_thread, _module_under_test.get());
+    status = _module_under_test->commit_graph_transaction();
+    rt.join();
+    ASSERT_EQ(EngineReturnStatus::OK, status);
+
+    EXPECT_EQ(0u, _module_under_test->audio_input_connections().size());
+    EXPECT_FALSE(_accessor->realtime_processors().find(track_id));
+    EXPECT_FALSE(_accessor->realtime_processors().find(plugin_id));
+    EXPECT_FALSE(_accessor->realtime_processors().find(plugin_id_2));
+}
+
+TEST_F(TestEngine, TestGraphChangeLatency)
+{
+    constexpr int ITERATIONS = 100;
+    constexpr auto PERIOD = std::chrono::microseconds(1000);
+    PluginInfo gain_plugin_info {.uid = "sushi.testing.gain", .path = "", .type = PluginType::INTERNAL};
+
+    auto [track_status, track_id] = _module_under_test->create_track("main", 2);
+    ASSERT_EQ(EngineReturnStatus::OK, track_status);
+    _module_under_test->enable_realtime(true);
+
+    std::atomic<bool> running = true;
+    auto rt_thread = std::thread([&]()
+    {
+        SampleBuffer<AUDIO_CHUNK_SIZE> buffer(2);
+        ControlBuffer control_buffer;
+        while (running)
+        {
+            _module_under_test->process_chunk(&buffer, &buffer, &control_buffer, &control_buffer, Time(0), 0);
+            std::this_thread::sleep_for(PERIOD);
+        }
+    });
+
+    // Time to create a processor and add it to a track while the audio thread runs
+    std::vector<std::chrono::microseconds> latencies;
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto [status, plugin_id] = _module_under_test->create_processor(gain_plugin_info, "gain");
+        ASSERT_EQ(EngineReturnStatus::OK, status);
+        ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->add_plugin_to_track(plugin_id, track_id));
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+
+        ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->remove_plugin_from_track(plugin_id, track_id));
+        ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->delete_plugin(plugin_id));
+    }
+    running = false;
+    rt_thread.join();
+    _module_under_test->enable_realtime(false);
+
+    std::sort(latencies.begin(), latencies.end());
+    auto p50 = latencies[ITERATIONS / 2];
+    auto p99 = latencies[ITERATIONS * 99 / 100];
+    RecordProperty("p50_us", static_cast<int>(p50.count()));
+    RecordProperty("p99_us", static_cast<int>(p99.count()));
+
+    // Both calls are answered within a few periods, far from the timeout
+    EXPECT_LT(p50, 10 * PERIOD);
+    EXPECT_LT(p99, std::chrono::milliseconds(100));
 }
 
 TEST_F(TestEngine, TestAudioConnections)
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <semaphore>
+
 #include "gtest/gtest.h"
 
 #include "elk-warning-suppressor/warning_suppressor.hpp"
@@ -64,6 +67,21 @@ private:
     bool _received {false};
 };
 
+// Records when it last received a keyboard event
+class TimingPoster : public EventPoster
+{
+public:
+    int process(Event* /*event*/) override
+    {
+        received_time = std::chrono::steady_clock::now();
+        received.release();
+        return EventStatus::HANDLED_OK;
+    }
+
+    std::chrono::steady_clock::time_point received_time;
+    std::binary_semaphore received{0};
+};
+
 class TestEventDispatcher : public ::testing::Test
 {
 public:
@@ -153,7 +171,13 @@ TEST_F(TestEventDispatcher, TestFromRtEventNoteOnEvent)
 
 TEST_F(TestEventDispatcher, TestFromRtEventParameterChangeNotification)
 {
-    RtEvent rt_event = RtEvent::make_parameter_change_event(10, 0, 10, 5.f);
+    // Parameter changes are only queued for processors whose parameters are tracked
+    auto event = std::make_unique<AudioGraphNotificationEvent>(AudioGraphNotificationEvent::Action::PROCESSOR_CREATED,
+                                                               10, 0, IMMEDIATE_PROCESS);
+    _module_under_test->post_event(std::move(event));
+    crank_event_loop_once();
+
+    RtEvent rt_event = RtEvent::make_parameter_change_event(10, 0, 0, 5.f);
     _in_rt_queue.push(rt_event);
     crank_event_loop_once();
 
@@ -242,6 +266,145 @@ TEST_F(TestEventDispatcher, TestEventProcessingOrder)
     ASSERT_EQ(last_callback, 2);
 }
 
+TEST_F(TestEventDispatcher, TestEventDrivenWakeup)
+{
+    constexpr auto TIMEOUT = std::chrono::seconds(1);
+    std::atomic<bool> handled = false;
+    _module_under_test->run();
+
+    // A posted event should wake up the event thread directly
+    auto event = std::make_unique<AudioGraphNotificationEvent>(AudioGraphNotificationEvent::Action::PROCESSOR_ADDED_TO_TRACK,
+                                                               1, 1, IMMEDIATE_PROCESS);
+    event->set_completion_cb([](void* arg, Event* /*event*/, int /*status*/)
+                             {
+                                 static_cast<std::atomic<bool>*>(arg)->store(true);
+                             }, &handled);
+    _module_under_test->post_event(std::move(event));
+
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (handled == false && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    EXPECT_TRUE(handled);
+
+    // RtEvents should be handled when signalled from the audio thread
+    _in_rt_queue.push(RtEvent::make_note_on_event(10, 0, 0, 50, 10.f));
+    _module_under_test->notify_rt_events();
+
+    deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (_in_rt_queue.empty() == false && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    EXPECT_TRUE(_in_rt_queue.empty());
+
+    // Stopping should not need to wait for any timeout
+    auto start = std::chrono::steady_clock::now();
+    _module_under_test->stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, TIMEOUT);
+}
+
+TEST_F(TestEventDispatcher, TestConcurrentPosters)
+{
+    constexpr auto TIMEOUT = std::chrono::seconds(1);
+    constexpr int POSTERS = 4;
+    constexpr int EVENTS_PER_POSTER = 100;
+    std::atomic<int> handled = 0;
+    _module_under_test->run();
+
+    // Posts from several non-rt threads at once should all wake up the event thread
+    std::vector<std::thread> posters;
+    for (int i = 0; i < POSTERS; ++i)
+    {
+        posters.emplace_back([&]
+        {
+            for (int j = 0; j < EVENTS_PER_POSTER; ++j)
+            {
+                auto event = std::make_unique<AudioGraphNotificationEvent>(AudioGraphNotificationEvent::Action::PROCESSOR_ADDED_TO_TRACK,
+                                                                           1, 1, IMMEDIATE_PROCESS);
+                event->set_completion_cb([](void* arg, Event* /*event*/, int /*status*/)
+                                         {
+                                             static_cast<std::atomic<int>*>(arg)->fetch_add(1);
+                                         }, &handled);
+                _module_under_test->post_event(std::move(event));
+            }
+        });
+    }
+    for (auto& poster : posters)
+    {
+        poster.join();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (handled < POSTERS * EVENTS_PER_POSTER && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    EXPECT_EQ(POSTERS * EVENTS_PER_POSTER, handled);
+    _module_under_test->stop();
+}
+
+TEST_F(TestEventDispatcher, TestNoWakeupsForSyncEvents)
+{
+    _module_under_test->run();
+    // Let the event thread go to sleep
+    std::this_thread::sleep_for(EVENT_PROCESS_WAIT_TIME);
+
+    // Chunks producing only synchronisation events should not wake up the event thread
+    for (int i = 0; i < 10; ++i)
+    {
+        _in_rt_queue.push(RtEvent::make_synchronisation_event(std::chrono::milliseconds(i)));
+        _module_under_test->notify_rt_events();
+    }
+    std::this_thread::sleep_for(5 * EVENT_PROCESS_WAIT_TIME);
+    EXPECT_FALSE(_in_rt_queue.empty());
+
+    // But any other event should
+    _in_rt_queue.push(RtEvent::make_note_on_event(10, 0, 0, 50, 10.f));
+    _module_under_test->notify_rt_events();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (_in_rt_queue.empty() == false && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    EXPECT_TRUE(_in_rt_queue.empty());
+    _module_under_test->stop();
+}
+
+TEST_F(TestEventDispatcher, TestRtEventLatency)
+{
+    constexpr int ITERATIONS = 200;
+    TimingPoster poster;
+    _module_under_test->subscribe_to_keyboard_events(&poster);
+    _module_under_test->run();
+
+    // Time from the audio thread signalling an RtEvent until it is published
+    std::vector<std::chrono::microseconds> latencies;
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        // Make sure the event thread is sleeping, as it would be between audio chunks
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        _in_rt_queue.push(RtEvent::make_note_on_event(10, 0, 0, 50, 10.f));
+        auto start = std::chrono::steady_clock::now();
+        _module_under_test->notify_rt_events();
+
+        // Block rather than spin, so the event thread is not starved on single core machines
+        ASSERT_TRUE(poster.received.try_acquire_for(std::chrono::seconds(1)));
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(poster.received_time - start));
+    }
+    _module_under_test->stop();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto p50 = latencies[ITERATIONS / 2];
+    auto p99 = latencies[ITERATIONS * 99 / 100];
+    RecordProperty("p50_us", static_cast<int>(p50.count()));
+    RecordProperty("p99_us", static_cast<int>(p99.count()));
+
+    // Events used to be picked up by polling every millisecond
+    EXPECT_LT(p50, std::chrono::milliseconds(1));
+}
+
 class TestWorker : public ::testing::Test
 {
 public:
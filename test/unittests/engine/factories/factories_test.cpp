@@ -15,6 +15,8 @@
 
 #include <gmock/gmock.h>
 #include <gmock/gmock-actions.h>
+#include <filesystem>
+#include <fstream>
 
 #include "sushi/offline_factory.h"
 #include "sushi/standalone_factory.h"
@@ -55,6 +57,7 @@ AudioFrontendStatus PortAudioFrontend::init(BaseAudioFrontendConfiguration*)
 #include "factories/base_factory.cpp"
 #include "factories/offline_factory.cpp"
 #include "factories/offline_factory_implementation.cpp"
+#include "factories/offline_batch.cpp"
 #include "factories/reactive_factory.cpp"
 #include "factories/reactive_factory_implementation.cpp"
 #include "factories/standalone_factory.cpp"
@@ -307,6 +310,90 @@ TEST_F(OfflineFactoryTest, TestOfflineFactoryWithConfigFile)
 #endif
 }
 
+class OfflineBatchTest : public OfflineFactoryTest
+{
+protected:
+    void SetUp() override
+    {
+        OfflineFactoryTest::SetUp();
+        auto unique_id = std::chrono::steady_clock::now().time_since_epoch().count();
+        _temp_dir = std::filesystem::temp_directory_path() / ("sushi_batch_test_" + std::to_string(unique_id));
+        ASSERT_TRUE(std::filesystem::create_directory(_temp_dir));
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(_temp_dir);
+    }
+
+    std::string temp_file(const std::string& name)
+    {
+        return (_temp_dir / name).string();
+    }
+
+    std::filesystem::path _temp_dir;
+};
+
+TEST_F(OfflineBatchTest, TestReadBatchFile)
+{
+    std::string batch_file_name = temp_file("test_batch.txt");
+    std::ofstream batch_file(batch_file_name);
+    batch_file << "# Comment\n"
+               << "first.wav first_out.wav\n"
+               << "\n"
+               << "  \"with space.wav\"\n";
+    batch_file.close();
+
+    auto jobs = read_offline_batch_file(batch_file_name);
+    ASSERT_TRUE(jobs.has_value());
+    ASSERT_EQ(2u, jobs->size());
+    EXPECT_EQ("first.wav", jobs->at(0).input_filename);
+    EXPECT_EQ("first_out.wav", jobs->at(0).output_filename);
+    EXPECT_EQ("with space.wav", jobs->at(1).input_filename);
+    EXPECT_EQ("with space.wav_proc.wav", jobs->at(1).output_filename);
+
+    batch_file.open(batch_file_name);
+    batch_file << "in.wav out.wav extra\n";
+    batch_file.close();
+    EXPECT_FALSE(read_offline_batch_file(batch_file_name).has_value());
+
+    // Quoted empty filenames are rejected
+    batch_file.open(batch_file_name);
+    batch_file << "\"\" out.wav\n";
+    batch_file.close();
+    EXPECT_FALSE(read_offline_batch_file(batch_file_name).has_value());
+
+    batch_file.open(batch_file_name);
+    batch_file << "in.wav \"\"\n";
+    batch_file.close();
+    EXPECT_FALSE(read_offline_batch_file(batch_file_name).has_value());
+
+    EXPECT_FALSE(read_offline_batch_file(temp_file("not_a_valid_file.txt")).has_value());
+}
+
+TEST_F(OfflineBatchTest, TestRenderBatch)
+{
+    std::string input_file = _path + "test_sndfile_05.wav";
+    std::vector<OfflineBatchJob> jobs = {{input_file, temp_file("test_batch_out_0.wav")},
+                                         {input_file, temp_file("test_batch_out_1.wav")},
+                                         {input_file, temp_file("test_batch_out_2.wav")},
+                                         {temp_file("not_a_valid_file.wav"), temp_file("test_batch_out_3.wav")}};
+
+    auto report = render_offline_batch(options, jobs, 2);
+
+    EXPECT_EQ(2, report.parallel_jobs);
+    ASSERT_EQ(jobs.size(), report.results.size());
+    EXPECT_EQ(1, report.failed_jobs());
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(Status::OK, report.results[i].status);
+        EXPECT_EQ(jobs[i].output_filename, report.results[i].job.output_filename);
+        EXPECT_TRUE(std::filesystem::exists(jobs[i].output_filename));
+    }
+    EXPECT_NE(Status::OK, report.results[3].status);
+    EXPECT_FALSE(report.summary().empty());
+}
+
 
 //////////////////////////////////////////////////////
 // StandaloneFactory
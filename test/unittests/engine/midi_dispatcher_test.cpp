@@ -32,9 +32,9 @@ TEST(TestMidiDispatcherEventCreation, TestMakeNoteOnEvent)
     InputConnection connection = {25, 26, 0, 1, false, 64};
     NoteOnMessage message = {1, 46, 64};
     auto event = make_note_on_event(connection, message, IMMEDIATE_PROCESS);
-    EXPECT_TRUE(event->is_keyboard_event());
-    EXPECT_EQ(IMMEDIATE_PROCESS, event->time());
-    auto typed_event = static_cast<KeyboardEvent*>(event.get());
+    EXPECT_TRUE(event.is_keyboard_event());
+    EXPECT_EQ(IMMEDIATE_PROCESS, event.time());
+    auto typed_event = &event;
     EXPECT_EQ(KeyboardEvent::Subtype::NOTE_ON, typed_event->subtype());
     EXPECT_EQ(25u, typed_event->processor_id());
     EXPECT_EQ(1, typed_event->channel());
@@ -47,9 +47,9 @@ TEST(TestMidiDispatcherEventCreation, TestMakeNoteOnWithZeroVelEvent)
     InputConnection connection = {25, 26, 0, 1, false, 64};
     NoteOnMessage message = {1, 60, 0};
     auto event = make_note_on_event(connection, message, IMMEDIATE_PROCESS);
-    EXPECT_TRUE(event->is_keyboard_event());
-    EXPECT_EQ(IMMEDIATE_PROCESS, event->time());
-    auto typed_event = static_cast<KeyboardEvent*>(event.get());
+    EXPECT_TRUE(event.is_keyboard_event());
+    EXPECT_EQ(IMMEDIATE_PROCESS, event.time());
+    auto typed_event = &event;
     EXPECT_EQ(KeyboardEvent::Subtype::NOTE_OFF, typed_event->subtype());
     EXPECT_EQ(25u, typed_event->processor_id());
     EXPECT_EQ(1, typed_event->channel());
@@ -62,9 +62,9 @@ TEST(TestMidiDispatcherEventCreation, TestMakeNoteOffEvent)
     InputConnection connection = {25, 26, 0, 1, false, 64};
     NoteOffMessage message = {2, 46, 64};
     auto event = make_note_off_event(connection, message, IMMEDIATE_PROCESS);
-    EXPECT_TRUE(event->is_keyboard_event());
-    EXPECT_EQ(IMMEDIATE_PROCESS, event->time());
-    auto typed_event = static_cast<KeyboardEvent*>(event.get());
+    EXPECT_TRUE(event.is_keyboard_event());
+    EXPECT_EQ(IMMEDIATE_PROCESS, event.time());
+    auto typed_event = &event;
     EXPECT_EQ(KeyboardEvent::Subtype::NOTE_OFF, typed_event->subtype());
     EXPECT_EQ(25u, typed_event->processor_id());
     EXPECT_EQ(2, typed_event->channel());
@@ -77,9 +77,9 @@ TEST(TestMidiDispatcherEventCreation, TestMakeWrappedMidiEvent)
     InputConnection connection = {25, 26, 0, 1, false, 64};
     uint8_t message[] = {3, 46, 64};
     auto event = make_wrapped_midi_event(connection, message, sizeof(message), IMMEDIATE_PROCESS);
-    EXPECT_TRUE(event->is_keyboard_event());
-    EXPECT_EQ(IMMEDIATE_PROCESS, event->time());
-    auto typed_event = static_cast<KeyboardEvent*>(event.get());
+    EXPECT_TRUE(event.is_keyboard_event());
+    EXPECT_EQ(IMMEDIATE_PROCESS, event.time());
+    auto typed_event = &event;
     EXPECT_EQ(KeyboardEvent::Subtype::WRAPPED_MIDI, typed_event->subtype());
     EXPECT_EQ(25u, typed_event->processor_id());
     EXPECT_EQ(3u, typed_event->midi_data()[0]);
@@ -316,6 +316,38 @@ TEST_F(TestMidiDispatcher, TestRawDataConnection)
     EXPECT_FALSE(_test_dispatcher.got_event());
 }
 
+TEST_F(TestMidiDispatcher, TestKeyboardDataToEngine)
+{
+    auto track = _test_engine.processor_container()->track("track 1");
+    ObjectId track_id = track->id();
+
+    /* With an engine set, keyboard and raw midi should bypass the event dispatcher */
+    MidiDispatcher module_under_test(&_test_dispatcher, &_test_engine);
+    module_under_test.set_midi_inputs(2);
+    module_under_test.connect_kb_to_track(1, track_id);
+    module_under_test.send_midi(1, TEST_NOTE_ON_CH2, IMMEDIATE_PROCESS);
+    EXPECT_TRUE(_test_engine.got_rt_event);
+    EXPECT_FALSE(_test_dispatcher.got_event());
+
+    _test_engine.got_rt_event = false;
+    module_under_test.disconnect_kb_from_track(1, track_id);
+    module_under_test.connect_raw_midi_to_track(1, track_id);
+    module_under_test.send_midi(1, TEST_NOTE_OFF_CH3, IMMEDIATE_PROCESS);
+    EXPECT_TRUE(_test_engine.got_rt_event);
+    EXPECT_FALSE(_test_dispatcher.got_event());
+
+    _test_engine.got_rt_event = false;
+    module_under_test.disconnect_raw_midi_from_track(1, track_id);
+    module_under_test.send_midi(1, TEST_NOTE_OFF_CH3, IMMEDIATE_PROCESS);
+    EXPECT_FALSE(_test_engine.got_rt_event);
+
+    /* Parameter changes still go through the event dispatcher */
+    module_under_test.connect_cc_to_parameter(1, track_id, 0, 67, 0, 100, false);
+    module_under_test.send_midi(1, TEST_CTRL_CH_CH4_67, IMMEDIATE_PROCESS);
+    EXPECT_FALSE(_test_engine.got_rt_event);
+    EXPECT_TRUE(_test_dispatcher.got_event());
+}
+
 TEST_F(TestMidiDispatcher, TestCCDataConnection)
 {
     // The id for the mock processor is generated by a static atomic counter in BaseIdGenetator, so needs to be fetched.
@@ -11,6 +11,7 @@
 #include "test_utils/mock_event_dispatcher.h"
 #include "test_utils/mock_processor_container.h"
 #include "test_utils/host_control_mockup.h"
+#include "test_utils/dummy_processor.h"
 
 namespace sushi::internal
 {
@@ -21,11 +22,16 @@ public:
     explicit ParameterManagerAccessor(ParameterManager& plugin) : _plugin(plugin) {}
 
     // Not const: it's altered in the tests.
-    [[nodiscard]] ParameterManager::Parameters& parameters()
+    [[nodiscard]] auto& parameters()
     {
         return _plugin._parameters;
     }
 
+    [[nodiscard]] auto& change_queue()
+    {
+        return _plugin._parameter_change_queue;
+    }
+
 private:
     ParameterManager& _plugin;
 };
@@ -47,28 +53,51 @@ constexpr auto TEST_PROCESSOR_NAME = "proc";
 constexpr float TEST_SAMPLE_RATE = 44100;
 constexpr Time TEST_MAX_INTERVAL = std::chrono::milliseconds(10);
 
-// Custom Matcher to check the returned events
-MATCHER_P5(ParameterChangeNotificationMatcherFull, proc_id, param_id, norm_val, dom_val, txt_val, "")
+// Custom Matchers to check the returned events
+MATCHER_P3(ParameterChangeNotificationMatcher, proc_id, param_id, norm_val, "")
 {
-    auto typed_ev = static_cast<ParameterChangeNotificationEvent*>(arg.get());
-    return arg->is_parameter_change_notification() &&
-           typed_ev->processor_id() == proc_id &&
-           typed_ev->parameter_id() == param_id &&
-           typed_ev->normalized_value() == norm_val &&
-           typed_ev->domain_value() == dom_val &&
-           typed_ev->formatted_value() == txt_val;
+    if (arg->is_parameter_change_batch_notification() == false)
+    {
+        return false;
+    }
+    const auto& changes = static_cast<ParameterChangeBatchNotificationEvent*>(arg.get())->changes();
+    return changes.size() == 1 &&
+           changes.front().processor_id == proc_id &&
+           changes.front().parameter_id == param_id &&
+           changes.front().normalized_value == norm_val;
 }
 
-MATCHER_P3(ParameterChangeNotificationMatcher, proc_id, param_id, norm_val, "")
+MATCHER_P(ParameterChangeBatchSizeMatcher, size, "")
 {
-    auto typed_ev = static_cast<ParameterChangeNotificationEvent*>(arg.get());
-    return arg->is_parameter_change_notification() &&
-           typed_ev->processor_id() == proc_id &&
-           typed_ev->parameter_id() == param_id &&
-           typed_ev->normalized_value() == norm_val;
+    return arg->is_parameter_change_batch_notification() &&
+           static_cast<ParameterChangeBatchNotificationEvent*>(arg.get())->changes().size() == static_cast<size_t>(size);
 }
 
 
+// Parameter ids like those of Vst3 plugins, which are arbitrary 32 bit values
+constexpr ObjectId SPARSE_PARAMETER_ID = 0x7FFF1234;
+
+class SparseParameterProcessor : public DummyProcessor
+{
+public:
+    explicit SparseParameterProcessor(HostControl host_control) : DummyProcessor(host_control)
+    {
+        this->register_parameter(new ParameterDescriptor("sparse", "sparse", "", ParameterType::FLOAT), SPARSE_PARAMETER_ID);
+    }
+
+    std::pair<ProcessorReturnCode, float> parameter_value(ObjectId parameter_id) const override
+    {
+        return {ProcessorReturnCode::OK, parameter_id == SPARSE_PARAMETER_ID ? value : 0.0f};
+    }
+
+    std::pair<ProcessorReturnCode, float> parameter_value_in_domain(ObjectId parameter_id) const override
+    {
+        return parameter_value(parameter_id);
+    }
+
+    float value{0.0f};
+};
+
 class TestParameterManager : public ::testing::Test
 {
 protected:
@@ -105,12 +134,6 @@ protected:
     std::shared_ptr<Track> _test_track;
 };
 
-TEST_F(TestParameterManager, TestEventCreation)
-{
-    EXPECT_CALL(_mock_dispatcher, dispatch(ParameterChangeNotificationMatcherFull(3u, 4u, 0.5f, 5.0f, "5.0"))).Times(1);
-    send_parameter_notification(3u, 4u, 0.5f, 5.0f, "5.0", &_mock_dispatcher);
-}
-
 TEST_F(TestParameterManager, TestParameterUpdates)
 {
     _test_track->process_event(RtEvent::make_parameter_change_event(0, 0, 0, 0.7f));
@@ -158,8 +181,8 @@ TEST_F(TestParameterManager, TestProcessorUpdates)
     EXPECT_CALL(_mock_dispatcher, dispatch(_)).Times(0);
     _module_under_test.output_parameter_notifications(&_mock_dispatcher, Time(0));
 
-    // Expect 1 notification from every parameter of test_track
-    EXPECT_CALL(_mock_dispatcher, dispatch(_)).Times(_test_track->parameter_count());
+    // Expect 1 notification with every parameter of test_track
+    EXPECT_CALL(_mock_dispatcher, dispatch(ParameterChangeBatchSizeMatcher(_test_track->parameter_count()))).Times(1);
     _module_under_test.output_parameter_notifications(&_mock_dispatcher, 2 * TEST_MAX_INTERVAL);
 
     // Expect no notifications as nothing has changed
@@ -182,13 +205,65 @@ TEST_F(TestParameterManager, TestErrorHandling)
     EXPECT_CALL(_mock_dispatcher, dispatch(_)).Times(0);
     _module_under_test.output_parameter_notifications(&_mock_dispatcher, 2 * TEST_MAX_INTERVAL);
 
-    // Force a value change for this particular parameter, we still shouldn't output anything
-    const auto& value = _accessor.parameters()[_test_track->id()].find(1234);
-    if (value != _accessor.parameters()[_test_track->id()].end())
+    // Force a value change for all tracked parameters, we still shouldn't output anything
+    for (auto& entry : _accessor.parameters())
     {
-        value->second.value = 0.5;
+        entry.value = 0.5;
     }
 
     _module_under_test.mark_parameter_changed(_test_track->id(), 1234, TEST_MAX_INTERVAL);
     _module_under_test.output_parameter_notifications(&_mock_dispatcher, 2 * TEST_MAX_INTERVAL);
 }
+
+TEST_F(TestParameterManager, TestCoalescing)
+{
+    // Mark the same parameter several times, it should only be queued and notified once
+    _test_processor->process_event(RtEvent::make_parameter_change_event(0, 0, 0, 0.6f));
+    for (int i = 0; i < 5; ++i)
+    {
+        _module_under_test.mark_parameter_changed(_test_processor->id(), 0, TEST_MAX_INTERVAL);
+    }
+    _test_track->process_event(RtEvent::make_parameter_change_event(0, 0, 0, 0.7f));
+    _module_under_test.mark_parameter_changed(_test_track->id(), 0, TEST_MAX_INTERVAL);
+    EXPECT_EQ(2u, _accessor.change_queue().size());
+
+    // Changes from both processors should be sent in one event
+    EXPECT_CALL(_mock_dispatcher, dispatch(ParameterChangeBatchSizeMatcher(2))).Times(1);
+    _module_under_test.output_parameter_notifications(&_mock_dispatcher, TEST_MAX_INTERVAL);
+    EXPECT_TRUE(_module_under_test.parameter_change_queue_empty());
+}
+
+TEST_F(TestParameterManager, TestUntracking)
+{
+    _test_track->process_event(RtEvent::make_parameter_change_event(0, 0, 0, 0.7f));
+    _test_processor->process_event(RtEvent::make_parameter_change_event(0, 0, 0, 0.6f));
+    _module_under_test.mark_parameter_changed(_test_processor->id(), 0, TEST_MAX_INTERVAL);
+    _module_under_test.mark_parameter_changed(_test_track->id(), 0, TEST_MAX_INTERVAL);
+
+    // Queued changes of an untracked processor should be dropped, but not those of others
+    _module_under_test.untrack_parameters(_test_processor->id());
+    EXPECT_CALL(_mock_dispatcher, dispatch(ParameterChangeNotificationMatcher(_test_track->id(), 0u, 0.7f))).Times(1);
+    _module_under_test.output_parameter_notifications(&_mock_dispatcher, TEST_MAX_INTERVAL);
+
+    _module_under_test.mark_parameter_changed(_test_processor->id(), 0, TEST_MAX_INTERVAL);
+    EXPECT_TRUE(_module_under_test.parameter_change_queue_empty());
+}
+
+TEST_F(TestParameterManager, TestSparseParameterIds)
+{
+    auto processor = std::make_shared<SparseParameterProcessor>(_host_control_mockup.make_host_control_mockup());
+    ON_CALL(_mock_processor_container, processor(processor->id())).WillByDefault(Return(processor));
+    auto table_size = _accessor.parameters().size();
+    _module_under_test.track_parameters(processor->id());
+
+    // Only one slot per parameter should be added, regardless of the id values
+    EXPECT_EQ(table_size + static_cast<size_t>(processor->parameter_count()), _accessor.parameters().size());
+
+    processor->value = 0.5f;
+    _module_under_test.mark_parameter_changed(processor->id(), SPARSE_PARAMETER_ID, TEST_MAX_INTERVAL);
+    _module_under_test.mark_parameter_changed(processor->id(), SPARSE_PARAMETER_ID + 1, TEST_MAX_INTERVAL);
+    EXPECT_EQ(1u, _accessor.change_queue().size());
+
+    EXPECT_CALL(_mock_dispatcher, dispatch(ParameterChangeNotificationMatcher(processor->id(), SPARSE_PARAMETER_ID, 0.5f))).Times(1);
+    _module_under_test.output_parameter_notifications(&_mock_dispatcher, TEST_MAX_INTERVAL);
+}
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "elk-warning-suppressor/warning_suppressor.hpp"
@@ -15,33 +19,128 @@ class TestAsyncReceiver : public ::testing::Test
 protected:
     TestAsyncReceiver() = default;
 
-    RtSafeRtEventFifo _queue;
-    AsynchronousEventReceiver _module_under_test{&_queue};
+    AsynchronousEventReceiver _module_under_test;
 };
 
 
 TEST_F(TestAsyncReceiver, TestBasicHandling)
 {
-    ASSERT_FALSE(_module_under_test.wait_for_response(123u, ZERO_TIMEOUT));
+    ASSERT_FALSE(_module_under_test.wait_for_response({123u, 0}, ZERO_TIMEOUT));
     auto event = RtEvent::make_insert_processor_event(nullptr);
-    EventId id = event.returnable_event()->event_id();
+    auto ticket = _module_under_test.expect_response(event.returnable_event()->event_id());
+    ASSERT_FALSE(_module_under_test.wait_for_response(ticket, ZERO_TIMEOUT));
+
+    ticket = _module_under_test.expect_response(event.returnable_event()->event_id());
     event.returnable_event()->set_handled(true);
-    _queue.push(event);
-    ASSERT_TRUE(_module_under_test.wait_for_response(id, ZERO_TIMEOUT));
+    _module_under_test.notify_response(event);
+    ASSERT_TRUE(_module_under_test.wait_for_response(ticket, ZERO_TIMEOUT));
 }
 
 TEST_F(TestAsyncReceiver, TestMultipleEvents)
 {
-    ASSERT_FALSE(_module_under_test.wait_for_response(123u, ZERO_TIMEOUT));
     auto event1 = RtEvent::make_insert_processor_event(nullptr);
     auto event2 = RtEvent::make_add_processor_to_track_event(123, 234);
     event1.returnable_event()->set_handled(true);
     event2.returnable_event()->set_handled(true);
-    EventId id1 = event1.returnable_event()->event_id();
-    EventId id2 = event2.returnable_event()->event_id();
-    _queue.push(event1);
-    _queue.push(event2);
+    auto ticket1 = _module_under_test.expect_response(event1.returnable_event()->event_id());
+    auto ticket2 = _module_under_test.expect_response(event2.returnable_event()->event_id());
+    _module_under_test.notify_response(event1);
+    _module_under_test.notify_response(event2);
     // Get the acks in the reverse order to exercise more of the code
-    ASSERT_TRUE(_module_under_test.wait_for_response(id2, ZERO_TIMEOUT));
-    ASSERT_TRUE(_module_under_test.wait_for_response(id1, ZERO_TIMEOUT));
-}
\ No newline at end of file
+    ASSERT_TRUE(_module_under_test.wait_for_response(ticket2, ZERO_TIMEOUT));
+    ASSERT_TRUE(_module_under_test.wait_for_response(ticket1, ZERO_TIMEOUT));
+}
+
+TEST_F(TestAsyncReceiver, TestFailedEvent)
+{
+    auto event = RtEvent::make_insert_processor_event(nullptr);
+    auto ticket = _module_under_test.expect_response(event.returnable_event()->event_id());
+    event.returnable_event()->set_handled(false);
+    _module_under_test.notify_response(event);
+    ASSERT_FALSE(_module_under_test.wait_for_response(ticket, ZERO_TIMEOUT));
+}
+
+TEST_F(TestAsyncReceiver, TestLateResponse)
+{
+    auto event = RtEvent::make_insert_processor_event(nullptr);
+    EventId id = event.returnable_event()->event_id();
+    event.returnable_event()->set_handled(true);
+
+    // A response that arrives after the wait timed out is dropped
+    auto ticket = _module_under_test.expect_response(id);
+    ASSERT_FALSE(_module_under_test.wait_for_response(ticket, ZERO_TIMEOUT));
+    _module_under_test.notify_response(event);
+
+    // And not mistaken for the response to a later event with the same id
+    auto new_ticket = _module_under_test.expect_response(id);
+    EXPECT_NE(ticket.generation, new_ticket.generation);
+    EXPECT_FALSE(_module_under_test.wait_for_response(new_ticket, ZERO_TIMEOUT));
+
+    // A response without a waiting thread is dropped too
+    _module_under_test.notify_response(event);
+    EXPECT_FALSE(_module_under_test.wait_for_response(_module_under_test.expect_response(id), ZERO_TIMEOUT));
+}
+
+TEST_F(TestAsyncReceiver, TestResponseFromOtherThread)
+{
+    constexpr int ITERATIONS = 100;
+    constexpr auto TIMEOUT = std::chrono::milliseconds(500);
+    constexpr auto RESPONSE_DELAY = std::chrono::microseconds(100);
+    // The interval the receiver used to poll with, timeout / MAX_RETRIES with the engine's timeout
+    constexpr auto POLL_INTERVAL = std::chrono::milliseconds(200) / 100;
+
+    /* Every response is sent while the main thread is waiting for it, time from the
+     * response being sent until the waiting thread wakes up and has it */
+    std::vector<std::chrono::microseconds> latencies;
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        auto event = RtEvent::make_insert_processor_event(nullptr);
+        auto ticket = _module_under_test.expect_response(event.returnable_event()->event_id());
+        event.returnable_event()->set_handled(true);
+        std::chrono::steady_clock::time_point sent;
+        std::thread responder([&]()
+        {
+            std::this_thread::sleep_for(RESPONSE_DELAY);
+            sent = std::chrono::steady_clock::now();
+            _module_under_test.notify_response(event);
+        });
+        EXPECT_TRUE(_module_under_test.wait_for_response(ticket, TIMEOUT));
+        auto received = std::chrono::steady_clock::now();
+        responder.join();
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(received - sent));
+    }
+
+    // The same exchange with a waiting thread that polls for the response
+    std::vector<std::chrono::microseconds> polling_latencies;
+    for (int i = 0; i < ITERATIONS / 4; ++i)
+    {
+        std::atomic<bool> responded = false;
+        std::chrono::steady_clock::time_point sent;
+        std::thread responder([&]()
+        {
+            std::this_thread::sleep_for(RESPONSE_DELAY);
+            sent = std::chrono::steady_clock::now();
+            responded = true;
+        });
+        while (responded == false)
+        {
+            std::this_thread::sleep_for(POLL_INTERVAL);
+        }
+        auto received = std::chrono::steady_clock::now();
+        responder.join();
+        polling_latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(received - sent));
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::sort(polling_latencies.begin(), polling_latencies.end());
+    auto p50 = latencies[latencies.size() / 2];
+    auto p99 = latencies[latencies.size() * 99 / 100];
+    auto polling_p50 = polling_latencies[polling_latencies.size() / 2];
+    auto polling_p99 = polling_latencies[polling_latencies.size() * 99 / 100];
+    RecordProperty("p50_us", static_cast<int>(p50.count()));
+    RecordProperty("p99_us", static_cast<int>(p99.count()));
+    RecordProperty("polling_p50_us", static_cast<int>(polling_p50.count()));
+    RecordProperty("polling_p99_us", static_cast<int>(polling_p99.count()));
+
+    EXPECT_LT(p50, polling_p50);
+}
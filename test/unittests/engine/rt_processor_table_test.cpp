@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "test_utils/host_control_mockup.h"
+#include "test_utils/dummy_processor.h"
+
+#include "engine/rt_processor_table.cpp"
+
+using namespace sushi;
+using namespace sushi::internal;
+using namespace sushi::internal::engine;
+
+constexpr int TEST_INITIAL_SIZE = 4;
+constexpr int TEST_PROCESSOR_COUNT = 300;
+
+class TestRtProcessorTable : public ::testing::Test
+{
+protected:
+    TestRtProcessorTable()
+    {
+        for (int i = 0; i < TEST_PROCESSOR_COUNT; ++i)
+        {
+            _processors.push_back(std::make_unique<DummyProcessor>(_hc.make_host_control_mockup()));
+        }
+    }
+
+    HostControlMockup _hc;
+    std::vector<std::unique_ptr<Processor>> _processors;
+    RtProcessorTable _module_under_test{TEST_INITIAL_SIZE};
+};
+
+TEST_F(TestRtProcessorTable, TestInsertAndFind)
+{
+    EXPECT_EQ(nullptr, _module_under_test.find(_processors[0]->id()));
+
+    _module_under_test.prepare_insert();
+    ASSERT_TRUE(_module_under_test.insert(_processors[0].get()));
+    EXPECT_EQ(_processors[0].get(), _module_under_test.find(_processors[0]->id()));
+    EXPECT_EQ(nullptr, _module_under_test.find(_processors[1]->id()));
+    EXPECT_EQ(1, _module_under_test.size());
+
+    // Inserting twice should fail
+    _module_under_test.prepare_insert();
+    EXPECT_FALSE(_module_under_test.insert(_processors[0].get()));
+    EXPECT_EQ(1, _module_under_test.size());
+}
+
+TEST_F(TestRtProcessorTable, TestFullTable)
+{
+    // Without prepare_insert() the table can't grow and insertions eventually fail
+    int inserted = 0;
+    for (auto& processor : _processors)
+    {
+        inserted += _module_under_test.insert(processor.get());
+    }
+    EXPECT_EQ(3, inserted);
+    EXPECT_EQ(TEST_INITIAL_SIZE, _module_under_test.capacity());
+
+    // Every refused insertion is counted so that it can be reported outside the audio thread
+    EXPECT_EQ(TEST_PROCESSOR_COUNT - 3, _module_under_test.failed_inserts());
+    _module_under_test.prepare_insert();
+    EXPECT_EQ(0, _module_under_test.failed_inserts());
+
+    // Inserting an existing processor is not a capacity failure
+    EXPECT_FALSE(_module_under_test.insert(_processors[0].get()));
+    EXPECT_EQ(0, _module_under_test.failed_inserts());
+}
+
+TEST_F(TestRtProcessorTable, TestGrowing)
+{
+    for (auto& processor : _processors)
+    {
+        _module_under_test.prepare_insert();
+        ASSERT_TRUE(_module_under_test.insert(processor.get()));
+    }
+    EXPECT_EQ(TEST_PROCESSOR_COUNT, _module_under_test.size());
+    EXPECT_GE(_module_under_test.capacity(), 2 * TEST_PROCESSOR_COUNT);
+    for (auto& processor : _processors)
+    {
+        ASSERT_EQ(processor.get(), _module_under_test.find(processor->id()));
+    }
+}
+
+TEST_F(TestRtProcessorTable, TestPrepareForMultipleInserts)
+{
+    // A single prepare call should make room for a whole batch of insertions
+    _module_under_test.prepare_insert(TEST_PROCESSOR_COUNT);
+    for (auto& processor : _processors)
+    {
+        ASSERT_TRUE(_module_under_test.insert(processor.get()));
+    }
+    EXPECT_EQ(TEST_PROCESSOR_COUNT, _module_under_test.size());
+    EXPECT_GE(_module_under_test.capacity(), 2 * TEST_PROCESSOR_COUNT);
+}
+
+TEST_F(TestRtProcessorTable, TestRemoving)
+{
+    for (auto& processor : _processors)
+    {
+        _module_under_test.prepare_insert();
+        ASSERT_TRUE(_module_under_test.insert(processor.get()));
+    }
+
+    // Remove half of the processors in random order and check that the rest are still found
+    std::vector<Processor*> removal_order;
+    for (auto& processor : _processors)
+    {
+        removal_order.push_back(processor.get());
+    }
+    std::shuffle(removal_order.begin(), removal_order.end(), std::mt19937(1234));
+    removal_order.resize(TEST_PROCESSOR_COUNT / 2);
+    for (auto processor : removal_order)
+    {
+        ASSERT_TRUE(_module_under_test.remove(processor->id()));
+        ASSERT_FALSE(_module_under_test.remove(processor->id()));
+    }
+    EXPECT_EQ(TEST_PROCESSOR_COUNT / 2, _module_under_test.size());
+
+    for (auto& processor : _processors)
+    {
+        bool removed = std::find(removal_order.begin(), removal_order.end(), processor.get()) != removal_order.end();
+        ASSERT_EQ(removed ? nullptr : processor.get(), _module_under_test.find(processor->id()));
+    }
+
+    // Removed processors can be inserted again
+    _module_under_test.prepare_insert();
+    ASSERT_TRUE(_module_under_test.insert(removal_order.front()));
+    EXPECT_EQ(removal_order.front(), _module_under_test.find(removal_order.front()->id()));
+}
@@ -0,0 +1,146 @@
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "engine/telemetry_publisher.cpp"
+#include "test_utils/host_control_mockup.h"
+
+using namespace sushi;
+using namespace sushi::internal;
+using namespace sushi::internal::engine;
+
+constexpr float TEST_SAMPLE_RATE = 48000;
+constexpr char TELEMETRY_FILE[] = "./test_telemetry";
+
+class TestTelemetryPublisher : public ::testing::Test
+{
+protected:
+    TestTelemetryPublisher() = default;
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(_module_under_test.open(TELEMETRY_FILE));
+        _module_under_test.set_sample_rate(TEST_SAMPLE_RATE);
+        _graph.set_measure_render_times(true);
+        ASSERT_TRUE(_graph.add(&_track));
+    }
+
+    void TearDown() override
+    {
+        _module_under_test.close();
+        std::filesystem::remove(TELEMETRY_FILE);
+    }
+
+    // Read the data the way an external process would
+    bool read_file(TelemetryData& data)
+    {
+        TelemetryData shared;
+        std::ifstream file(TELEMETRY_FILE, std::ios::binary);
+        file.read(reinterpret_cast<char*>(&shared), sizeof(TelemetryData));
+        return file.good() && read_telemetry(shared, data);
+    }
+
+    TelemetryPublisher _module_under_test;
+
+    HostControlMockup _hc;
+    RtEventFifo<10> _event_output;
+    Transport _transport{TEST_SAMPLE_RATE, &_event_output};
+    performance::PerformanceTimer _timer;
+    Track _track{_hc.make_host_control_mockup(TEST_SAMPLE_RATE), 2, &_timer};
+    AudioGraph _graph{1, 2, TEST_SAMPLE_RATE};
+};
+
+TEST_F(TestTelemetryPublisher, TestOpen)
+{
+    TelemetryData data;
+    ASSERT_TRUE(read_file(data));
+    EXPECT_EQ(0u, data.period);
+    EXPECT_EQ(0u, data.input_channels);
+
+    TelemetryPublisher publisher;
+    EXPECT_FALSE(publisher.open("/non_existing_dir/telemetry"));
+    EXPECT_FALSE(publisher.is_open());
+}
+
+TEST_F(TestTelemetryPublisher, TestPublish)
+{
+    ChunkSampleBuffer in(2);
+    ChunkSampleBuffer out(4);
+    in.clear();
+    out.clear();
+    in.channel(1)[10] = -0.5f;
+    out.channel(3)[20] = 1.5f;
+    _transport.set_time(std::chrono::microseconds(1000), AUDIO_CHUNK_SIZE);
+    _graph.render();
+
+    auto period_time = std::chrono::nanoseconds(static_cast<int64_t>(AUDIO_CHUNK_SIZE * 1e9 / TEST_SAMPLE_RATE));
+    _module_under_test.measure_input_rt(in);
+    _module_under_test.publish_rt(out, _transport, _graph, period_time / 2);
+
+    TelemetryData data;
+    ASSERT_TRUE(read_file(data));
+    EXPECT_EQ(1u, data.period);
+    EXPECT_EQ(2u, data.sequence);
+    EXPECT_EQ(1000, data.timestamp);
+    EXPECT_EQ(AUDIO_CHUNK_SIZE, data.sample_count);
+    EXPECT_NEAR(0.5f, data.engine_load, 0.01f);
+
+    ASSERT_EQ(2u, data.input_channels);
+    ASSERT_EQ(4u, data.output_channels);
+    EXPECT_FLOAT_EQ(0.0f, data.inputs[0].peak);
+    EXPECT_FLOAT_EQ(0.5f, data.inputs[1].peak);
+    EXPECT_FLOAT_EQ(1.5f, data.outputs[3].peak);
+    EXPECT_EQ(0u, data.inputs[1].clip_count);
+    EXPECT_EQ(1u, data.outputs[3].clip_count);
+
+    ASSERT_EQ(1u, data.node_count);
+    EXPECT_EQ(_track.id(), data.nodes[0].id);
+    EXPECT_GT(data.nodes[0].load, 0.0f);
+
+    // Clip counts accumulate, peaks only reflect the last period
+    _module_under_test.publish_rt(out, _transport, _graph, period_time / 2);
+    out.clear();
+    _module_under_test.publish_rt(out, _transport, _graph, period_time / 2);
+    ASSERT_TRUE(read_file(data));
+    EXPECT_EQ(3u, data.period);
+    EXPECT_FLOAT_EQ(0.0f, data.outputs[3].peak);
+    EXPECT_EQ(2u, data.outputs[3].clip_count);
+}
+
+TEST_F(TestTelemetryPublisher, TestSharedInputAndOutput)
+{
+    // Some frontends pass the same buffer as input and output
+    ChunkSampleBuffer buffer(2);
+    buffer.clear();
+    buffer.channel(0)[10] = 0.25f;
+    _module_under_test.measure_input_rt(buffer);
+
+    buffer.clear();
+    buffer.channel(1)[10] = 0.75f;
+    _module_under_test.publish_rt(buffer, _transport, _graph, std::chrono::nanoseconds(0));
+
+    TelemetryData data;
+    ASSERT_TRUE(read_file(data));
+    EXPECT_FLOAT_EQ(0.25f, data.inputs[0].peak);
+    EXPECT_FLOAT_EQ(0.0f, data.inputs[1].peak);
+    EXPECT_FLOAT_EQ(0.0f, data.outputs[0].peak);
+    EXPECT_FLOAT_EQ(0.75f, data.outputs[1].peak);
+}
+
+TEST_F(TestTelemetryPublisher, TestTornRead)
+{
+    TelemetryData shared{};
+    TelemetryData copy;
+    shared.magic = TELEMETRY_MAGIC;
+    shared.version = TELEMETRY_VERSION;
+    EXPECT_TRUE(read_telemetry(shared, copy));
+
+    // An odd sequence means the engine is in the middle of writing
+    shared.sequence = 3;
+    EXPECT_FALSE(read_telemetry(shared, copy, 5));
+
+    shared.sequence = 4;
+    shared.magic = 0;
+    EXPECT_FALSE(read_telemetry(shared, copy));
+}
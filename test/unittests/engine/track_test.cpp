@@ -325,6 +325,71 @@ TEST_F(TrackTest, TestSilenceUnusedChannels)
     test_utils::assert_buffer_value(0.0f, right_channel);
 }
 
+TEST_F(TrackTest, TestBuffersFromArena)
+{
+    auto arena = std::make_shared<BufferArena>();
+    float* region;
+    {
+        Track track(_host_control.make_host_control_mockup(), 2, &_timer, arena);
+        track.init(TEST_SAMPLE_RATE);
+        region = track.input_bus(0).channel(0);
+        EXPECT_EQ(track.output_bus(0).channel(0), region + 4 * AUDIO_CHUNK_SIZE);
+
+        auto in_bus = track.input_bus(1);
+        test_utils::fill_sample_buffer(in_bus, 1.0f);
+        track.render();
+        auto out_bus = track.output_bus(1);
+        test_utils::assert_buffer_value(1.0f, out_bus);
+    }
+    // The regions of the deleted track should be reused by the next one
+    Track track(_host_control.make_host_control_mockup(), 2, &_timer, arena);
+    EXPECT_TRUE(track.input_bus(0).channel(0) == region || track.output_bus(0).channel(0) == region);
+}
+
+TEST_F(TrackTest, TestInputAliasAndOutputRoutes)
+{
+    // With 2 plugins, the track must not use the aliased buffer as scratch memory
+    passthrough_plugin::PassthroughPlugin plugin(_host_control.make_host_control_mockup());
+    passthrough_plugin::PassthroughPlugin plugin_2(_host_control.make_host_control_mockup());
+    for (auto p : {&plugin, &plugin_2})
+    {
+        p->init(TEST_SAMPLE_RATE);
+        p->set_enabled(true);
+        p->set_channels(TEST_CHANNEL_COUNT, TEST_CHANNEL_COUNT);
+        _module_under_test.add(p);
+    }
+
+    ChunkSampleBuffer engine_in(4);
+    auto aliased_in = ChunkSampleBuffer::create_non_owning_buffer(engine_in, 2, TEST_CHANNEL_COUNT);
+    test_utils::fill_sample_buffer(aliased_in, 1.0f);
+    ASSERT_EQ(TEST_CHANNEL_COUNT, _module_under_test.input_buffer_channels());
+
+    _module_under_test.set_input_alias(ChunkSampleBuffer::create_non_owning_buffer(engine_in, 2, TEST_CHANNEL_COUNT));
+    _module_under_test.render();
+    auto out = _module_under_test.output_bus(0);
+    test_utils::assert_buffer_value(1.0f, out, test_utils::DECIBEL_ERROR);
+    test_utils::assert_buffer_value(1.0f, aliased_in);
+
+    // Mix the track, swapping left and right, the left channel twice
+    ChunkSampleBuffer engine_out(3);
+    ASSERT_TRUE(_module_under_test.add_output_route(LEFT_CHANNEL_INDEX, 1));
+    ASSERT_TRUE(_module_under_test.add_output_route(LEFT_CHANNEL_INDEX, 2));
+    ASSERT_TRUE(_module_under_test.add_output_route(RIGHT_CHANNEL_INDEX, 0));
+    _module_under_test.mix_to_outputs(engine_out);
+    _module_under_test.mix_to_outputs(engine_out);
+    test_utils::assert_buffer_value(2.0f, engine_out, test_utils::DECIBEL_ERROR);
+
+    // The alias is only used for one render, the track's own buffer is used after that
+    _module_under_test.clear_input_alias();
+    _module_under_test.render();
+    test_utils::assert_buffer_value(0.0f, out);
+
+    _module_under_test.clear_output_routes();
+    engine_out.clear();
+    _module_under_test.mix_to_outputs(engine_out);
+    test_utils::assert_buffer_value(0.0f, engine_out);
+}
+
 TEST(TestStandAloneFunctions, TesPanAndGainCalculation)
 {
     auto [left_gain, right_gain] = calc_l_r_gain(5.0f, 0.0f);
@@ -0,0 +1,98 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "library/event_pool.cpp"
+
+using namespace sushi;
+using namespace sushi::internal;
+
+class TestEventPool : public ::testing::Test
+{
+protected:
+    TestEventPool() = default;
+
+    EventPool _module_under_test;
+};
+
+TEST_F(TestEventPool, TestAllocation)
+{
+    EXPECT_EQ(0u, _module_under_test.reserved_size());
+
+    auto block = _module_under_test.allocate(48);
+    ASSERT_NE(nullptr, block);
+    EXPECT_EQ(EVENT_POOL_MIN_BLOCK_SIZE * EVENT_POOL_BLOCKS_PER_SLAB, _module_under_test.reserved_size());
+
+    // Blocks from the same slab should not overlap
+    auto second_block = _module_under_test.allocate(EVENT_POOL_MIN_BLOCK_SIZE);
+    EXPECT_GE(std::abs(static_cast<std::byte*>(second_block) - static_cast<std::byte*>(block)),
+              static_cast<std::ptrdiff_t>(EVENT_POOL_MIN_BLOCK_SIZE));
+
+    _module_under_test.deallocate(second_block, EVENT_POOL_MIN_BLOCK_SIZE);
+    _module_under_test.deallocate(block, 48);
+}
+
+TEST_F(TestEventPool, TestRecycling)
+{
+    auto block = _module_under_test.allocate(100);
+    _module_under_test.deallocate(block, 100);
+    auto reserved = _module_under_test.reserved_size();
+
+    // A freed block should be handed out again for the next allocation in the same size class
+    EXPECT_EQ(block, _module_under_test.allocate(120));
+    EXPECT_EQ(reserved, _module_under_test.reserved_size());
+
+    // But not for a different size class
+    auto other_block = _module_under_test.allocate(200);
+    EXPECT_NE(block, other_block);
+    EXPECT_GT(_module_under_test.reserved_size(), reserved);
+
+    _module_under_test.deallocate(block, 120);
+    _module_under_test.deallocate(other_block, 200);
+}
+
+TEST_F(TestEventPool, TestLargeAllocation)
+{
+    auto block = _module_under_test.allocate(EVENT_POOL_MAX_BLOCK_SIZE + 1);
+    ASSERT_NE(nullptr, block);
+    EXPECT_EQ(0u, _module_under_test.reserved_size());
+    _module_under_test.deallocate(block, EVENT_POOL_MAX_BLOCK_SIZE + 1);
+    _module_under_test.deallocate(nullptr, 64);
+}
+
+TEST_F(TestEventPool, TestConcurrentAllocation)
+{
+    constexpr int THREADS = 4;
+    constexpr int ITERATIONS = 10000;
+    constexpr int BLOCKS = 16;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            void* blocks[BLOCKS];
+            for (int i = 0; i < ITERATIONS; ++i)
+            {
+                for (auto& block : blocks)
+                {
+                    block = _module_under_test.allocate(64);
+                    // Tag the block to catch two threads being handed the same block
+                    *static_cast<int*>(block) = t;
+                }
+                for (auto block : blocks)
+                {
+                    ASSERT_EQ(t, *static_cast<int*>(block));
+                    _module_under_test.deallocate(block, 64);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    // Every thread holds at most BLOCKS blocks at the same time
+    EXPECT_LE(_module_under_test.reserved_size(), static_cast<size_t>(THREADS * (BLOCKS + EVENT_POOL_BLOCKS_PER_SLAB) * 64));
+}
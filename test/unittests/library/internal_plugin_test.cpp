@@ -58,6 +58,32 @@ public:
 };
 
 
+// Outputs the value of its parameter in every sample, and records the segments processed
+class SegmentedTestPlugin : public InternalPlugin
+{
+public:
+    explicit SegmentedTestPlugin(HostControl host_control) : InternalPlugin(host_control)
+    {
+        set_name("segmented_test_plugin");
+        parameter = register_float_parameter("param_1", "Param 1", "", 0.0f, 0.0f, 1.0f,
+                                             Direction::AUTOMATABLE, new FloatParameterPreProcessor(0.0f, 1.0f));
+        enable_sample_accurate_automation(parameter);
+    }
+
+    void process_audio(const ChunkSampleBuffer& /*in_buffer*/, ChunkSampleBuffer &out_buffer) override
+    {
+        segments = 0;
+        process_in_segments([&](int offset, int samples)
+        {
+            std::fill(out_buffer.channel(0) + offset, out_buffer.channel(0) + offset + samples, parameter->processed_value());
+            segments++;
+        });
+    }
+
+    FloatParameterValue* parameter;
+    int segments{0};
+};
+
 class InternalPluginTest : public ::testing::Test
 {
 protected:
@@ -393,4 +419,51 @@ TEST_F(InternalPluginTest, TestKeyboardEventPassthrough)
     // Non-keyboard events should not pass through
     _module_under_test->process_event(RtEvent::make_cv_event(0, 0, 1, 0.5f));
     ASSERT_TRUE(_host_control._event_output.empty());
-}
\ No newline at end of file
+}
+TEST_F(InternalPluginTest, TestSampleAccurateParameterChanges)
+{
+    SegmentedTestPlugin plugin(_host_control.make_host_control_mockup());
+    ChunkSampleBuffer in_buffer(1);
+    ChunkSampleBuffer out_buffer(1);
+
+    // Without changes, the whole chunk is processed at once
+    plugin.process_audio(in_buffer, out_buffer);
+    EXPECT_EQ(1, plugin.segments);
+
+    // Events are sent out of order to check that they are sorted
+    constexpr int FIRST_OFFSET = AUDIO_CHUNK_SIZE / 4;
+    constexpr int SECOND_OFFSET = AUDIO_CHUNK_SIZE / 2;
+    plugin.process_event(RtEvent::make_parameter_change_event(plugin.id(), SECOND_OFFSET, 0, 0.75f));
+    plugin.process_event(RtEvent::make_parameter_change_event(plugin.id(), 0, 0, 0.25f));
+    plugin.process_event(RtEvent::make_parameter_change_event(plugin.id(), FIRST_OFFSET, 0, 0.5f));
+    // Changes without an offset are applied directly
+    EXPECT_FLOAT_EQ(0.25f, plugin.parameter->processed_value());
+
+    plugin.process_audio(in_buffer, out_buffer);
+    EXPECT_EQ(3, plugin.segments);
+    for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+    {
+        float expected = i < FIRST_OFFSET ? 0.25f : (i < SECOND_OFFSET ? 0.5f : 0.75f);
+        ASSERT_FLOAT_EQ(expected, out_buffer.channel(0)[i]);
+    }
+    EXPECT_FLOAT_EQ(0.75f, plugin.parameter->processed_value());
+
+    plugin.process_audio(in_buffer, out_buffer);
+    EXPECT_EQ(1, plugin.segments);
+
+    // When the queue is full, new changes are merged with the last queued one
+    for (int i = 0; i < MAX_QUEUED_PARAMETER_CHANGES; ++i)
+    {
+        plugin.process_event(RtEvent::make_parameter_change_event(plugin.id(), i + 1, 0, 0.5f));
+    }
+    plugin.process_event(RtEvent::make_parameter_change_event(plugin.id(), AUDIO_CHUNK_SIZE - 1, 0, 1.0f));
+    plugin.process_audio(in_buffer, out_buffer);
+    EXPECT_FLOAT_EQ(1.0f, plugin.parameter->processed_value());
+    EXPECT_FLOAT_EQ(1.0f, out_buffer.channel(0)[AUDIO_CHUNK_SIZE - 1]);
+
+    // Parameters that are not sample accurate are set directly
+    auto value = _module_under_test->register_float_parameter("param_1", "Param 1", "", 0.0f, 0.0f, 1.0f,
+                                                              Direction::AUTOMATABLE, new FloatParameterPreProcessor(0.0f, 1.0f));
+    _module_under_test->process_event(RtEvent::make_parameter_change_event(0, FIRST_OFFSET, 0, 0.5f));
+    EXPECT_FLOAT_EQ(0.5f, value->processed_value());
+}
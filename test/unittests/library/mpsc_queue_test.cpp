@@ -0,0 +1,168 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "library/mpsc_queue.h"
+#include "library/event.h"
+
+using namespace sushi;
+using namespace sushi::internal;
+
+struct TestMessage : public MpscQueueHook
+{
+    TestMessage(int producer, int sequence) : producer(producer), sequence(sequence) {}
+
+    int producer;
+    int sequence;
+};
+
+class TestMpscQueue : public ::testing::Test
+{
+protected:
+    TestMpscQueue() = default;
+
+    MpscQueue<TestMessage> _module_under_test;
+};
+
+TEST_F(TestMpscQueue, TestOperation)
+{
+    EXPECT_TRUE(_module_under_test.empty());
+    EXPECT_EQ(nullptr, _module_under_test.pop());
+
+    for (int i = 0; i < 5; ++i)
+    {
+        _module_under_test.push(std::make_unique<TestMessage>(0, i));
+        EXPECT_FALSE(_module_under_test.empty());
+    }
+
+    for (int i = 0; i < 5; ++i)
+    {
+        auto message = _module_under_test.pop();
+        ASSERT_NE(nullptr, message);
+        EXPECT_EQ(i, message->sequence);
+    }
+    EXPECT_TRUE(_module_under_test.empty());
+    EXPECT_EQ(nullptr, _module_under_test.pop());
+
+    // Interleaved push and pop, the queue should work the same after it has been emptied
+    _module_under_test.push(std::make_unique<TestMessage>(0, 10));
+    _module_under_test.push(std::make_unique<TestMessage>(0, 11));
+    EXPECT_EQ(10, _module_under_test.pop()->sequence);
+    _module_under_test.push(std::make_unique<TestMessage>(0, 12));
+    EXPECT_EQ(11, _module_under_test.pop()->sequence);
+    EXPECT_EQ(12, _module_under_test.pop()->sequence);
+    EXPECT_TRUE(_module_under_test.empty());
+
+    // Elements left in the queue should be deleted with it
+    _module_under_test.push(std::make_unique<TestMessage>(0, 13));
+}
+
+TEST_F(TestMpscQueue, TestWaitForData)
+{
+    auto start = std::chrono::steady_clock::now();
+    _module_under_test.wake_up();
+    _module_under_test.wait_for_data(std::chrono::seconds(5));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+    std::thread producer([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        _module_under_test.push(std::make_unique<TestMessage>(0, 0));
+    });
+    while (_module_under_test.empty())
+    {
+        _module_under_test.wait_for_data(std::chrono::seconds(5));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_NE(nullptr, _module_under_test.pop());
+    producer.join();
+}
+
+TEST_F(TestMpscQueue, TestMultipleProducers)
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int MESSAGES = 20000;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&, p]()
+        {
+            for (int i = 0; i < MESSAGES; ++i)
+            {
+                _module_under_test.push(std::make_unique<TestMessage>(p, i));
+            }
+        });
+    }
+
+    // All messages should arrive, in order per producer
+    std::vector<int> next_sequence(PRODUCERS, 0);
+    int received = 0;
+    while (received < PRODUCERS * MESSAGES)
+    {
+        auto message = _module_under_test.pop();
+        if (message == nullptr)
+        {
+            _module_under_test.wait_for_data(std::chrono::milliseconds(1));
+            continue;
+        }
+        ASSERT_EQ(next_sequence[message->producer], message->sequence);
+        next_sequence[message->producer]++;
+        received++;
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    EXPECT_TRUE(_module_under_test.empty());
+}
+
+TEST(TestEventQueueThroughput, TestEventsFromMultipleProducers)
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int EVENTS = 50000;
+
+    MpscQueue<Event> queue;
+    std::atomic<int> producers_done = 0;
+    std::vector<std::thread> producers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&, p]()
+        {
+            for (int i = 0; i < EVENTS; ++i)
+            {
+                queue.push(std::make_unique<ParameterChangeEvent>(ParameterChangeEvent::Subtype::FLOAT_PARAMETER_CHANGE,
+                                                                  p, i, 0.5f, IMMEDIATE_PROCESS));
+            }
+            producers_done++;
+        });
+    }
+
+    int received = 0;
+    while (received < PRODUCERS * EVENTS)
+    {
+        if (auto event = queue.pop(); event != nullptr)
+        {
+            ASSERT_TRUE(event->is_parameter_change_event());
+            received++;
+        }
+        else
+        {
+            queue.wait_for_data(std::chrono::milliseconds(1));
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    EXPECT_EQ(PRODUCERS, producers_done);
+    EXPECT_TRUE(queue.empty());
+
+    // Stored in the test report so the event rate can be tracked between builds
+    RecordProperty("events_per_second", static_cast<int>(received / elapsed));
+}
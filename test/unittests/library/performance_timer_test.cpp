@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "gtest/gtest.h"
 
 #include "elk-warning-suppressor/warning_suppressor.hpp"
@@ -23,6 +25,16 @@ public:
         _friend._update_timings();
     }
 
+    int claimed_thread_logs()
+    {
+        return static_cast<int>(std::count(_friend._thread_logs->claimed.begin(), _friend._thread_logs->claimed.end(), true));
+    }
+
+    [[nodiscard]] auto thread_logs() const
+    {
+        return _friend._thread_logs;
+    }
+
 private:
     PerformanceTimer& _friend;
 };
@@ -131,3 +143,156 @@ TEST_F(TestPerformanceTimer, TestClearRecords)
     ASSERT_FLOAT_EQ(100.0f, t.min_case);
     ASSERT_FLOAT_EQ(0.0f, t.max_case);
 }
+
+TEST_F(TestPerformanceTimer, TestPercentilesAndOverruns)
+{
+    // 98 short records, and 2 longer than the timing period
+    for (int i = 0; i < 98; ++i)
+    {
+        auto start = _module_under_test.start_timer();
+        _module_under_test.stop_timer(virtual_wait(start, 1), 1);
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        auto start = _module_under_test.start_timer();
+        _module_under_test.stop_timer(virtual_wait(start, 20), 1);
+    }
+    _accessor.update_timings();
+
+    auto timings = _module_under_test.timings_for_node(1);
+    ASSERT_TRUE(timings.has_value());
+    auto t = timings.value();
+    EXPECT_EQ(2, t.overruns);
+
+    // Percentiles are accurate to within one histogram bucket
+    EXPECT_GE(t.p50_case, 0.1f);
+    EXPECT_LT(t.p50_case, 0.11f);
+    EXPECT_GE(t.p99_case, 2.0f);
+    EXPECT_LT(t.p99_case, 2.2f);
+    EXPECT_GE(t.p999_case, t.p99_case);
+
+    ASSERT_TRUE(_module_under_test.clear_timings_for_node(1));
+    t = _module_under_test.timings_for_node(1).value();
+    EXPECT_EQ(0, t.overruns);
+    EXPECT_FLOAT_EQ(0.0f, t.p99_case);
+}
+
+TEST(TestTimingHistogram, TestPercentiles)
+{
+    TimingHistogram histogram;
+    EXPECT_FLOAT_EQ(0.0f, histogram.percentile(0.5f));
+
+    for (int i = 1; i <= 1000; ++i)
+    {
+        histogram.add(static_cast<float>(i) / 1000.0f);
+    }
+    EXPECT_EQ(1000u, histogram.count());
+    EXPECT_NEAR(0.5f, histogram.percentile(0.5f), 0.05f);
+    EXPECT_NEAR(0.99f, histogram.percentile(0.99f), 0.09f);
+    EXPECT_GE(histogram.percentile(1.0f), 1.0f);
+
+    // Out of range values should end up in the first and last buckets
+    histogram.clear();
+    histogram.add(0.0f);
+    EXPECT_FLOAT_EQ(HISTOGRAM_MIN_VALUE * std::exp2(1.0f / HISTOGRAM_BUCKETS_PER_OCTAVE), histogram.percentile(0.5f));
+    histogram.add(1000000.0f);
+    EXPECT_GT(histogram.percentile(1.0f), 20.0f);
+
+    // As when timing with no timing period set
+    histogram.add(1.0f / 0.0f);
+    EXPECT_EQ(3u, histogram.count());
+    EXPECT_GT(histogram.percentile(1.0f), 20.0f);
+}
+
+TEST_F(TestPerformanceTimer, TestConcurrentRtSafeTimers)
+{
+    // Use more threads than there are thread logs, so that the shared queue is also used
+    constexpr int THREADS = MAX_TIMER_THREADS + 2;
+    constexpr int ITERATIONS = 100;
+
+    _accessor.enabled() = false;
+    _module_under_test.enable(true);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREADS; ++i)
+    {
+        threads.emplace_back([this, id = i + 1] ()
+        {
+            for (int j = 0; j < ITERATIONS; ++j)
+            {
+                auto start = _module_under_test.start_timer();
+                start = virtual_wait(start, 1);
+                _module_under_test.stop_timer_rt_safe(start, id);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    _module_under_test.enable(false);
+
+    for (int id = 1; id <= THREADS; ++id)
+    {
+        auto timings = _module_under_test.timings_for_node(id);
+        ASSERT_TRUE(timings.has_value());
+        EXPECT_GT(timings.value().min_case, 0.0f);
+        EXPECT_GE(timings.value().max_case, timings.value().min_case);
+    }
+}
+
+TEST_F(TestPerformanceTimer, TestShortLivedThreads)
+{
+    // Threads exiting should return their logs, so that new threads can use them
+    constexpr int THREADS = MAX_TIMER_THREADS * 3;
+
+    _accessor.enabled() = false;
+    _module_under_test.enable(true);
+
+    for (int i = 0; i < THREADS; ++i)
+    {
+        int claimed = 0;
+        std::thread thread([&, id = i + 1] ()
+        {
+            auto start = _module_under_test.start_timer();
+            start = virtual_wait(start, 1);
+            _module_under_test.stop_timer_rt_safe(start, id);
+            claimed = _accessor.claimed_thread_logs();
+        });
+        thread.join();
+        EXPECT_EQ(1, claimed);
+        EXPECT_EQ(0, _accessor.claimed_thread_logs());
+    }
+
+    // Logging to another timer returns the log claimed from the first one
+    PerformanceTimer other_timer;
+    other_timer.set_timing_period(TEST_PERIOD);
+    other_timer.enable(true);
+    auto start = _module_under_test.start_timer();
+    _module_under_test.stop_timer_rt_safe(start, 1);
+    EXPECT_EQ(1, _accessor.claimed_thread_logs());
+    other_timer.stop_timer_rt_safe(start, 1);
+    EXPECT_EQ(0, _accessor.claimed_thread_logs());
+    other_timer.enable(false);
+    _module_under_test.enable(false);
+}
+
+TEST_F(TestPerformanceTimer, TestThreadLogsFreedWithTimer)
+{
+    // A thread outliving the timer must not be left holding the log queues
+    auto timer = std::make_unique<PerformanceTimer>();
+    timer->set_timing_period(TEST_PERIOD);
+    timer->enable(true);
+    auto thread_logs = Accessor(*timer).thread_logs();
+
+    auto start = timer->start_timer();
+    timer->stop_timer_rt_safe(start, 1);
+    timer.reset();
+
+    for (const auto& log : thread_logs->logs)
+    {
+        EXPECT_EQ(nullptr, log);
+    }
+    // Returns the log claimed above
+    _module_under_test.stop_timer_rt_safe(start, 1);
+}
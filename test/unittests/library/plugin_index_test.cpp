@@ -0,0 +1,89 @@
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "library/plugin_index.cpp"
+
+using namespace sushi;
+using namespace sushi::internal;
+
+constexpr char INDEX_FILE[] = "./test_plugin_index.json";
+constexpr char PLUGIN_DIR[] = "./test_plugin_bundle";
+
+class TestPluginIndex : public ::testing::Test
+{
+protected:
+    TestPluginIndex() = default;
+
+    void SetUp() override
+    {
+        std::filesystem::remove(INDEX_FILE);
+        std::filesystem::create_directory(PLUGIN_DIR);
+        std::ofstream(std::string(PLUGIN_DIR) + "/manifest.ttl") << "manifest";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(INDEX_FILE);
+        std::filesystem::remove_all(PLUGIN_DIR);
+    }
+
+    PluginIndex _module_under_test{INDEX_FILE};
+};
+
+TEST_F(TestPluginIndex, TestLookup)
+{
+    EXPECT_FALSE(_module_under_test.load());
+    EXPECT_FALSE(_module_under_test.lookup(PluginType::LV2, "http://test.uri").has_value());
+
+    _module_under_test.update(PluginType::LV2, "http://test.uri", PLUGIN_DIR);
+    auto entry = _module_under_test.lookup(PluginType::LV2, "http://test.uri");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(PLUGIN_DIR, entry->path);
+    EXPECT_NE(0, entry->modified);
+
+    EXPECT_FALSE(_module_under_test.lookup(PluginType::VST3X, "http://test.uri").has_value());
+
+    // Updating with the same data should not add a new entry
+    _module_under_test.update(PluginType::LV2, "http://test.uri", PLUGIN_DIR);
+    EXPECT_EQ(1, _module_under_test.size());
+}
+
+TEST_F(TestPluginIndex, TestSaveAndLoad)
+{
+    _module_under_test.update(PluginType::LV2, "http://test.uri", PLUGIN_DIR);
+    _module_under_test.update(PluginType::VST3X, "vst3_plugin", "./not_a_plugin.vst3");
+    EXPECT_TRUE(_module_under_test.save());
+    EXPECT_TRUE(std::filesystem::exists(INDEX_FILE));
+
+    PluginIndex index(INDEX_FILE);
+    EXPECT_TRUE(index.load());
+    EXPECT_EQ(2, index.size());
+    auto entry = index.lookup(PluginType::LV2, "http://test.uri");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(PLUGIN_DIR, entry->path);
+
+    // Entries of missing files are never valid
+    EXPECT_FALSE(index.lookup(PluginType::VST3X, "vst3_plugin").has_value());
+}
+
+TEST_F(TestPluginIndex, TestModifiedBundle)
+{
+    _module_under_test.update(PluginType::LV2, "http://test.uri", PLUGIN_DIR);
+    ASSERT_TRUE(_module_under_test.lookup(PluginType::LV2, "http://test.uri").has_value());
+
+    auto file = std::string(PLUGIN_DIR) + "/manifest.ttl";
+    std::filesystem::last_write_time(file, std::filesystem::last_write_time(file) + std::chrono::seconds(10));
+    EXPECT_FALSE(_module_under_test.lookup(PluginType::LV2, "http://test.uri").has_value());
+
+    _module_under_test.update(PluginType::LV2, "http://test.uri", PLUGIN_DIR);
+    EXPECT_TRUE(_module_under_test.lookup(PluginType::LV2, "http://test.uri").has_value());
+}
+
+TEST_F(TestPluginIndex, TestInvalidFile)
+{
+    std::ofstream(INDEX_FILE) << "{\"version\": 1, \"plugins\": [";
+    EXPECT_FALSE(_module_under_test.load());
+    EXPECT_EQ(0, _module_under_test.size());
+}
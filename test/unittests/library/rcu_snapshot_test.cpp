@@ -0,0 +1,100 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "library/rcu_snapshot.h"
+
+using namespace sushi;
+using namespace sushi::internal;
+
+struct TestData
+{
+    explicit TestData(int value, std::atomic<int>* deleted) : a(value), b(value), deleted(deleted) {}
+
+    ~TestData()
+    {
+        // Make a use after free more likely to be detected
+        a = -1;
+        b = -2;
+        deleted->fetch_add(1);
+    }
+
+    int a;
+    int b;
+    std::atomic<int>* deleted;
+};
+
+TEST(TestRcuSnapshot, TestPublishAndRead)
+{
+    std::atomic<int> deleted{0};
+    {
+        RcuSnapshot<TestData> module_under_test;
+        {
+            RcuSnapshot<TestData>::ReadLock snapshot(module_under_test);
+            EXPECT_EQ(nullptr, snapshot.get());
+        }
+
+        module_under_test.publish(std::make_unique<TestData>(1, &deleted));
+        {
+            RcuSnapshot<TestData>::ReadLock snapshot(module_under_test);
+            ASSERT_NE(nullptr, snapshot.get());
+            EXPECT_EQ(1, snapshot->a);
+        }
+        EXPECT_EQ(0, deleted.load());
+
+        // The previous snapshot should be deleted when replaced
+        module_under_test.publish(std::make_unique<TestData>(2, &deleted));
+        EXPECT_EQ(1, deleted.load());
+        RcuSnapshot<TestData>::ReadLock snapshot(module_under_test);
+        EXPECT_EQ(2, snapshot->a);
+    }
+    // And the last one with the RcuSnapshot
+    EXPECT_EQ(2, deleted.load());
+}
+
+TEST(TestRcuSnapshot, TestConcurrentReaders)
+{
+    constexpr int READERS = 3;
+    constexpr int UPDATES = 2000;
+
+    std::atomic<int> deleted{0};
+    std::atomic<bool> running{true};
+    std::atomic<bool> consistent{true};
+    RcuSnapshot<TestData> module_under_test(std::make_unique<TestData>(0, &deleted));
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < READERS; ++i)
+    {
+        readers.emplace_back([&]()
+        {
+            int last_value = 0;
+            while (running.load())
+            {
+                RcuSnapshot<TestData>::ReadLock snapshot(module_under_test);
+                // Snapshots must never change or be deleted while being read
+                int a = snapshot->a;
+                std::this_thread::yield();
+                if (snapshot->a != a || snapshot->b != a || a < last_value)
+                {
+                    consistent = false;
+                }
+                last_value = a;
+            }
+        });
+    }
+
+    for (int i = 1; i <= UPDATES; ++i)
+    {
+        module_under_test.publish(std::make_unique<TestData>(i, &deleted));
+    }
+    running = false;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_TRUE(consistent.load());
+    EXPECT_EQ(UPDATES, deleted.load());
+}
@@ -0,0 +1,95 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "library/rt_event_fifo.h"
+
+using namespace sushi;
+using namespace sushi::internal;
+
+constexpr size_t TEST_FIFO_SIZE = 8;
+
+class TestTimedRtEventFifo : public ::testing::Test
+{
+protected:
+    TestTimedRtEventFifo() = default;
+
+    TimedRtEventFifo<TEST_FIFO_SIZE> _module_under_test;
+};
+
+TEST_F(TestTimedRtEventFifo, TestOperation)
+{
+    TimedRtEvent event;
+    EXPECT_FALSE(_module_under_test.pop(event));
+
+    for (int i = 0; i < static_cast<int>(TEST_FIFO_SIZE); ++i)
+    {
+        ASSERT_TRUE(_module_under_test.push(RtEvent::make_note_on_event(ObjectId(i), 0, 0, 60, 1.0f), Time(i)));
+    }
+    // The fifo is full
+    EXPECT_FALSE(_module_under_test.push(RtEvent::make_note_on_event(ObjectId(100), 0, 0, 60, 1.0f), Time(100)));
+
+    for (int i = 0; i < static_cast<int>(TEST_FIFO_SIZE); ++i)
+    {
+        ASSERT_TRUE(_module_under_test.pop(event));
+        EXPECT_EQ(ObjectId(i), event.event.processor_id());
+        EXPECT_EQ(RtEventType::NOTE_ON, event.event.type());
+        EXPECT_EQ(Time(i), event.timestamp);
+    }
+    EXPECT_FALSE(_module_under_test.pop(event));
+
+    // Wrap around
+    for (int i = 0; i < 3 * static_cast<int>(TEST_FIFO_SIZE); ++i)
+    {
+        ASSERT_TRUE(_module_under_test.push(RtEvent::make_note_off_event(ObjectId(i), 0, 0, 60, 1.0f), Time(i)));
+        ASSERT_TRUE(_module_under_test.pop(event));
+        EXPECT_EQ(ObjectId(i), event.event.processor_id());
+    }
+    EXPECT_FALSE(_module_under_test.pop(event));
+}
+
+TEST(TestTimedRtEventFifoConcurrency, TestMultipleProducers)
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int EVENTS_PER_PRODUCER = 20000;
+
+    TimedRtEventFifo<> fifo;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&fifo, p]()
+        {
+            for (int i = 0; i < EVENTS_PER_PRODUCER; ++i)
+            {
+                auto event = RtEvent::make_note_on_event(ObjectId(p), 0, 0, 60, 1.0f);
+                while (fifo.push(event, Time(i)) == false)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Events from every producer should arrive complete and in order
+    std::vector<int> next_expected(PRODUCERS, 0);
+    int received = 0;
+    TimedRtEvent event;
+    while (received < PRODUCERS * EVENTS_PER_PRODUCER)
+    {
+        if (fifo.pop(event))
+        {
+            auto producer = event.event.processor_id();
+            ASSERT_LT(producer, static_cast<ObjectId>(PRODUCERS));
+            ASSERT_EQ(Time(next_expected[producer]), event.timestamp);
+            next_expected[producer]++;
+            received++;
+        }
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    EXPECT_FALSE(fifo.pop(event));
+}
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <array>
+#include <vector>
 #include "gtest/gtest.h"
 
 #include "sushi/sample_buffer.h"
@@ -452,3 +453,128 @@ TEST (TestSampleBuffer, TestRMSCalculation)
     EXPECT_FLOAT_EQ(1, buffer.calc_rms_value(0));
     EXPECT_NEAR(1.0f / std::sqrt(2), buffer.calc_rms_value(1), 0.01);
 }
+
+TEST (TestSampleBuffer, TestAddWithRampMultichannel)
+{
+    // Every channel should be summed from its own source channel
+    SampleBuffer<AUDIO_CHUNK_SIZE> buffer(2);
+    SampleBuffer<AUDIO_CHUNK_SIZE> source(2);
+    std::fill(source.channel(0), source.channel(0) + AUDIO_CHUNK_SIZE, 1.0f);
+    std::fill(source.channel(1), source.channel(1) + AUDIO_CHUNK_SIZE, 2.0f);
+
+    buffer.add_with_ramp(source, 1.0f, 1.0f);
+    for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+    {
+        ASSERT_FLOAT_EQ(1.0f, buffer.channel(0)[i]);
+        ASSERT_FLOAT_EQ(2.0f, buffer.channel(1)[i]);
+    }
+}
+
+TEST (TestSampleBuffer, TestMultichannelInterleavingRoundtrip)
+{
+    constexpr int CHANNELS = 3;
+    std::array<float, 5 * CHANNELS> interleaved;
+    for (int i = 0; i < static_cast<int>(interleaved.size()); ++i)
+    {
+        interleaved[i] = static_cast<float>(i);
+    }
+    SampleBuffer<5> buffer(CHANNELS);
+    buffer.from_interleaved(interleaved.data());
+    for (int n = 0; n < 5; ++n)
+    {
+        for (int c = 0; c < CHANNELS; ++c)
+        {
+            ASSERT_FLOAT_EQ(static_cast<float>(n * CHANNELS + c), buffer.channel(c)[n]);
+        }
+    }
+    std::array<float, 5 * CHANNELS> output;
+    buffer.to_interleaved(output.data());
+    EXPECT_EQ(interleaved, output);
+}
+
+class TestSampleBufferKernels : public ::testing::TestWithParam<int>
+{
+protected:
+    void SetUp() override
+    {
+        int samples = GetParam();
+        _source.resize(samples);
+        _dest.resize(samples);
+        for (int i = 0; i < samples; ++i)
+        {
+            _source[i] = std::sin(0.3f * i) * 1.5f;
+            _dest[i] = std::cos(0.2f * i);
+        }
+    }
+
+    std::vector<float> _source;
+    std::vector<float> _dest;
+};
+
+// Sample counts chosen to cover empty input, only remainder, full vectors and full vectors plus remainder
+INSTANTIATE_TEST_SUITE_P(SampleCounts, TestSampleBufferKernels, ::testing::Values(0, 3, 8, 19, 64));
+
+TEST_P(TestSampleBufferKernels, TestGainAndAdd)
+{
+    auto expected = _dest;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        expected[i] = (expected[i] + _source[i] * 0.5f + _source[i]) * 2.0f;
+    }
+    kernels::add_with_gain(_dest.data(), _source.data(), 0.5f, GetParam());
+    kernels::add(_dest.data(), _source.data(), GetParam());
+    kernels::apply_gain(_dest.data(), 2.0f, GetParam());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_FLOAT_EQ(expected[i], _dest[i]);
+    }
+}
+
+TEST_P(TestSampleBufferKernels, TestRamps)
+{
+    auto expected = _dest;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        expected[i] += _source[i] * (0.25f + i * 0.01f);
+        expected[i] *= 1.0f - i * 0.02f;
+    }
+    kernels::add_with_ramp(_dest.data(), _source.data(), 0.25f, 0.01f, GetParam());
+    kernels::apply_ramp(_dest.data(), 1.0f, -0.02f, GetParam());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_NEAR(expected[i], _dest[i], 1.0e-6f);
+    }
+}
+
+TEST_P(TestSampleBufferKernels, TestAnalysis)
+{
+    int clipped = 0;
+    float peak = 0.0f;
+    float sum = 0.0f;
+    for (auto s : _source)
+    {
+        clipped += std::abs(s) >= 1.0f;
+        peak = std::max(peak, std::abs(s));
+        sum += s * s;
+    }
+    EXPECT_EQ(clipped, kernels::count_clipped_samples(_source.data(), GetParam()));
+    EXPECT_FLOAT_EQ(peak, kernels::peak_value(_source.data(), GetParam()));
+    EXPECT_NEAR(sum, kernels::sum_of_squares(_source.data(), GetParam()), 1.0e-4f);
+}
+
+TEST_P(TestSampleBufferKernels, TestStereoInterleaving)
+{
+    int samples = GetParam();
+    std::vector<float> interleaved(2 * samples);
+    kernels::interleave_stereo(interleaved.data(), _source.data(), _dest.data(), samples);
+    for (int i = 0; i < samples; ++i)
+    {
+        ASSERT_FLOAT_EQ(_source[i], interleaved[2 * i]);
+        ASSERT_FLOAT_EQ(_dest[i], interleaved[2 * i + 1]);
+    }
+    std::vector<float> left(samples);
+    std::vector<float> right(samples);
+    kernels::deinterleave_stereo(left.data(), right.data(), interleaved.data(), samples);
+    EXPECT_EQ(_source, left);
+    EXPECT_EQ(_dest, right);
+}
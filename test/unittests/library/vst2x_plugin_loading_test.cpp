@@ -1,3 +1,4 @@
+#include <chrono>
 #include <filesystem>
 
 #include "gtest/gtest.h"
@@ -58,3 +59,28 @@ TEST_F(TestVst2xPluginLoading, TestLoadPlugin)
 
     vst2::PluginLoader::close_library_handle(library_handle);
 }
+
+TEST_F(TestVst2xPluginLoading, TestSharedLibraryHandle)
+{
+    auto full_path = std::filesystem::path(VST2_TEST_PLUGIN_PATH);
+    auto full_again_path = std::string(std::filesystem::absolute(full_path).string());
+
+    auto start = std::chrono::steady_clock::now();
+    auto library_handle = vst2::PluginLoader::get_library_handle_for_plugin(full_again_path);
+    auto open_time = std::chrono::steady_clock::now() - start;
+    ASSERT_NE(nullptr, library_handle);
+    start = std::chrono::steady_clock::now();
+    auto second_handle = vst2::PluginLoader::get_library_handle_for_plugin(full_again_path);
+    auto shared_open_time = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(library_handle, second_handle);
+    EXPECT_EQ(1, vst2::PluginLoader::open_libraries());
+
+    RecordProperty("open_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(open_time).count()));
+    RecordProperty("shared_open_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(shared_open_time).count()));
+
+    // The library should stay open until the last handle is closed
+    vst2::PluginLoader::close_library_handle(library_handle);
+    EXPECT_EQ(1, vst2::PluginLoader::open_libraries());
+    vst2::PluginLoader::close_library_handle(second_handle);
+    EXPECT_EQ(0, vst2::PluginLoader::open_libraries());
+}
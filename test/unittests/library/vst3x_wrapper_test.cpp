@@ -1,3 +1,4 @@
+#include <chrono>
 #include <filesystem>
 
 #include "gtest/gtest.h"
@@ -198,6 +199,41 @@ TEST_F(TestVst3xWrapper, TestLoadAndInitPlugin)
     ASSERT_FALSE(descriptor);
 }
 
+TEST_F(TestVst3xWrapper, TestSharedModule)
+{
+    constexpr int INSTANCES = 16;
+    // The first instance loads the module, the time it takes is roughly what every instance cost before
+    auto start = std::chrono::steady_clock::now();
+    SetUp(SUSHI_VST3_TEST_PLUGIN_PATH, PLUGIN_NAME);
+    auto first_instance_time = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(1, ModuleCache::loaded_modules());
+
+    auto full_plugin_path = std::filesystem::absolute(std::filesystem::path(SUSHI_VST3_TEST_PLUGIN_PATH)).string();
+    std::vector<std::unique_ptr<Vst3xWrapper>> instances;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < INSTANCES; ++i)
+    {
+        instances.push_back(std::make_unique<Vst3xWrapper>(_host_control.make_host_control_mockup(TEST_SAMPLE_RATE),
+                                                           full_plugin_path,
+                                                           PLUGIN_NAME,
+                                                           &_host_app));
+        ASSERT_EQ(ProcessorReturnCode::OK, instances.back()->init(TEST_SAMPLE_RATE));
+    }
+    auto instances_time = std::chrono::steady_clock::now() - start;
+    // All instances should share the module loaded by the first one
+    EXPECT_EQ(1, ModuleCache::loaded_modules());
+
+    RecordProperty("first_instance_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(first_instance_time).count()));
+    RecordProperty("shared_instance_us", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(instances_time).count() / INSTANCES));
+
+    instances.clear();
+    EXPECT_EQ(1, ModuleCache::loaded_modules());
+
+    _accessor.reset();
+    _module_under_test.reset();
+    EXPECT_EQ(0, ModuleCache::loaded_modules());
+}
+
 TEST_F(TestVst3xWrapper, TestProcessing)
 {
     SetUp(SUSHI_VST3_TEST_PLUGIN_PATH, PLUGIN_NAME);
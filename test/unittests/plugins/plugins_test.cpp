@@ -124,6 +124,40 @@ TEST_F(TestGainPlugin, TestProcess)
     test_utils::assert_buffer_value(2.0f, out_buffer, test_utils::DECIBEL_ERROR);
 }
 
+TEST_F(TestGainPlugin, TestSampleAccurateAutomation)
+{
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(2);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(2);
+    test_utils::fill_sample_buffer(in_buffer, 1.0f);
+
+    // The gain changes to 2 in the middle of the chunk
+    constexpr int OFFSET = AUDIO_CHUNK_SIZE / 2;
+    auto gain_id = _accessor->gain_parameter()->descriptor()->id();
+    _module_under_test->process_event(RtEvent::make_parameter_change_event(_module_under_test->id(), OFFSET, gain_id, 0.875f));
+    _module_under_test->process_audio(in_buffer, out_buffer);
+
+    for (int c = 0; c < out_buffer.channel_count(); ++c)
+    {
+        for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+        {
+            ASSERT_NEAR(i < OFFSET ? 1.0f : 2.0f, out_buffer.channel(c)[i], test_utils::DECIBEL_ERROR);
+        }
+    }
+}
+
+TEST_F(TestGainPlugin, TestSampleAccurateAutomationChannelMismatch)
+{
+    // Inputs that are neither mono nor match the output are not mixed, as in SampleBuffer::add_with_gain()
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(2);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(3);
+    test_utils::fill_sample_buffer(in_buffer, 1.0f);
+
+    auto gain_id = _accessor->gain_parameter()->descriptor()->id();
+    _module_under_test->process_event(RtEvent::make_parameter_change_event(_module_under_test->id(), AUDIO_CHUNK_SIZE / 2, gain_id, 0.875f));
+    _module_under_test->process_audio(in_buffer, out_buffer);
+    test_utils::assert_buffer_value(0.0f, out_buffer);
+}
+
 class TestEqualizerPlugin : public ::testing::Test
 {
 protected:
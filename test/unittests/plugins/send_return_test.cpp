@@ -183,6 +183,35 @@ TEST_F(TestSendReturnPlugins, TestMultipleSends)
     test_utils::assert_buffer_value(2.0f, buffer_2);
 }
 
+TEST_F(TestSendReturnPlugins, TestSendersProcessedBefore)
+{
+    ChunkSampleBuffer buffer_1(2);
+    ChunkSampleBuffer buffer_2(2);
+    test_utils::fill_sample_buffer(buffer_1, 1.0f);
+
+    _host_control_mockup._transport.set_time(Time(0), 0);
+    _return_instance.set_senders_processed_before(true);
+    _send_accessor.set_destination(&_return_instance);
+    _send_instance.process_audio(buffer_1, buffer_2);
+    buffer_2.clear();
+
+    // The audio sent should be returned in the same chunk
+    _return_instance.process_audio(buffer_1, buffer_2);
+    test_utils::assert_buffer_value(1.0f, buffer_2);
+
+    // Audio sent after the return was processed should be returned in the next chunk
+    _send_instance.process_audio(buffer_1, buffer_2);
+    _host_control_mockup._transport.set_time(Time(10), AUDIO_CHUNK_SIZE);
+    _send_instance.process_audio(buffer_1, buffer_2);
+    _return_instance.process_audio(buffer_1, buffer_2);
+    test_utils::assert_buffer_value(2.0f, buffer_2);
+
+    // Nothing sent, the output should be silent
+    _host_control_mockup._transport.set_time(Time(20), 2 * AUDIO_CHUNK_SIZE);
+    _return_instance.process_audio(buffer_1, buffer_2);
+    test_utils::assert_buffer_value(0.0f, buffer_2);
+}
+
 TEST_F(TestSendReturnPlugins, TestSelectiveChannelSending)
 {
     auto channel_count_param_id = _send_instance.parameter_from_name("channel_count")->id();
@@ -16,6 +16,16 @@ public:
         return _friend._audio_graph;
     }
 
+    [[nodiscard]] std::vector<std::vector<float>>& render_times()
+    {
+        return _friend._render_times;
+    }
+
+    void rebalance()
+    {
+        _friend._rebalance();
+    }
+
 private:
     AudioGraph& _friend;
 };
@@ -14,13 +14,14 @@ public:
     HostControl make_host_control_mockup(float sample_rate = DEFAULT_TEST_SAMPLERATE)
     {
         _transport.set_sample_rate(sample_rate);
-        return HostControl(&_dummy_dispatcher, &_transport, &_plugin_library);
+        return HostControl(&_dummy_dispatcher, &_transport, &_plugin_library, nullptr, &_audio_routing_generation);
     }
 
     RtEventFifo<10>       _event_output;
     engine::Transport     _transport{DEFAULT_TEST_SAMPLERATE, &_event_output};
     engine::PluginLibrary _plugin_library;
     EventDispatcherMockup _dummy_dispatcher;
+    std::atomic<int>      _audio_routing_generation{0};
 };
 
 #endif //SUSHI_HOST_CONTROL_MOCKUP_H